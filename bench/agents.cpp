@@ -0,0 +1,89 @@
+/**
+ * @file agents.cpp
+ * @brief Planning throughput of cooperative multi-agent path-finding
+ * @author lhm
+ */
+
+// Standard headers
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Project headers
+#include "bench.hpp"
+#include <algo/cooperative.hpp>
+#include <env/graph.hpp>
+
+using namespace env;
+
+constexpr size_t AGENTS_MAP_SIDE{ 512 };
+constexpr double AGENTS_BUDGET_MS{ 10000. };
+constexpr size_t CBS_MAP_SIDE{ 32 };
+constexpr size_t CBS_AGENTS{ 20 };
+
+/*****************************************************************************/
+/*!
+ * \brief Plan \a count agents with distinct random starts and goals on \a
+ * graph, and print the throughput of the planner.
+ */
+static void
+_plan(const Graph<AStarCell>& graph, size_t count, bool refine, std::mt19937& rng) noexcept
+{
+    std::vector<AStarCell*> free;
+    for (size_t j{ 0 }; j < graph.getHeight(); ++j)
+        for (size_t i{ 0 }; i < graph.getWidth(); ++i)
+            if (auto cell{ graph.cell(i, j) }; !cell->hasState(ICell::WALL))
+                free.push_back(cell);
+    std::shuffle(std::begin(free), std::end(free), rng);
+
+    std::vector<astar::Cooperative<AStarCell>::Agent> agents;
+    for (size_t a{ 0 }; a < count; ++a)
+        agents.emplace_back(free[a], free[count + a]);
+
+    astar::Cooperative<AStarCell> planner(8, AGENTS_BUDGET_MS, refine);
+    bench::Timer                  timer;
+    planner.plan(&graph, agents);
+    const auto  ms{ timer.ms() };
+    const auto& stats{ planner.stats() };
+
+    std::cout << std::setw(5) << count << " agents" << (refine ? " (cbs)" : "      ") << std::fixed
+              << std::setprecision(1) << std::setw(10) << ms << " ms" << std::setprecision(0)
+              << std::setw(9) << count / ms * 1e3 << " agents/s" << std::setw(6) << stats.planned
+              << " planned" << std::setw(5) << stats.failed << " failed" << std::setw(10)
+              << stats.expanded << " expanded, makespan " << planner.makespan();
+    if (refine)
+        std::cout << ", " << stats.cbsNodes << " CBS nodes" << (stats.refined ? ", refined" : "");
+    std::cout << '\n';
+}
+
+/*****************************************************************************/
+/*!
+ * \brief Cooperative planning of 100 to 1000 agents on a 512x512 map with 20%
+ * of random walls, then a conflict-based search refinement of a few agents
+ * crowded on a small map. The size option is not used.
+ */
+static void
+agents(const bench::Options& opts) noexcept
+{
+    std::mt19937 rng(opts.seed);
+
+    auto walls = [&rng](Graph<AStarCell>& graph) {
+        for (size_t j{ 0 }; j < graph.getHeight(); ++j)
+            for (size_t i{ 0 }; i < graph.getWidth(); ++i)
+                if (rng() % 5 == 0)
+                    graph.setWall(graph.cell(i, j), true);
+    };
+
+    Graph<AStarCell> graph(AGENTS_MAP_SIDE, AGENTS_MAP_SIDE);
+    walls(graph);
+    for (auto count : { 100, 250, 500, 1000 })
+        _plan(graph, count, false, rng);
+
+    Graph<AStarCell> crowded(CBS_MAP_SIDE, CBS_MAP_SIDE);
+    walls(crowded);
+    _plan(crowded, CBS_AGENTS, true, rng);
+}
+
+static bench::Registrar _registrar{ "agents", agents };
@@ -0,0 +1,82 @@
+/**
+ * @file allocs.cpp
+ * @brief Heap allocations of the engines once warmed up
+ * @author lhm
+ */
+
+// Standard headers
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Project headers
+#include "bench.hpp"
+#include <env/graph.hpp>
+#include <utils/Memory.hpp>
+
+using namespace env;
+
+constexpr size_t ALLOCS_MAX_SIDE{ 512 };
+
+/*****************************************************************************/
+/*!
+ * \brief Run the same queries twice with the engines searching on the fly
+ * (neither the tables of "cpd" nor the slowness of "ida" fit such maps), on a
+ * map with 20% of random walls, and print the heap allocations of the
+ * searches of the second round : the first one leaves the buffers of the
+ * engines at their largest, so that searches should then not allocate at all.
+ */
+static void
+allocations(const bench::Options& opts) noexcept
+{
+#ifdef PATH_FINDER_NO_ALLOCS
+    std::cout << "Allocations are not counted (PATH_FINDER_ALLOCS is off)\n";
+    return;
+#endif
+
+    const auto       side{ std::min(opts.size, ALLOCS_MAX_SIDE) };
+    std::mt19937     rng(opts.seed);
+    Graph<AStarCell> graph(side, side);
+
+    std::vector<AStarCell*> free;
+    for (size_t j{ 0 }; j < side; ++j)
+        for (size_t i{ 0 }; i < side; ++i)
+            if (rng() % 100 < 20)
+                graph.setWall(graph.cell(i, j), true);
+            else
+                free.push_back(graph.cell(i, j));
+
+    std::uniform_int_distribution<size_t>         pick(0, std::size(free) - 1);
+    std::vector<std::pair<AStarCell*, AStarCell*>> queries;
+    while (std::size(queries) < opts.queries)
+        queries.emplace_back(free[pick(rng)], free[pick(rng)]);
+
+    for (const auto& name : { "astar", "theta", "fringe", "rsr", "subgoals", "anytime", "auto" }) {
+        auto engine{ bench::engine(name) };
+        if (nullptr == engine)
+            continue;
+
+        memory::Counters before;
+        for (uint round{ 0 }; round < 2; ++round) {
+            before = memory::counters(memory::SEARCH);
+            memory::resetPeaks();
+            for (const auto& [start, end] : queries) {
+                engine->run(&graph, start, end);
+                graph.clean();
+            }
+        }
+        const auto after{ memory::counters(memory::SEARCH) };
+
+        std::cout << std::left << std::setw(10) << name << std::right << std::fixed
+                  << std::setprecision(1) << std::setw(10)
+                  << double(after.count - before.count) / opts.queries << " allocs/query"
+                  << std::setw(12) << double(after.bytes - before.bytes) / opts.queries
+                  << " B/query" << std::setw(10) << (after.peak - before.live) / 1024.
+                  << " KiB peak\n";
+    }
+}
+
+static bench::Registrar _registrar{ "allocs", allocations };
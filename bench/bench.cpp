@@ -0,0 +1,113 @@
+/**
+ * @file bench.cpp
+ * @brief Implementation of \a bench.hpp
+ * @author lhm
+ */
+
+// Standard headers
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Project headers
+#include "bench.hpp"
+#include <algo/engines.hpp>
+
+// External headers
+#include <JSON.hpp>
+
+using namespace bench;
+
+/*****************************************************************************/
+std::map<std::string, Function>&
+bench::registry(void) noexcept
+{
+    static std::map<std::string, Function> benchmarks;
+    return benchmarks;
+}
+
+/*****************************************************************************/
+std::unique_ptr<astar::Impl<env::AStarCell>>
+bench::engine(const std::string& name) noexcept
+{
+    // Engines are configured from JSON files only : one file per process and
+    // per call, so that concurrent runs do not overwrite each other's
+    static std::atomic<uint> calls{ 0 };
+#ifdef __linux__
+    const auto process{ std::to_string(getpid()) };
+#else
+    const auto process{ std::to_string(std::random_device()()) };
+#endif
+    const auto file{ std::filesystem::temp_directory_path() /
+                     ("path_finder_bench_" + process + "_" + std::to_string(calls++) + ".json") };
+    std::ofstream(file) << R"({ "heuristic": "octogonal", "allow-diagonals": true })";
+
+    auto ret{ astar::create<env::AStarCell>(name) };
+    if (nullptr != ret && !ret->configure(JSON::Object::fromFile(file)))
+        ret.reset();
+    std::filesystem::remove(file);
+    return ret;
+}
+
+/*****************************************************************************/
+CacheMisses::CacheMisses() noexcept
+{
+#ifdef __linux__
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.type           = PERF_TYPE_HARDWARE;
+    attr.size           = sizeof(attr);
+    attr.config         = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled       = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+
+    _fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+}
+
+/*****************************************************************************/
+CacheMisses::~CacheMisses() noexcept
+{
+#ifdef __linux__
+    if (valid())
+        close(_fd);
+#endif
+}
+
+/*****************************************************************************/
+void
+CacheMisses::start(void) noexcept
+{
+#ifdef __linux__
+    if (valid()) {
+        ioctl(_fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(_fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+/*****************************************************************************/
+uint64_t
+CacheMisses::stop(void) noexcept
+{
+    uint64_t count{ 0 };
+#ifdef __linux__
+    if (valid()) {
+        ioctl(_fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (sizeof(count) != read(_fd, &count, sizeof(count)))
+            count = 0;
+    }
+#endif
+    return count;
+}
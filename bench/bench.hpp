@@ -0,0 +1,100 @@
+/**
+ * @file bench.hpp
+ * @brief Benchmark helpers : timing, hardware counters and registry
+ * @author lhm
+ */
+
+#ifndef BENCH_BENCH_HPP
+#define BENCH_BENCH_HPP
+
+// Standard headers
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+
+// Project headers
+#include <algo/astar.hpp>
+
+namespace bench {
+
+/*!
+ * \brief Options of a benchmark run.
+ */
+struct Options
+{
+    size_t size{ 8192 };  //!< Side of the generated maps
+    uint   queries{ 16 }; //!< Queries timed per case
+    uint   seed{ 42 };    //!< Seed of the generated maps
+};
+
+using Function = std::function<void(const Options&)>;
+
+/*****************************************************************************/
+/*!
+ * \brief Benchmarks by name. A benchmark registers itself from its translation
+ * unit with a static \a Registrar.
+ */
+std::map<std::string, Function>& registry(void) noexcept;
+
+struct Registrar
+{
+    Registrar(const std::string& name, Function fn) noexcept { registry()[name] = std::move(fn); }
+};
+
+/*****************************************************************************/
+/*!
+ * \brief Create and configure the engine \a name with 8 directions and the
+ * octagonal heuristic, nullptr if there is no such engine.
+ */
+std::unique_ptr<astar::Impl<env::AStarCell>> engine(const std::string& name) noexcept;
+
+/*****************************************************************************/
+/*!
+ * \brief Hardware cache misses of the calling thread, through perf events.
+ * \a valid is false when the counter is not available (not Linux, not allowed
+ * by perf_event_paranoid, virtual machine...) : \a read then returns 0.
+ */
+class CacheMisses
+{
+public:
+    CacheMisses() noexcept;
+    ~CacheMisses() noexcept;
+
+    CacheMisses(const CacheMisses&) = delete;
+    CacheMisses& operator=(const CacheMisses&) = delete;
+
+    bool valid(void) const noexcept { return _fd >= 0; }
+
+    void     start(void) noexcept;
+    uint64_t stop(void) noexcept;
+
+private:
+    int _fd{ -1 };
+};
+
+/*****************************************************************************/
+/*!
+ * \brief Wall-clock stopwatch.
+ */
+class Timer
+{
+public:
+    Timer() noexcept
+      : _start{ std::chrono::steady_clock::now() }
+    {}
+
+    double ms(void) const noexcept
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _start)
+          .count();
+    }
+
+private:
+    std::chrono::steady_clock::time_point _start;
+};
+}
+
+#endif // BENCH_BENCH_HPP
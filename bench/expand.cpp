@@ -0,0 +1,118 @@
+/**
+ * @file expand.cpp
+ * @brief Cost of an expansion with every kernel of the expander
+ * @author lhm
+ */
+
+// Standard headers
+#include <algorithm>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <tuple>
+#include <vector>
+
+// Project headers
+#include "bench.hpp"
+#include <algo/expand.hpp>
+#include <env/graph.hpp>
+
+using namespace env;
+using astar::Expander;
+
+constexpr size_t EXPAND_MAX_SIDE{ 4096 }; // 80 MB of search arrays
+
+/*****************************************************************************/
+/*!
+ * \brief A* between \a start and \a goal with the octagonal heuristic, the
+ * expander doing every neighbour test.
+ * \return the cells expanded
+ */
+static uint64_t
+_search(Expander<AStarCell>&    expander,
+        const Graph<AStarCell>& graph,
+        const AStarCell*        start,
+        const AStarCell*        goal) noexcept
+{
+    using Entry = std::tuple<uint, uint, uint32_t>; // f, h, cell
+    std::vector<Entry>         open;
+    Expander<AStarCell>::Batch batch;
+    uint64_t                   expanded{ 0 };
+
+    expander.begin(&graph, goal);
+    expander.seed(expander.index(start));
+    open.emplace_back(0, 0, expander.index(start));
+
+    const auto target{ expander.index(goal) };
+    while (!std::empty(open)) {
+        std::pop_heap(std::begin(open), std::end(open), std::greater<Entry>());
+        const auto [f, h, idx] = open.back();
+        open.pop_back();
+        if (expander.closed(idx) || f != expander.g(idx) + h)
+            continue;
+        if (target == idx)
+            break;
+
+        expander.expand(idx, batch);
+        ++expanded;
+        for (uint k{ 0 }; k < batch.count; ++k) {
+            open.emplace_back(batch.g[k] + batch.h[k], batch.h[k], batch.cells[k]);
+            std::push_heap(std::begin(open), std::end(open), std::greater<Entry>());
+        }
+    }
+    return expanded;
+}
+
+/*****************************************************************************/
+/*!
+ * \brief Time the same \a opts.queries searches on a map with 20% of random
+ * walls (at most 4096 cells wide) with each kernel the CPU supports, and
+ * report the time per expansion against the scalar kernel.
+ */
+static void
+expand(const bench::Options& opts) noexcept
+{
+    const auto       side{ std::min(opts.size, EXPAND_MAX_SIDE) };
+    Graph<AStarCell> graph(side, side);
+    std::mt19937     rng(opts.seed);
+
+    for (size_t j{ 0 }; j < side; ++j)
+        for (size_t i{ 0 }; i < side; ++i)
+            if (rng() % 5 == 0)
+                graph.setWall(graph.cell(i, j), true);
+
+    std::uniform_int_distribution<size_t>          coord(0, side - 1);
+    std::vector<std::pair<AStarCell*, AStarCell*>> queries;
+    while (std::size(queries) < opts.queries) {
+        auto start{ graph.cell(coord(rng), coord(rng)) };
+        auto goal{ graph.cell(coord(rng), coord(rng)) };
+        if (!start->hasState(ICell::WALL) && !goal->hasState(ICell::WALL))
+            queries.emplace_back(start, goal);
+    }
+
+    double scalarNs{ 0 };
+    for (auto isa :
+         { Expander<AStarCell>::SCALAR, Expander<AStarCell>::SSE4, Expander<AStarCell>::AVX2 }) {
+        if (isa > Expander<AStarCell>::best())
+            break;
+
+        Expander<AStarCell> expander(8, Expander<AStarCell>::OCTAGONAL, isa);
+        uint64_t            expanded{ 0 };
+        _search(expander, graph, queries[0].first, queries[0].second); // Warm up
+
+        bench::Timer timer;
+        for (const auto& [start, goal] : queries)
+            expanded += _search(expander, graph, start, goal);
+        const auto ns{ timer.ms() * 1e6 / std::max<uint64_t>(expanded, 1) };
+        if (Expander<AStarCell>::SCALAR == isa)
+            scalarNs = ns;
+
+        std::cout << std::left << std::setw(8) << Expander<AStarCell>::name(isa) << std::right
+                  << std::fixed << std::setprecision(1) << std::setw(8) << ns
+                  << " ns/expansion" << std::setprecision(2) << std::setw(8) << scalarNs / ns
+                  << "x, " << expanded / opts.queries << " expanded/query\n";
+    }
+}
+
+static bench::Registrar _registrar{ "expand", expand };
@@ -0,0 +1,77 @@
+/**
+ * @file layout.cpp
+ * @brief Compare the memory layouts of a graph on single-source searches
+ * @author lhm
+ */
+
+// Standard headers
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Project headers
+#include "bench.hpp"
+#include <algo/distance.hpp>
+#include <env/graph.hpp>
+
+using namespace env;
+
+/*****************************************************************************/
+/*!
+ * \brief Time \a opts.queries Dijkstra searches from random sources of a map
+ * with 25% of random walls, built the same for every layout.
+ */
+template<typename Layout>
+static void
+_run(const char* name, const bench::Options& opts) noexcept
+{
+    Graph<AStarCell, Layout>    graph(opts.size, opts.size);
+    std::mt19937                rng(opts.seed);
+    std::bernoulli_distribution wall(0.25);
+
+    for (size_t j{ 0 }; j < opts.size; ++j)
+        for (size_t i{ 0 }; i < opts.size; ++i)
+            if (wall(rng))
+                graph.setWall(graph.cell(i, j), true);
+
+    std::uniform_int_distribution<size_t> coord(0, opts.size - 1);
+    std::vector<uint>                     dist;
+    bench::CacheMisses                    misses;
+    uint64_t                              totalMisses{ 0 }, reached{ 0 };
+    double                                totalMs{ 0 };
+
+    for (uint q{ 0 }; q < opts.queries; ++q) {
+        AStarCell* source{ nullptr };
+        while (nullptr == source || source->hasState(ICell::WALL))
+            source = graph.cell(coord(rng), coord(rng));
+
+        misses.start();
+        bench::Timer timer;
+        astar::distances(graph, source, 8, dist);
+        totalMs += timer.ms();
+        totalMisses += misses.stop();
+
+        for (auto d : dist)
+            reached += (astar::UNREACHABLE != d);
+    }
+
+    std::cout << std::left << std::setw(12) << name << std::right << std::fixed
+              << std::setprecision(2) << std::setw(10) << totalMs / opts.queries << " ms/query";
+    if (misses.valid())
+        std::cout << std::setw(14) << totalMisses / opts.queries << " misses/query";
+    else
+        std::cout << std::setw(14) << "n/a" << " misses/query";
+    std::cout << "   (" << reached / opts.queries << " cells reached)\n";
+}
+
+/*****************************************************************************/
+static void
+layouts(const bench::Options& opts) noexcept
+{
+    _run<layout::RowMajor>("row-major", opts);
+    _run<layout::Tiled<>>("tiled-32", opts);
+    _run<layout::ZOrder>("z-order", opts);
+}
+
+static bench::Registrar _registrar{ "layout", layouts };
@@ -0,0 +1,98 @@
+/**
+ * @file main.cpp
+ * @brief Benchmarks entry point
+ * @author lhm
+ */
+
+// Standard headers
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <stdlib.h>
+#include <string>
+
+// Project headers
+#include "bench.hpp"
+#include <utils/CmdLineParser.hpp>
+#include <utils/Memory.hpp>
+
+/*****************************************************************************/
+static void
+help(void)
+{
+    std::cout << PROG_NAME << " : Path finder benchmarks\n\n"
+              << "Usage: " << PROG_NAME << " [-opt val]\n"
+              << "Options: \n\t-h : Display the help\n"
+              << "\n\t-b name : Run a single benchmark (default : all)"
+              << "\n\t-s size : Side of the generated maps (default : 8192)"
+              << "\n\t-q count : Queries timed per case (default : 16)\n"
+              << "\nBenchmarks :";
+    for (const auto& [name, fn] : bench::registry())
+        std::cout << ' ' << name;
+    std::cout << "\n\n";
+}
+
+/*****************************************************************************/
+/*!
+ * \brief Print the heap allocations of every subsystem since \a before, and
+ * their peak above the bytes then live.
+ */
+static void
+_allocations(const memory::Counters (&before)[memory::SUBSYSTEMS]) noexcept
+{
+    std::cout << "-- allocations :";
+    bool any{ false };
+    for (uint k{ 0 }; k < memory::SUBSYSTEMS; ++k) {
+        const auto after{ memory::counters(memory::Subsystem(k)) };
+        if (after.count == before[k].count)
+            continue;
+        std::cout << (any ? ", " : " ") << memory::name(memory::Subsystem(k)) << ' '
+                  << after.count - before[k].count << " (" << std::fixed << std::setprecision(1)
+                  << (after.bytes - before[k].bytes) / 1048576. << " MiB, "
+                  << (after.peak - std::min(after.peak, before[k].live)) / 1048576.
+                  << " MiB peak)";
+        any = true;
+    }
+    std::cout << (any ? "\n" : " none\n");
+}
+
+/*****************************************************************************/
+int
+main(int argc, char* argv[])
+{
+    CmdLineParser  parser(argc, argv);
+    bench::Options opts;
+
+    if (parser.cmdOptionExists("-h")) {
+        help();
+        return EXIT_SUCCESS;
+    }
+
+    if (parser.cmdOptionExists("-s"))
+        opts.size = std::stoul(std::string(parser.getCmdOption("-s")));
+    if (parser.cmdOptionExists("-q"))
+        opts.queries = std::stoul(std::string(parser.getCmdOption("-q")));
+
+    const auto only{ parser.cmdOptionExists("-b") ? std::string(parser.getCmdOption("-b"))
+                                                  : std::string() };
+    if (!only.empty() && !bench::registry().count(only)) {
+        std::cerr << "Unknown benchmark '" << only << "'\n";
+        return EXIT_FAILURE;
+    }
+
+    for (const auto& [name, fn] : bench::registry()) {
+        if (only.empty() || name == only) {
+            std::cout << "== " << name << " (" << opts.size << 'x' << opts.size << ")\n";
+
+            memory::Counters before[memory::SUBSYSTEMS];
+            for (uint k{ 0 }; k < memory::SUBSYSTEMS; ++k)
+                before[k] = memory::counters(memory::Subsystem(k));
+            memory::resetPeaks();
+
+            fn(opts);
+            _allocations(before);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,172 @@
+/**
+ * @file select.cpp
+ * @brief Calibration of the decision table of the automatic engine
+ * @author lhm
+ */
+
+// Standard headers
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// Project headers
+#include "bench.hpp"
+#include <algo/automatic.hpp>
+#include <algo/engines.hpp>
+#include <env/graph.hpp>
+
+using namespace env;
+
+constexpr size_t SELECT_MAX_SIDE{ 1024 };
+constexpr int    SELECT_SHORT_SPAN{ 32 };
+
+/*****************************************************************************/
+/*!
+ * \brief Maze of corridors one cell wide, carved depth-first.
+ */
+static void
+_maze(Graph<AStarCell>& graph, std::mt19937& rng) noexcept
+{
+    const int width(graph.getWidth()), height(graph.getHeight());
+    for (int j{ 0 }; j < height; ++j)
+        for (int i{ 0 }; i < width; ++i)
+            graph.setWall(graph.cell(i, j), true);
+
+    std::vector<std::pair<int, int>> stack{ { 0, 0 } };
+    graph.setWall(graph.cell(0, 0), false);
+    while (!std::empty(stack)) {
+        const auto [x, y] = stack.back();
+
+        std::vector<std::pair<int, int>> next;
+        for (auto [dx, dy] : { std::pair{ -2, 0 }, { 2, 0 }, { 0, -2 }, { 0, 2 } })
+            if (auto c{ graph.cell(x + dx, y + dy) }; c && c->hasState(ICell::WALL))
+                next.emplace_back(dx, dy);
+        if (std::empty(next)) {
+            stack.pop_back();
+            continue;
+        }
+
+        const auto [dx, dy] = next[rng() % std::size(next)];
+        graph.setWall(graph.cell(x + dx / 2, y + dy / 2), false);
+        graph.setWall(graph.cell(x + dx, y + dy), false);
+        stack.emplace_back(x + dx, y + dy);
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * \brief Empty rooms 64 cells wide, with a door in the middle of each wall.
+ */
+static void
+_rooms(Graph<AStarCell>& graph) noexcept
+{
+    for (size_t j{ 0 }; j < graph.getHeight(); ++j)
+        for (size_t i{ 0 }; i < graph.getWidth(); ++i)
+            if ((0 == i % 64 && 32 != j % 64) || (0 == j % 64 && 32 != i % 64))
+                graph.setWall(graph.cell(i, j), true);
+}
+
+/*****************************************************************************/
+/*!
+ * \brief Time short (at most 32 cells apart) and long (anywhere) queries with
+ * every engine returning shortest paths, on maps of a few shapes at most 1024
+ * cells wide, with the walls unchanged or edited before each query, and print
+ * the fastest engine next to the choice of the automatic engine.
+ */
+static void
+selection(const bench::Options& opts) noexcept
+{
+    const auto   side{ std::min(opts.size, SELECT_MAX_SIDE) };
+    std::mt19937 rng(opts.seed);
+
+    auto random = [&rng](uint percent) {
+        return [&rng, percent](Graph<AStarCell>& graph) {
+            for (size_t j{ 0 }; j < graph.getHeight(); ++j)
+                for (size_t i{ 0 }; i < graph.getWidth(); ++i)
+                    if (rng() % 100 < percent)
+                        graph.setWall(graph.cell(i, j), true);
+        };
+    };
+    const std::vector<std::pair<std::string, std::function<void(Graph<AStarCell>&)>>> maps{
+        { "open 2%", random(2) },
+        { "random 10%", random(10) },
+        { "random 20%", random(20) },
+        { "random 35%", random(35) },
+        { "rooms", _rooms },
+        { "maze", [&rng](Graph<AStarCell>& graph) { _maze(graph, rng); } }
+    };
+    const std::vector<std::string> engines{ "astar", "fringe", "rsr", "subgoals", "auto" };
+
+    for (const auto& [map, walls] : maps) {
+        Graph<AStarCell> graph(side, side);
+        walls(graph);
+
+        std::vector<AStarCell*> free;
+        for (size_t j{ 0 }; j < side; ++j)
+            for (size_t i{ 0 }; i < side; ++i)
+                if (auto cell{ graph.cell(i, j) }; !cell->hasState(ICell::WALL))
+                    free.push_back(cell);
+
+        std::uniform_int_distribution<size_t> pick(0, std::size(free) - 1);
+        std::uniform_int_distribution<int>    span(-SELECT_SHORT_SPAN, SELECT_SHORT_SPAN);
+        for (auto [near, edited] :
+             { std::pair{ true, false }, { false, false }, { true, true }, { false, true } }) {
+            // Start, end, and cell walled before the query if edited
+            std::vector<std::tuple<AStarCell*, AStarCell*, AStarCell*>> queries;
+            while (std::size(queries) < opts.queries) {
+                const auto start{ free[pick(rng)] };
+                const auto end{ near ? graph.neighbour(start, span(rng), span(rng))
+                                     : free[pick(rng)] };
+                const auto victim{ edited ? free[pick(rng)] : nullptr };
+                if (nullptr != end && !end->hasState(ICell::WALL) && victim != start &&
+                    victim != end)
+                    queries.emplace_back(start, end, victim);
+            }
+
+            std::cout << std::left << std::setw(12) << map << std::setw(6)
+                      << (near ? "short" : "long") << std::setw(8) << (edited ? "edited" : "")
+                      << std::right;
+            std::string best, chosen;
+            double      bestMs{ 0 };
+            for (const auto& name : engines) {
+                auto engine{ bench::engine(name) };
+                if (nullptr == engine)
+                    continue;
+                // Warm up, and build the data of every engine the automatic
+                // one may choose rather than timing it on its first query
+                auto automatic{ dynamic_cast<astar::Automatic<AStarCell>*>(engine.get()) };
+                if (nullptr != automatic)
+                    automatic->prepare(&graph);
+                engine->refresh(&graph);
+                engine->run(&graph, std::get<0>(queries[0]), std::get<1>(queries[0]));
+                graph.clean();
+
+                double ms{ 0 };
+                for (const auto& [start, end, victim] : queries) {
+                    graph.setWall(victim, true);
+
+                    bench::Timer timer;
+                    engine->refresh(&graph);
+                    engine->run(&graph, start, end);
+                    ms += timer.ms() / opts.queries;
+                    graph.clean();
+                    graph.setWall(victim, false);
+                }
+                std::cout << std::setw(10) << name << std::fixed << std::setprecision(3)
+                          << std::setw(9) << ms << " ms";
+
+                if (nullptr != automatic)
+                    chosen = automatic->delegate();
+                else if (std::empty(best) || ms < bestMs)
+                    best = name, bestMs = ms;
+            }
+            std::cout << "   fastest " << best << ", auto chose " << chosen << '\n';
+        }
+    }
+}
+
+static bench::Registrar _registrar{ "select", selection };
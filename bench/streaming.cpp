@@ -0,0 +1,118 @@
+/**
+ * @file streaming.cpp
+ * @brief Searches on a world paged in from disk
+ * @author lhm
+ */
+
+// Standard headers
+#include <algorithm>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <unistd.h>
+
+// Project headers
+#include "bench.hpp"
+#include <algo/streaming.hpp>
+#include <env/chunked.hpp>
+
+using namespace env;
+
+constexpr size_t   RESIDENT_CHUNKS{ 1024 }; // 8 MB of walls in memory
+constexpr uint32_t QUERY_SPAN{ 2048 };      // Largest distance between endpoints
+
+/*****************************************************************************/
+/*!
+ * \brief Write a \a opts.size square world with 20% of random walls, chunk
+ * after chunk, then time \a opts.queries searches between random free endpoints
+ * at most QUERY_SPAN cells apart, the world file being reopened cold.
+ */
+static void
+streaming(const bench::Options& opts) noexcept
+{
+    const auto   size{ static_cast<uint32_t>(opts.size) };
+    const auto   side{ ChunkedWorld::CHUNK_SIDE };
+    std::mt19937 rng(opts.seed);
+
+    // A file of our own : concurrent runs must not share it
+    char      name[]{ "/tmp/path_finder_bench.XXXXXX" };
+    const int fd{ mkstemp(name) };
+    if (fd < 0) {
+        std::perror("Cannot create the world file");
+        return;
+    }
+    close(fd);
+    const std::string file{ name };
+
+    {
+        ChunkedWorld world(RESIDENT_CHUNKS);
+        bench::Timer timer;
+        if (!world.create(file, size, size)) {
+            std::cout << world.what() << '\n';
+            std::remove(file.c_str());
+            return;
+        }
+        for (uint32_t cy{ 0 }; cy < size; cy += side)
+            for (uint32_t cx{ 0 }; cx < size; cx += side)
+                for (uint32_t y{ cy }; y < std::min(cy + side, size); ++y)
+                    for (uint32_t x{ cx }; x < std::min(cx + side, size); ++x)
+                        if (rng() % 5 == 0)
+                            world.setWall(x, y, true);
+        if (!world.flush()) {
+            std::cout << world.what() << '\n';
+            std::remove(file.c_str());
+            return;
+        }
+        std::cout << "world written in " << std::fixed << std::setprecision(0) << timer.ms()
+                  << " ms\n";
+    }
+
+    ChunkedWorld     world(RESIDENT_CHUNKS);
+    astar::Streaming search(8);
+    if (!world.open(file)) {
+        std::cout << world.what() << '\n';
+        std::remove(file.c_str());
+        return;
+    }
+
+    std::uniform_int_distribution<uint32_t> coord(0, size - 1);
+    std::uniform_int_distribution<int>      span(-static_cast<int>(QUERY_SPAN), QUERY_SPAN);
+    double                                  totalMs{ 0 };
+    uint64_t                                expanded{ 0 }, found{ 0 }, capped{ 0 };
+
+    auto near = [&](uint32_t v) {
+        const auto to{ std::clamp<int64_t>(int64_t(v) + span(rng), 0, int64_t(size) - 1) };
+        return static_cast<uint32_t>(to);
+    };
+
+    for (uint q{ 0 }; q < opts.queries; ++q) {
+        // Endpoints on walls have no path : draw again
+        uint32_t sx, sy, ex, ey;
+        do {
+            sx = coord(rng);
+            sy = coord(rng);
+        } while (!world.passable(sx, sy));
+        do {
+            ex = near(sx);
+            ey = near(sy);
+        } while (!world.passable(ex, ey));
+
+        bench::Timer timer;
+        found += search.run(world, { sx, sy }, { ex, ey });
+        totalMs += timer.ms();
+        expanded += search.stats().expanded;
+        capped += search.capped();
+    }
+
+    const auto& stats{ world.stats() };
+    std::cout << std::setprecision(2) << totalMs / opts.queries << " ms/query, "
+              << expanded / opts.queries << " expanded/query, " << found << '/' << opts.queries
+              << " found (" << capped << " gave up)\nchunks : " << stats.hits << " hits, "
+              << stats.misses << " misses, " << stats.evictions << " evictions, "
+              << stats.writebacks << " write-backs, " << stats.prefetches << " prefetches\n";
+
+    std::remove(file.c_str());
+}
+
+static bench::Registrar _registrar{ "streaming", streaming };
@@ -0,0 +1,352 @@
+/**
+ * @file anytime.cpp
+ * @brief Implementation of \a anytime.hpp
+ * @author lhm
+ */
+
+// Standard headers
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+// Project's headers
+#include "anytime.hpp"
+#include "moves.hpp"
+#include <utils/Memory.hpp>
+#include <utils/Trace.hpp>
+
+// External headers
+#include <JSON.hpp>
+
+using namespace env;
+
+namespace astar {
+
+constexpr uint     INFINITE{ std::numeric_limits<uint>::max() };
+constexpr uint32_t NO_PARENT{ 0xFFFFFFFF };
+constexpr uint     NO_HEURISTIC{ std::numeric_limits<uint>::max() };
+constexpr uint64_t BUDGET_CHECK{ 256 }; // Expansions between two looks at the clock
+
+constexpr uint8_t IN_OPEN{ 1 << 0 };
+constexpr uint8_t CLOSED{ 1 << 1 };
+constexpr uint8_t IN_INCONS{ 1 << 2 };
+
+/*****************************************************************************/
+/*!
+ * \brief Read the number \a key into \a value, given as an integer, a real or
+ * a string ("2.5"). \a value is left as is when \a key is absent.
+ * \return false if \a key is negative or not a number
+ */
+static bool
+_number(const JSON::Object& conf, const std::string& key, double& value) noexcept
+{
+    if (!conf[key])
+        return true;
+
+    double ret;
+    if (conf[key].isInt()) {
+        ret = conf[key].asInt();
+    } else if (conf[key].isDouble()) {
+        ret = conf[key].asDouble();
+    } else if (conf[key].isString()) {
+        const auto str{ conf[key].asString() };
+        char*      end{ nullptr };
+        ret = std::strtod(str.c_str(), &end);
+        if (std::empty(str) || '\0' != *end)
+            return false;
+    } else {
+        return false;
+    }
+
+    if (!std::isfinite(ret) || ret < 0)
+        return false;
+    value = ret;
+    return true;
+}
+
+/*****************************************************************************/
+template<typename T>
+bool
+Anytime<T>::configure(const JSON::Object& conf) noexcept
+{
+    if (!Impl<T>::configure(conf))
+        return false;
+
+    double weight{ 3. }, step{ .5 }, budgetMs{ 5. }, budgetExpansions{ 0. };
+    if (!_number(conf, "weight", weight) || weight < 1. || !_number(conf, "weight-step", step) ||
+        step <= 0. || !_number(conf, "time-budget-ms", budgetMs) ||
+        !_number(conf, "expansion-budget", budgetExpansions))
+        return false;
+
+    _weight = weight;
+    _step = step;
+    _budgetMs = budgetMs;
+    _budgetExpansions = static_cast<uint64_t>(budgetExpansions);
+
+    _graph = nullptr;
+    return true;
+}
+
+/*****************************************************************************/
+template<typename T>
+uint64_t
+Anytime<T>::signature(void) const noexcept
+{
+    return Impl<T>::signature() ^ std::hash<std::string>()("anytime:" + std::to_string(_weight));
+}
+
+/*****************************************************************************/
+template<typename T>
+bool
+Anytime<T>::run(Graph<T>* world, T* start, T* end) noexcept
+{
+    TRACE_SCOPE("Anytime::run");
+    MEMORY_SCOPE(memory::SEARCH);
+
+    this->_world = world;
+    this->_path.clear();
+    this->_stats.reset();
+    if (nullptr == world || nullptr == start || nullptr == end)
+        return false;
+
+    SEARCH_STAT(Lap timer);
+
+    this->_components.update(world);
+    if (!this->_components.connected(start, end)) {
+        SEARCH_STAT(this->_stats.setupMs = timer.lap());
+        return false;
+    }
+    if (this->_landmarks)
+        this->_landmarks->update(world);
+    SEARCH_STAT(this->_stats.setupMs = timer.lap());
+
+    // Resume the improvements of the previous run when it was the same query
+    if (world != _graph || world->version() != _version || start != _start || end != _end)
+        _begin(start, end);
+
+    _deadline = std::chrono::steady_clock::now() +
+                std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                  std::chrono::duration<double, std::milli>(_budgetMs));
+    _expansions = 0;
+
+    while (_improve()) {
+        // The path is now within epsilon of the optimal one, maybe closer
+        _solved = true;
+        const auto minScore{ _minScore() };
+        _bound = std::min(_epsilon, minScore > 0 ? _g[world->index(end)] / minScore : 1.);
+        if (_bound <= 1. || _spent()) {
+            _bound = std::max(_bound, 1.);
+            break;
+        }
+
+        // Lower the inflation : cells improved while closed are expanded again
+        _epsilon = std::max(1., std::min(_epsilon - _step, _bound));
+        for (auto idx : _incons) {
+            _flags[idx] &= ~IN_INCONS;
+            _push(idx);
+        }
+        _incons.clear();
+        for (auto& flags : _flags)
+            flags &= ~CLOSED;
+        _reorder();
+    }
+    SEARCH_STAT(this->_stats.searchMs = timer.lap());
+
+    const auto endIdx{ static_cast<uint32_t>(world->index(end)) };
+    if (INFINITE == _g[endIdx])
+        return false;
+
+    uint cost{ 0 };
+    for (auto idx{ endIdx }; NO_PARENT != idx; idx = _parent[idx]) {
+        auto cur{ _cell(idx) };
+        if (NO_PARENT != _parent[idx]) {
+            auto prev{ _cell(_parent[idx]) };
+            cost += (cur->x() != prev->x() && cur->y() != prev->y()) ? DIAGONAL_COST
+                                                                     : STRAIGHT_COST;
+        }
+        this->_path.push_back(cur);
+    }
+    std::reverse(std::begin(this->_path), std::end(this->_path));
+    end->_G = cost;
+
+    SEARCH_STAT(this->_stats.cost = cost);
+    SEARCH_STAT(this->_stats.pathLength = std::size(this->_path));
+    SEARCH_STAT(this->_stats.pathMs = timer.lap());
+
+    return true;
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+Anytime<T>::_begin(T* start, T* end) noexcept
+{
+    const auto size{ this->_world->getWidth() * this->_world->getHeight() };
+
+    _graph = this->_world;
+    _version = this->_world->version();
+    _start = start;
+    _end = end;
+    _epsilon = _weight;
+    _bound = _weight;
+    _solved = false;
+
+    _g.assign(size, INFINITE);
+    _hCache.assign(size, NO_HEURISTIC);
+    _parent.assign(size, NO_PARENT);
+    _flags.assign(size, 0);
+    _open.clear();
+    _incons.clear();
+
+    const auto idx{ static_cast<uint32_t>(this->_world->index(start)) };
+    _g[idx] = 0;
+    _push(idx);
+}
+
+/*****************************************************************************/
+/*!
+ * \brief One ARA* improvement : expand cells until the goal is not worse than
+ * the best open cell.
+ * \return false if the budget ran out first (never before the first path)
+ */
+template<typename T>
+bool
+Anytime<T>::_improve(void) noexcept
+{
+    const auto endIdx{ static_cast<uint32_t>(this->_world->index(_end)) };
+    auto       cmp = std::greater<Entry>();
+
+    while (!std::empty(_open)) {
+        SEARCH_STAT(this->_stats.open(std::size(_open)));
+        const auto [score, idx] = _open.front();
+
+        // Stale entry : the cell was reached again with a lower score
+        if (!(_flags[idx] & IN_OPEN) || score != _g[idx] + _epsilon * _h(idx)) {
+            std::pop_heap(std::begin(_open), std::end(_open), cmp);
+            _open.pop_back();
+            continue;
+        }
+        if (_g[endIdx] <= score)
+            return true;
+
+        if (_solved && 0 == ++_expansions % BUDGET_CHECK && _spent())
+            return false;
+
+        std::pop_heap(std::begin(_open), std::end(_open), cmp);
+        _open.pop_back();
+        _flags[idx] = (_flags[idx] & ~IN_OPEN) | CLOSED;
+        SEARCH_STAT(++this->_stats.expanded);
+
+        auto cur{ _cell(idx) };
+        for (uint i{ 0 }; i < this->_dirs; ++i) {
+            auto neigh{ this->_world->neighbour(cur, MOVES[i].first, MOVES[i].second) };
+            if (!this->_eligible(neigh))
+                continue;
+
+            const auto nidx{ static_cast<uint32_t>(this->_world->index(neigh)) };
+            const auto cost{ _g[idx] + moveCost(i) };
+            if (cost >= _g[nidx])
+                continue;
+
+            _g[nidx] = cost;
+            _parent[nidx] = idx;
+            if (!(_flags[nidx] & CLOSED)) {
+                _push(nidx);
+                SEARCH_STAT(++this->_stats.generated);
+            } else if (!(_flags[nidx] & IN_INCONS)) {
+                _flags[nidx] |= IN_INCONS;
+                _incons.push_back(nidx);
+                SEARCH_STAT(++this->_stats.reopened);
+            }
+        }
+    }
+
+    return true;
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+Anytime<T>::_push(uint32_t idx) noexcept
+{
+    _flags[idx] |= IN_OPEN;
+    _open.emplace_back(_g[idx] + _epsilon * _h(idx), idx);
+    std::push_heap(std::begin(_open), std::end(_open), std::greater<Entry>());
+}
+
+/*****************************************************************************/
+/*!
+ * \brief Recompute the scores of the open cells with the new epsilon.
+ */
+template<typename T>
+void
+Anytime<T>::_reorder(void) noexcept
+{
+    // Compacted in place, the buffer of the heap is kept
+    size_t kept{ 0 };
+    for (size_t k{ 0 }; k < std::size(_open); ++k) {
+        const auto idx{ _open[k].second };
+        if ((_flags[idx] & IN_OPEN) && !(_flags[idx] & CLOSED)) {
+            _open[kept++] = { _g[idx] + _epsilon * _h(idx), idx };
+            _flags[idx] |= CLOSED; // Marks the cell as kept, cleared below
+        }
+    }
+    _open.resize(kept);
+    for (const auto& [score, idx] : _open)
+        _flags[idx] &= ~CLOSED;
+
+    std::make_heap(std::begin(_open), std::end(_open), std::greater<Entry>());
+}
+
+/*****************************************************************************/
+/*!
+ * \brief Lowest g + h (not inflated) of the open and inconsistent cells : a
+ * lower bound of the optimal cost.
+ */
+template<typename T>
+double
+Anytime<T>::_minScore(void) noexcept
+{
+    double ret{ std::numeric_limits<double>::max() };
+    for (const auto& [score, idx] : _open)
+        if (_flags[idx] & IN_OPEN)
+            ret = std::min(ret, static_cast<double>(_g[idx]) + _h(idx));
+    for (auto idx : _incons)
+        ret = std::min(ret, static_cast<double>(_g[idx]) + _h(idx));
+
+    // Nothing left to expand : the path is optimal
+    return std::numeric_limits<double>::max() == ret ? _g[this->_world->index(_end)] : ret;
+}
+
+/*****************************************************************************/
+template<typename T>
+T*
+Anytime<T>::_cell(uint32_t idx) const noexcept
+{
+    return this->_world->cell(idx % this->_world->getWidth(), idx / this->_world->getWidth());
+}
+
+/*****************************************************************************/
+template<typename T>
+uint
+Anytime<T>::_h(uint32_t idx) noexcept
+{
+    if (NO_HEURISTIC == _hCache[idx]) {
+        _hCache[idx] = this->_heuristic(_cell(idx), _end);
+        SEARCH_STAT(++this->_stats.heuristicCalls);
+    }
+    return _hCache[idx];
+}
+
+/*****************************************************************************/
+template<typename T>
+bool
+Anytime<T>::_spent(void) const noexcept
+{
+    return (0 != _budgetExpansions && _expansions >= _budgetExpansions) ||
+           std::chrono::steady_clock::now() >= _deadline;
+}
+
+template class Anytime<AStarCell>;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file anytime.hpp
+ * @brief Anytime Repairing A* (ARA*)
+ * @author lhm
+ */
+
+#ifndef SRC_ALGO_ANYTIME_HPP
+#define SRC_ALGO_ANYTIME_HPP
+
+// Standard headers
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// Project's headers
+#include <algo/astar.hpp>
+
+namespace astar {
+
+/*****************************************************************************/
+/*!
+ * \brief The Anytime engine (ARA*) first finds a path with a heuristic
+ * inflated by 'weight', whose cost is at most 'weight' times the optimal one,
+ * then lowers the inflation and repairs the path until the time or expansions
+ * budget runs out, or the path is optimal.
+ *
+ * The first path is always searched to the end, whatever the budget. Running
+ * again the same query on an unchanged graph resumes the improvements where
+ * they stopped.
+ */
+template<typename T>
+class Anytime : public Impl<T>
+{
+public:
+    Anytime() noexcept = default;
+    virtual ~Anytime() noexcept = default;
+
+    [[maybe_unused]] virtual bool configure(const JSON::Object&) noexcept override;
+    [[maybe_unused]] virtual bool run(env::Graph<T>*, T* start, T* end) noexcept override;
+
+    virtual uint64_t signature(void) const noexcept override;
+    virtual double   bound(void) const noexcept override { return _bound; }
+
+protected:
+    using Entry = std::pair<double, uint32_t>; // f, cell index
+
+    void   _begin(T* start, T* end) noexcept;
+    bool   _improve(void) noexcept;
+    void   _push(uint32_t idx) noexcept;
+    void   _reorder(void) noexcept;
+    double _minScore(void) noexcept;
+    T*     _cell(uint32_t idx) const noexcept;
+    uint   _h(uint32_t idx) noexcept;
+    bool   _spent(void) const noexcept;
+
+private:
+    double   _weight{ 3. };
+    double   _step{ .5 };
+    double   _budgetMs{ 5. };
+    uint64_t _budgetExpansions{ 0 }; // 0 : no limit
+
+    // Search state, kept between runs of the same query
+    const env::Graph<T>*  _graph{ nullptr };
+    uint64_t              _version{ 0 };
+    T*                    _start{ nullptr };
+    T*                    _end{ nullptr };
+    double                _epsilon{ 1. };
+    double                _bound{ 1. };
+    bool                  _solved{ false };
+    std::vector<uint>     _g;
+    std::vector<uint>     _hCache;
+    std::vector<uint32_t> _parent;
+    std::vector<uint8_t>  _flags;
+    std::vector<Entry>    _open; // Binary heap, with stale entries
+    std::vector<uint32_t> _incons;
+
+    // Budget of the current run
+    std::chrono::steady_clock::time_point _deadline;
+    uint64_t                              _expansions{ 0 };
+};
+}
+
+#endif // SRC_ALGO_ANYTIME_HPP
@@ -7,10 +7,15 @@
 // Standard headers
 #include <algorithm>
 #include <math.h>
+#include <tuple>
 
 // Project's headers
 #include "astar.hpp"
+#include "goals.hpp"
+#include "moves.hpp"
 #include <utils/Json.hpp>
+#include <utils/Memory.hpp>
+#include <utils/Trace.hpp>
 
 // External headers
 #include <JSON.hpp>
@@ -19,12 +24,7 @@ using namespace env;
 
 namespace astar {
 
-using CellsList = std::list<ICell*>;
-using CellsSet = std::set<ICell*>;
-
-template<typename T>
-const std::vector<std::pair<int, int>> Impl<T>::DIRS{ { 0, 1 },   { 1, 0 }, { 0, -1 }, { -1, 0 },
-                                                      { -1, -1 }, { 1, 1 }, { -1, 1 }, { 1, -1 } };
+constexpr uint DEFAULT_LANDMARKS{ 8 };
 
 /*****************************************************************************/
 template<typename T>
@@ -42,26 +42,56 @@ Impl<T>::configure(const JSON::Object& conf) noexcept
         goto error;
 
     {
+        _dirs = (conf["allow-diagonals"].asBoolean()) ? 8 : 4;
+        _components = Components<T>(_dirs);
+        _landmarks.reset();
+
         std::string heuristic_name{ conf["heuristic"].asString() };
-        if (!heuristic_name.compare("euclidean")) {
+        auto        estimate{ Expander<T>::NONE };
+        if (!heuristic_name.compare("landmarks")) {
+            uint        count{ DEFAULT_LANDMARKS };
+            std::string file;
+            if (conf["landmarks"] && conf["landmarks"].isInt() && conf["landmarks"].asInt() > 0)
+                count = conf["landmarks"].asInt();
+            if (conf["landmarks-file"] && conf["landmarks-file"].isString())
+                file = conf["landmarks-file"].asString();
+
+            _landmarks = std::make_shared<Landmarks<T>>(count, _dirs, file);
+            _heuristic = [lm = _landmarks](T* s, T* d) { return lm->estimate(s, d); };
+            heuristic_name += ':' + std::to_string(count);
+        } else if (!heuristic_name.compare("euclidean")) {
             _heuristic =
               std::bind(&Heuristic::euclidean, std::placeholders::_1, std::placeholders::_2);
         } else if (!heuristic_name.compare("manhattan")) {
             _heuristic =
               std::bind(&Heuristic::manhattan, std::placeholders::_1, std::placeholders::_2);
+            estimate = Expander<T>::MANHATTAN;
         } else if (!heuristic_name.compare("octogonal")) {
             _heuristic =
               std::bind(&Heuristic::octagonal, std::placeholders::_1, std::placeholders::_2);
+            estimate = Expander<T>::OCTAGONAL;
         } else {
             goto error;
         }
 
-        _dirs = (conf["allow-diagonals"].asBoolean()) ? 8 : 4;
+        // The kernel may be forced to a less efficient one, for comparisons
+        auto isa{ Expander<T>::best() };
+        if (conf["simd"] && conf["simd"].isString()) {
+            const auto name{ conf["simd"].asString() };
+            for (auto candidate : { Expander<T>::SCALAR, Expander<T>::SSE4, Expander<T>::AVX2 })
+                if (name == Expander<T>::name(candidate))
+                    isa = std::min(isa, candidate);
+        }
+        _expander = Expander<T>(_dirs, estimate, isa);
+
+        _signature = std::hash<std::string>()(heuristic_name + ':' + std::to_string(_dirs));
     }
     return true;
 
 error:
     _dirs = 4;
+    _landmarks.reset();
+    _signature = 0;
     if (_heuristic)
         _heuristic = {};
     return false;
@@ -72,54 +102,249 @@ template<typename T>
 bool
 Impl<T>::run(Graph<T>* world, T* start, T* end) noexcept
 {
+    TRACE_SCOPE("astar::run");
+    MEMORY_SCOPE(memory::SEARCH);
     _world = world;
+    _path.clear();
+    _stats.reset();
     if (nullptr == _world || nullptr == start || nullptr == end)
         return false;
 
-    AStarCell* cur{ nullptr };
-    CellsList  open;
-    CellsSet   closed;
+    SEARCH_STAT(Lap timer);
 
-    open.push_back(start);
+    // The graph may not have been cleaned since the previous search, whose
+    // cells are forgotten even if this one is rejected
+    _expander.begin(_world, end);
 
-    while (!std::empty(open)) {
-        auto it{ std::max_element(std::begin(open), std::end(open), [](auto* a, auto* b) {
-            return static_cast<AStarCell*>(a)->getScore() >= static_cast<AStarCell*>(b)->getScore();
-        }) };
-        cur = static_cast<AStarCell*>(*it);
+    // Reject at once the searches between disconnected areas, instead of
+    // exploring the whole area of the start
+    _components.update(_world);
+    if (!_components.connected(start, end)) {
+        SEARCH_STAT(_stats.setupMs = timer.lap());
+        return false;
+    }
 
-        if (end == cur)
-            break;
+    if (_landmarks)
+        _landmarks->update(_world);
+    SEARCH_STAT(_stats.setupMs = timer.lap());
 
-        closed.insert(cur);
-        open.erase(it);
+    // f, h (ties go closest to the goal first), cell of the expander
+    using Entry = std::tuple<uint, uint, uint32_t>;
+    _scratch.reset();
+    memory::ArenaVector<Entry> open{ _scratch };
+    const auto                 push = [&open](uint f, uint h, uint32_t cell) {
+        open.emplace_back(f, h, cell);
+        std::push_heap(std::begin(open), std::end(open), std::greater<Entry>());
+    };
 
-        for (uint i{ 0 }; i < _dirs; ++i) {
-            auto neigh{ _world->cell(cur->x() + DIRS[i].first, cur->y() + DIRS[i].second) };
-            if (!_eligible(neigh) || closed.count(neigh))
-                continue;
+    _expander.seed(_expander.index(start));
+    start->_G = 0;
+    start->_H = _heuristic(start, end);
+    start->_parent = nullptr;
+    push(start->_H, start->_H, _expander.index(start));
+    SEARCH_STAT(++_stats.generated);
+    SEARCH_STAT(++_stats.heuristicCalls);
+
+    T*                          cur{ nullptr };
+    typename Expander<T>::Batch batch;
+    while (!std::empty(open)) {
+        SEARCH_STAT(_stats.open(std::size(open)));
+        std::pop_heap(std::begin(open), std::end(open), std::greater<Entry>());
+        const auto [f, h, idx] = open.back();
+        open.pop_back();
+
+        // Stale entry of a cell reached again at a lower cost
+        if (_expander.closed(idx) || f != _expander.g(idx) + h)
+            continue;
 
-            uint totalCost{ cur->_G + ((i < 4) ? 10 : 14) };
+        auto cell{ _expander.cell(idx) };
+        if (end == cell) {
+            cur = cell;
+            break;
+        }
 
-            if (std::end(open) == std::find(std::begin(open), std::end(open), neigh)) {
-                neigh->_parent = cur;
-                neigh->_G = totalCost;
+        // Only the improved neighbours come out of the kernel, with their
+        // estimate unless the heuristic is not a geometric one
+        _expander.expand(idx, batch);
+        SEARCH_STAT(++_stats.expanded);
+        for (uint k{ 0 }; k < batch.count; ++k) {
+            auto neigh{ _expander.cell(batch.cells[k]) };
+            neigh->_G = batch.g[k];
+            neigh->_H = batch.h[k];
+            neigh->_parent = cell;
+            if (Expander<T>::NONE == _expander.estimate()) {
                 neigh->_H = _heuristic(neigh, end);
-                open.push_back(neigh);
-            } else if (totalCost < neigh->_G) {
-                neigh->_parent = cur;
-                neigh->_G = totalCost;
+                SEARCH_STAT(++_stats.heuristicCalls);
             }
+            push(neigh->_G + neigh->_H, neigh->_H, batch.cells[k]);
+            SEARCH_STAT(++_stats.generated);
         }
     }
+    SEARCH_STAT(_stats.searchMs = timer.lap());
 
     if (cur != end)
         return false;
 
-    while (nullptr != cur) {
-        cur->addState(ICell::PATH);
-        cur = cur->_parent;
+    SEARCH_STAT(_stats.cost = cur->_G);
+    for (AStarCell* c{ cur }; nullptr != c; c = c->_parent)
+        _path.push_back(static_cast<T*>(c));
+    std::reverse(std::begin(_path), std::end(_path));
+    SEARCH_STAT(_stats.pathLength = std::size(_path));
+    SEARCH_STAT(_stats.pathMs = timer.lap());
+
+    return true;
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+Impl<T>::emit(PathBuffer& out) const noexcept
+{
+    if (nullptr == _world)
+        out.clear();
+    else
+        out.assign(*_world, this->path());
+}
+
+/*****************************************************************************/
+template<typename T>
+std::vector<T*>
+Impl<T>::reached(void) const noexcept
+{
+    std::vector<T*> ret;
+    if (nullptr == _world || !_expander.begun())
+        return ret;
+
+    std::vector<bool> seen(_world->getWidth() * _world->getHeight(), false);
+    for (auto idx : _expander.touched()) {
+        auto cell{ _expander.cell(idx) };
+        if (nullptr == cell || seen[_world->index(cell)])
+            continue;
+        seen[_world->index(cell)] = true;
+        ret.push_back(cell);
+    }
+    return ret;
+}
+
+/*****************************************************************************/
+template<typename T>
+bool
+Impl<T>::runMany(Graph<T>*              world,
+                 const std::vector<T*>& starts,
+                 const std::vector<T*>& ends) noexcept
+{
+    TRACE_SCOPE("astar::runMany");
+    MEMORY_SCOPE(memory::SEARCH);
+    _world = world;
+    _path.clear();
+    _stats.reset();
+    if (nullptr == _world)
+        return false;
+
+    SEARCH_STAT(Lap timer);
+
+    // Ends no start can reach would only make the heuristic weaker
+    _components.update(_world);
+    std::vector<T*> goals;
+    for (auto end : ends) {
+        if (!_eligible(end))
+            continue;
+        if (std::any_of(std::begin(starts), std::end(starts), [this, end](T* start) {
+                return _eligible(start) && _components.connected(start, end);
+            }))
+            goals.push_back(end);
+    }
+    if (std::empty(goals)) {
+        SEARCH_STAT(_stats.setupMs = timer.lap());
+        return false;
+    }
+
+    if (_landmarks)
+        _landmarks->update(_world);
+    GoalIndex<T> index;
+    index.assign(goals);
+    const bool geometric{ nullptr == _landmarks };
+    SEARCH_STAT(_stats.setupMs = timer.lap());
+
+    constexpr uint8_t OPEN{ 1 << 0 };
+    constexpr uint8_t CLOSED{ 1 << 1 };
+    constexpr uint8_t GOAL{ 1 << 2 };
+
+    using Entry = std::pair<uint, T*>; // f, cell
+    _scratch.reset();
+    memory::ArenaVector<Entry>   open{ _scratch };
+    memory::ArenaVector<uint8_t> flags(_world->getWidth() * _world->getHeight(), 0, _scratch);
+    const auto                   push = [&open](uint score, T* cell) {
+        open.emplace_back(score, cell);
+        std::push_heap(std::begin(open), std::end(open), std::greater<Entry>());
+    };
+
+    for (auto goal : goals)
+        flags[_world->index(goal)] |= GOAL;
+    for (auto start : starts) {
+        if (!_eligible(start) || (flags[_world->index(start)] & OPEN))
+            continue;
+        start->_G = 0;
+        start->_H = index.estimate(start, _heuristic, geometric);
+        start->_parent = nullptr;
+        flags[_world->index(start)] |= OPEN;
+        push(start->_H, start);
+        SEARCH_STAT(++_stats.generated);
+        SEARCH_STAT(++_stats.heuristicCalls);
+    }
+
+    T* cur{ nullptr };
+    while (!std::empty(open)) {
+        SEARCH_STAT(_stats.open(std::size(open)));
+        std::pop_heap(std::begin(open), std::end(open), std::greater<Entry>());
+        const auto [score, cell] = open.back();
+        open.pop_back();
+
+        // Stale entry of a cell reached again at a lower cost
+        auto& cellFlags{ flags[_world->index(cell)] };
+        if ((cellFlags & CLOSED) || score != cell->_G + cell->_H)
+            continue;
+        if (cellFlags & GOAL) {
+            cur = cell;
+            break;
+        }
+
+        cellFlags |= CLOSED;
+        SEARCH_STAT(++_stats.expanded);
+
+        for (uint i{ 0 }; i < _dirs; ++i) {
+            auto neigh{ _world->neighbour(cell, MOVES[i].first, MOVES[i].second) };
+            if (!_eligible(neigh))
+                continue;
+
+            auto&      neighFlags{ flags[_world->index(neigh)] };
+            const auto cost{ cell->_G + moveCost(i) };
+            if (neighFlags & CLOSED)
+                continue;
+            if (!(neighFlags & OPEN)) {
+                neigh->_H = index.estimate(neigh, _heuristic, geometric);
+                neighFlags |= OPEN;
+                SEARCH_STAT(++_stats.heuristicCalls);
+            } else if (cost >= neigh->_G) {
+                continue;
+            }
+            neigh->_G = cost;
+            neigh->_parent = cell;
+            push(cost + neigh->_H, neigh);
+            SEARCH_STAT(++_stats.generated);
+        }
     }
+    SEARCH_STAT(_stats.searchMs = timer.lap());
+
+    if (nullptr == cur)
+        return false;
+
+    SEARCH_STAT(_stats.cost = cur->_G);
+    for (AStarCell* c{ cur }; nullptr != c; c = c->_parent)
+        _path.push_back(static_cast<T*>(c));
+    std::reverse(std::begin(_path), std::end(_path));
+    SEARCH_STAT(_stats.pathLength = std::size(_path));
+    SEARCH_STAT(_stats.pathMs = timer.lap());
 
     return true;
 }
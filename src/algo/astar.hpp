@@ -10,10 +10,18 @@
 // Standard headers
 #include <functional>
 #include <list>
+#include <memory>
 #include <set>
+#include <string>
 
 // Project's headers
+#include <algo/expand.hpp>
+#include <algo/landmarks.hpp>
+#include <algo/pathbuffer.hpp>
+#include <algo/stats.hpp>
+#include <env/components.hpp>
 #include <env/graph.hpp>
+#include <utils/Memory.hpp>
 
 namespace JSON {
 class Object;
@@ -31,6 +39,62 @@ class AbstractImpl
 public:
     [[maybe_unused]] virtual bool configure(const JSON::Object&) noexcept = 0;
     [[maybe_unused]] virtual bool run(env::Graph<T>*, T* start, T* end) noexcept = 0;
+
+    /*!
+     * \brief Single search from any of \a starts to the closest of \a ends : the
+     * path links the pair of cells with the lowest cost. The cost is put in
+     * the \a _G of the end reached, i.e. the last cell of \a path.
+     */
+    [[maybe_unused]] virtual bool runMany(env::Graph<T>*,
+                                          const std::vector<T*>& starts,
+                                          const std::vector<T*>& ends) noexcept = 0;
+
+    /*!
+     * \brief Identify the configuration of the engine : engines sharing the same
+     * signature find the same paths.
+     */
+    virtual uint64_t signature(void) const noexcept = 0;
+
+    /*!
+     * \brief Cells of the path found by the latest successful run, from start
+     * to end. Consecutive cells are neighbours, unless \a anyAngle.
+     */
+    virtual const std::vector<T*>& path(void) const noexcept = 0;
+
+    /*!
+     * \brief Write the latest path to \a out, in the encoding of \a out. The
+     * cells of the graph are left untouched.
+     */
+    virtual void emit(PathBuffer& out) const noexcept = 0;
+
+    /*!
+     * \brief Statistics of the latest run, successful or not.
+     */
+    virtual const SearchStats& stats(void) const noexcept = 0;
+
+    /*!
+     * \brief Whether the paths are made of straight segments of any direction
+     * rather than of moves between neighbour cells.
+     */
+    virtual bool anyAngle(void) const noexcept { return false; }
+
+    /*!
+     * \brief Factor by which the cost of the latest path may exceed the
+     * optimal one. 1 for engines that only return optimal paths.
+     */
+    virtual double bound(void) const noexcept { return 1.; }
+
+    /*!
+     * \brief Bring the data derived from the walls of the graph up to date
+     * after they were edited, instead of on the next run.
+     */
+    virtual void refresh(const env::Graph<T>*) noexcept {}
+
+    /*!
+     * \brief Name of the engine which ran the latest search, for engines
+     * handing the searches over to others. Empty otherwise.
+     */
+    virtual std::string delegate(void) const noexcept { return {}; }
 };
 
 /*****************************************************************************/
@@ -44,16 +108,44 @@ public:
     [[maybe_unused]] virtual bool configure(const JSON::Object&) noexcept override;
     [[maybe_unused]] virtual bool run(env::Graph<T>*, T* start, T* end) noexcept override;
 
+    /*!
+     * \brief A* with every start in the initial open list, stopping at the first
+     * end expanded. The heuristic is the lowest one over the ends, evaluated
+     * through a \a GoalIndex. Engines run this A* whatever their algorithm.
+     */
+    [[maybe_unused]] virtual bool runMany(env::Graph<T>*,
+                                          const std::vector<T*>& starts,
+                                          const std::vector<T*>& ends) noexcept override;
+
+    virtual uint64_t               signature(void) const noexcept override { return _signature; }
+    virtual const std::vector<T*>& path(void) const noexcept override { return _path; }
+    virtual const SearchStats&     stats(void) const noexcept override { return _stats; }
+    virtual void                   emit(PathBuffer&) const noexcept override;
+
+    env::Components<T>& components(void) noexcept { return _components; }
+
+    /*!
+     * \brief Cells reached by the latest \a run of this A*, each one once, in
+     * the order they were first reached. Empty for the engines which search
+     * otherwise.
+     */
+    std::vector<T*> reached(void) const noexcept;
+
 protected:
     virtual bool _eligible(T*) noexcept;
 
-private:
-    env::Graph<T>* _world{ nullptr };
-
-    HeuristicFunction<T> _heuristic;
-    uint                 _dirs;
-
-    static const std::vector<std::pair<int, int>> DIRS;
+protected:
+    env::Graph<T>*  _world{ nullptr };
+    std::vector<T*> _path;
+    SearchStats     _stats;
+
+    HeuristicFunction<T>          _heuristic;
+    uint                          _dirs;
+    std::shared_ptr<Landmarks<T>> _landmarks;
+    uint64_t                      _signature{ 0 };
+    env::Components<T>            _components;
+    Expander<T>                   _expander;
+    memory::Arena                 _scratch; // Lists of the latest run, reset by the next one
 };
 
 /*****************************************************************************/
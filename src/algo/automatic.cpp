@@ -0,0 +1,166 @@
+/**
+ * @file automatic.cpp
+ * @brief Implementation of \a automatic.hpp
+ * @author lhm
+ */
+
+// Standard headers
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+
+// Project's headers
+#include "automatic.hpp"
+#include "engines.hpp"
+#include <utils/Memory.hpp>
+#include <utils/Trace.hpp>
+
+using namespace env;
+
+namespace astar {
+
+/*!
+ * \brief Row of the decision table : the first row matching the query wins,
+ * the last one always does.
+ */
+struct Rule
+{
+    const char* engine;
+    double      minCorridors; // Share of free cells in corridors
+    uint        minDistance;  // Chebyshev distance between the cells
+    bool        unchanged;    // Only while the walls are those of the previous query
+};
+
+// From the 'select' benchmark : the subgoal graph answers long queries the
+// fastest, and any query through corridors, but repairing it after an edit
+// costs more than an A* search unless the map is made of corridors. A* follows
+// the edits as fast as Fringe search, and the share of walls never decides
+static const Rule RULES[]{
+    { "subgoals", 0.60, 0, false },
+    { "subgoals", 0.00, 64, true },
+    { "astar", 0.00, 0, false },
+};
+
+/*****************************************************************************/
+template<typename T>
+bool
+Automatic<T>::configure(const JSON::Object& conf) noexcept
+{
+    if (!Impl<T>::configure(conf))
+        return false;
+
+    _profile = Profile<T>();
+    _version = 0;
+    _engines.clear();
+    _chosen.clear();
+    for (const auto& rule : RULES) {
+        if (_engines.count(rule.engine))
+            continue;
+
+        auto engine{ create<T>(rule.engine) };
+        if (nullptr == engine || !engine->configure(conf))
+            return false;
+        _engines.emplace(rule.engine, std::move(engine));
+    }
+    return true;
+}
+
+/*****************************************************************************/
+template<typename T>
+uint64_t
+Automatic<T>::signature(void) const noexcept
+{
+    return Impl<T>::signature() ^ std::hash<std::string>()("auto:");
+}
+
+/*****************************************************************************/
+template<typename T>
+const std::vector<T*>&
+Automatic<T>::path(void) const noexcept
+{
+    if (auto it{ _engines.find(_chosen) }; std::end(_engines) != it)
+        return it->second->path();
+    return this->_path;
+}
+
+/*****************************************************************************/
+template<typename T>
+const SearchStats&
+Automatic<T>::stats(void) const noexcept
+{
+    if (auto it{ _engines.find(_chosen) }; std::end(_engines) != it)
+        return it->second->stats();
+    return this->_stats;
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+Automatic<T>::refresh(const Graph<T>* graph) noexcept
+{
+    // The engines bring their own data up to date when they are chosen
+    _profile.update(graph);
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+Automatic<T>::prepare(const Graph<T>* graph) noexcept
+{
+    _profile.update(graph);
+    for (auto& [name, engine] : _engines) {
+        engine->components().update(graph);
+        engine->refresh(graph);
+    }
+}
+
+/*****************************************************************************/
+template<typename T>
+const char*
+Automatic<T>::choose(const T* start, const T* end, bool edited) const noexcept
+{
+    const auto dx{ static_cast<uint>(std::abs(int(start->x()) - int(end->x()))) };
+    const auto dy{ static_cast<uint>(std::abs(int(start->y()) - int(end->y()))) };
+    const auto distance{ std::max(dx, dy) };
+
+    for (const auto& rule : RULES)
+        if (_profile.corridors() >= rule.minCorridors && distance >= rule.minDistance &&
+            (!edited || !rule.unchanged))
+            return rule.engine;
+    return "astar";
+}
+
+/*****************************************************************************/
+template<typename T>
+bool
+Automatic<T>::run(Graph<T>* world, T* start, T* end) noexcept
+{
+    TRACE_SCOPE("Automatic::run");
+    MEMORY_SCOPE(memory::SEARCH);
+
+    this->_world = world;
+    this->_path.clear();
+    this->_stats.reset();
+    _chosen.clear();
+    if (nullptr == world || nullptr == start || nullptr == end)
+        return false;
+
+    _profile.update(world);
+    _chosen = choose(start, end, _version != world->version());
+    _version = world->version();
+    return _engines[_chosen]->run(world, start, end);
+}
+
+/*****************************************************************************/
+template<typename T>
+bool
+Automatic<T>::runMany(Graph<T>*              world,
+                      const std::vector<T*>& starts,
+                      const std::vector<T*>& ends) noexcept
+{
+    _chosen.clear();
+    return Impl<T>::runMany(world, starts, ends);
+}
+
+template class Automatic<AStarCell>;
+}
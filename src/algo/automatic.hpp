@@ -0,0 +1,82 @@
+/**
+ * @file automatic.hpp
+ * @brief Choice of the engine of each query from the shape of the graph
+ * @author lhm
+ */
+
+#ifndef SRC_ALGO_AUTOMATIC_HPP
+#define SRC_ALGO_AUTOMATIC_HPP
+
+// Standard headers
+#include <map>
+#include <memory>
+#include <string>
+
+// Project's headers
+#include <algo/astar.hpp>
+#include <env/profile.hpp>
+
+namespace astar {
+
+/*****************************************************************************/
+/*!
+ * \brief The Automatic engine hands each query over to the engine expected to
+ * answer it the fastest, among engines returning shortest paths.
+ *
+ * The graph is profiled when its walls change (share of free cells in
+ * corridors, see \a env::Profile), and each query goes to the first engine of
+ * a decision table whose conditions hold for the profile, the distance between
+ * the cells and whether the walls changed since the previous query. The table
+ * was calibrated with the 'select' benchmark, which also showed that the other
+ * measures of a map do not decide :
+ * - the share of walls : the same layout ranks the engines the same way at any
+ *   density, only corridors change the ranking,
+ * - the connected areas : every engine rejects a query between two areas from
+ *   its own \a env::Components before any other work.
+ *
+ * The candidate engines are created through \a factories and configured like
+ * this one, and \a delegate names the engine of the latest search.
+ */
+template<typename T>
+class Automatic : public Impl<T>
+{
+public:
+    Automatic() noexcept = default;
+    virtual ~Automatic() noexcept = default;
+
+    [[maybe_unused]] virtual bool configure(const JSON::Object&) noexcept override;
+    [[maybe_unused]] virtual bool run(env::Graph<T>*, T* start, T* end) noexcept override;
+    [[maybe_unused]] virtual bool runMany(env::Graph<T>*,
+                                          const std::vector<T*>& starts,
+                                          const std::vector<T*>& ends) noexcept override;
+
+    virtual uint64_t               signature(void) const noexcept override;
+    virtual const std::vector<T*>& path(void) const noexcept override;
+    virtual const SearchStats&     stats(void) const noexcept override;
+    virtual void                   refresh(const env::Graph<T>*) noexcept override;
+    virtual std::string            delegate(void) const noexcept override { return _chosen; }
+
+    /*!
+     * \brief Name of the engine chosen for a query between \a start and \a
+     * end, the profile being up to date with the graph.
+     */
+    const char* choose(const T* start, const T* end, bool edited) const noexcept;
+
+    /*!
+     * \brief Bring the data of every candidate engine (areas, derived data) up
+     * to date with \a graph, so that the first queries given to each do not
+     * pay for it.
+     */
+    void prepare(const env::Graph<T>* graph) noexcept;
+
+    const env::Profile<T>& profile(void) const noexcept { return _profile; }
+
+private:
+    env::Profile<T>                                 _profile;
+    uint64_t                                        _version{ 0 }; // Walls of the previous query
+    std::map<std::string, std::unique_ptr<Impl<T>>> _engines;
+    std::string                                     _chosen;
+};
+}
+
+#endif // SRC_ALGO_AUTOMATIC_HPP
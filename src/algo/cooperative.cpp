@@ -0,0 +1,564 @@
+/**
+ * @file cooperative.cpp
+ * @brief Implementation of \a cooperative.hpp
+ * @author lhm
+ */
+
+// Standard headers
+#include <algorithm>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <queue>
+#include <tuple>
+
+// Project's headers
+#include "cooperative.hpp"
+#include "moves.hpp"
+#include "stats.hpp"
+#include <utils/Memory.hpp>
+#include <utils/Trace.hpp>
+
+using namespace env;
+
+namespace astar {
+
+constexpr uint64_t EMPTY{ ~0ull };
+constexpr uint     INITIAL_BITS{ 12 };
+constexpr uint32_t NO_PARENT{ 0xFFFFFFFF };
+constexpr size_t   CBS_MAX_NODES{ 1 << 16 };
+constexpr uint     COOPERATIVE_WEIGHT{ 2 };
+
+/*****************************************************************************/
+Reservations::Reservations() noexcept
+{
+    clear();
+}
+
+/*****************************************************************************/
+void
+Reservations::clear(void) noexcept
+{
+    _bits = INITIAL_BITS;
+    _keys.assign(size_t(1) << _bits, EMPTY);
+    _agents.assign(size_t(1) << _bits, NONE);
+    _count = 0;
+    _parked.clear();
+    _freeFrom.clear();
+}
+
+/*****************************************************************************/
+void
+Reservations::reserve(uint64_t cell, uint32_t t, uint32_t agent) noexcept
+{
+    // Keep the table at most half full, so that probes stay short
+    if (2 * (_count + 1) > std::size(_keys))
+        _grow();
+
+    const auto key{ (cell << TIME_BITS) | t };
+    const auto slot{ _slot(key) };
+    if (EMPTY == _keys[slot]) {
+        _keys[slot] = key;
+        ++_count;
+    }
+    _agents[slot] = agent;
+
+    auto& free{ _freeFrom[cell] };
+    free = std::max(free, t + 1);
+}
+
+/*****************************************************************************/
+void
+Reservations::park(uint64_t cell, uint32_t from, uint32_t agent) noexcept
+{
+    _parked[cell] = { from, agent };
+}
+
+/*****************************************************************************/
+void
+Reservations::unpark(uint64_t cell) noexcept
+{
+    _parked.erase(cell);
+}
+
+/*****************************************************************************/
+uint32_t
+Reservations::owner(uint64_t cell, uint32_t t) const noexcept
+{
+    if (auto it{ _parked.find(cell) }; std::end(_parked) != it && it->second.first <= t)
+        return it->second.second;
+
+    const auto slot{ _slot((cell << TIME_BITS) | t) };
+    return EMPTY == _keys[slot] ? NONE : _agents[slot];
+}
+
+/*****************************************************************************/
+uint32_t
+Reservations::freeFrom(uint64_t cell) const noexcept
+{
+    const auto it{ _freeFrom.find(cell) };
+    return std::end(_freeFrom) == it ? 0 : it->second;
+}
+
+/*****************************************************************************/
+size_t
+Reservations::_slot(uint64_t key) const noexcept
+{
+    const auto mask{ (size_t(1) << _bits) - 1 };
+    auto       slot{ static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> (64 - _bits)) };
+    while (EMPTY != _keys[slot] && key != _keys[slot])
+        slot = (slot + 1) & mask;
+    return slot;
+}
+
+/*****************************************************************************/
+void
+Reservations::_grow(void) noexcept
+{
+    std::vector<uint64_t> keys;
+    std::vector<uint32_t> agents;
+    keys.swap(_keys);
+    agents.swap(_agents);
+
+    ++_bits;
+    _keys.assign(size_t(1) << _bits, EMPTY);
+    _agents.assign(size_t(1) << _bits, NONE);
+    for (size_t i{ 0 }; i < std::size(keys); ++i) {
+        if (EMPTY == keys[i])
+            continue;
+        const auto slot{ _slot(keys[i]) };
+        _keys[slot] = keys[i];
+        _agents[slot] = agents[i];
+    }
+}
+
+/*****************************************************************************/
+template<typename T>
+Cooperative<T>::Cooperative(uint dirs, double budgetMs, bool refine) noexcept
+  : _dirs{ 4 == dirs ? 4u : 8u }
+  , _budgetMs{ budgetMs }
+  , _refineEnabled{ refine }
+  , _components{ _dirs }
+{}
+
+/*****************************************************************************/
+template<typename T>
+bool
+Cooperative<T>::plan(const Graph<T>* graph, const std::vector<Agent>& agents) noexcept
+{
+    TRACE_SCOPE("Cooperative::plan");
+    MEMORY_SCOPE(memory::SEARCH);
+
+    _graph = graph;
+    _agents = agents;
+    _stats = Stats();
+    _cells.assign(std::size(agents), {});
+    _paths.assign(std::size(agents), {});
+    if (nullptr == graph)
+        return false;
+    _components.update(graph);
+
+    Lap timer;
+    _deadline = std::chrono::steady_clock::now() +
+                std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                  std::chrono::duration<double, std::milli>(_budgetMs));
+
+    // Long enough to go around the world, and to let every other agent by
+    const uint64_t width{ graph->getWidth() }, height{ graph->getHeight() };
+    _horizon = static_cast<uint32_t>(std::min<uint64_t>(
+      (1 << Reservations::TIME_BITS) - 2, 2 * (width + height) + std::size(agents)));
+    _expansionLimit = 64 * (width + height);
+
+    _cooperative();
+    _stats.planMs = timer.lap();
+
+    if (_refineEnabled && !_spent()) {
+        _stats.refined = _refine();
+        _stats.refineMs = timer.lap();
+    }
+
+    for (size_t a{ 0 }; a < std::size(_cells); ++a) {
+        _stats.cost += _cost(_cells[a]);
+        for (auto idx : _cells[a])
+            _paths[a].push_back(graph->cell(idx % width, idx / width));
+    }
+
+    return 0 == _stats.failed;
+}
+
+/*****************************************************************************/
+template<typename T>
+T*
+Cooperative<T>::position(size_t agent, size_t t) const noexcept
+{
+    if (agent >= std::size(_paths) || std::empty(_paths[agent]))
+        return nullptr;
+    return _paths[agent][std::min(t, std::size(_paths[agent]) - 1)];
+}
+
+/*****************************************************************************/
+template<typename T>
+size_t
+Cooperative<T>::makespan(void) const noexcept
+{
+    size_t ret{ 0 };
+    for (const auto& path : _paths)
+        ret = std::max(ret, std::size(path));
+    return ret > 0 ? ret - 1 : 0;
+}
+
+/*****************************************************************************/
+/*!
+ * \brief Prioritized planning : each agent avoids the reservations of the
+ * agents planned before it, and the starts of those planned after it.
+ */
+template<typename T>
+void
+Cooperative<T>::_cooperative(void) noexcept
+{
+    _reservations.clear();
+
+    const auto index = [this](const T* c) { return static_cast<uint64_t>(_graph->index(c)); };
+    const auto valid = [](const T* c) { return nullptr != c && !c->hasState(ICell::WALL); };
+
+    std::vector<uint32_t> order;
+    for (uint32_t a{ 0 }; a < std::size(_agents); ++a) {
+        if (valid(_agents[a].first))
+            _reservations.park(index(_agents[a].first), 0, a);
+        order.push_back(a);
+    }
+
+    // The longest trips are the hardest to fit in the others' reservations
+    const auto distance = [this, &index](uint32_t a) {
+        const auto& [start, goal] = _agents[a];
+        return (nullptr == start || nullptr == goal) ? 0 : _heuristic(index(start), index(goal));
+    };
+    std::stable_sort(std::begin(order), std::end(order), [&distance](uint32_t a, uint32_t b) {
+        return distance(a) > distance(b);
+    });
+
+    for (auto a : order) {
+        const auto& [start, goal] = _agents[a];
+        if (!valid(start) || !valid(goal) || _spent()) {
+            if (valid(start))
+                _cells[a] = { index(start) };
+            ++_stats.failed;
+            continue;
+        }
+
+        _reservations.unpark(index(start));
+        const auto blocked = [this, a](uint64_t from, uint64_t to, uint32_t t) {
+            const auto owner{ _reservations.owner(to, t) };
+            if (Reservations::NONE != owner && a != owner)
+                return true;
+
+            // Another agent coming the other way
+            const auto other{ _reservations.owner(from, t) };
+            return Reservations::NONE != other && a != other &&
+                   other == _reservations.owner(to, t - 1);
+        };
+
+        auto& path{ _cells[a] };
+        const auto found{ _search(
+          a, blocked, _reservations.freeFrom(index(goal)), COOPERATIVE_WEIGHT, path) };
+        if (found) {
+            for (uint32_t t{ 0 }; t < std::size(path); ++t)
+                _reservations.reserve(path[t], t, a);
+            _reservations.park(path.back(), std::size(path) - 1, a);
+            ++_stats.planned;
+        } else {
+            path = { index(start) };
+            _reservations.park(index(start), 0, a);
+            ++_stats.failed;
+        }
+    }
+}
+
+/*****************************************************************************/
+/*!
+ * \brief Conflict-based search : a best-first search over sets of
+ * constraints, starting from the independent shortest paths. The first
+ * collision of the best node gives two children, each forbidding it to one of
+ * the two agents, which is then replanned alone.
+ * \return true if it found a plan better than the cooperative one
+ */
+template<typename T>
+bool
+Cooperative<T>::_refine(void) noexcept
+{
+    TRACE_SCOPE("Cooperative::refine");
+    MEMORY_SCOPE(memory::SEARCH);
+
+    struct Node
+    {
+        size_t     parent;
+        uint32_t   agent; // Replanned agent, NONE at the root
+        Constraint constraint;
+        Path       path;
+        uint64_t   cost;
+    };
+
+    const auto agents{ std::size(_agents) };
+    const auto index = [this](const T* c) { return static_cast<uint64_t>(_graph->index(c)); };
+
+    uint64_t planned{ 0 };
+    for (const auto& path : _cells)
+        planned += _cost(path);
+
+    std::vector<Path> root(agents);
+    uint64_t          rootCost{ 0 };
+    for (uint32_t a{ 0 }; a < agents; ++a) {
+        const auto& [start, goal] = _agents[a];
+        if (nullptr == start || nullptr == goal || start->hasState(ICell::WALL) ||
+            goal->hasState(ICell::WALL))
+            return false;
+        if (!_search(a, [](uint64_t, uint64_t, uint32_t) { return false; }, 0, 1, root[a]))
+            return false;
+        rootCost += _cost(root[a]);
+    }
+
+    std::deque<Node> tree; // Stable references while growing
+    tree.push_back({ 0, Reservations::NONE, {}, {}, rootCost });
+
+    using Entry = std::pair<uint64_t, size_t>; // Cost, node
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+    open.emplace(rootCost, 0);
+
+    std::vector<const Path*>               paths(agents);
+    std::unordered_map<uint64_t, uint32_t> occupied;
+    const auto at = [&paths](uint32_t a, size_t t) {
+        return (*paths[a])[std::min(t, std::size(*paths[a]) - 1)];
+    };
+
+    while (!std::empty(open) && !_spent() && std::size(tree) < CBS_MAX_NODES) {
+        const auto [cost, id] = open.top();
+        open.pop();
+        ++_stats.cbsNodes;
+
+        // Latest replanning of every agent along the branch
+        std::fill(std::begin(paths), std::end(paths), nullptr);
+        for (auto n{ id }; 0 != n; n = tree[n].parent)
+            if (nullptr == paths[tree[n].agent])
+                paths[tree[n].agent] = &tree[n].path;
+        size_t length{ 0 };
+        for (uint32_t a{ 0 }; a < agents; ++a) {
+            if (nullptr == paths[a])
+                paths[a] = &root[a];
+            length = std::max(length, std::size(*paths[a]));
+        }
+
+        // First collision : two agents on a cell, or two agents swapping cells
+        uint32_t   first{ Reservations::NONE }, second{ Reservations::NONE };
+        Constraint firstConstraint{}, secondConstraint{};
+        for (uint32_t t{ 0 }; t < length && Reservations::NONE == first; ++t) {
+            occupied.clear();
+            for (uint32_t a{ 0 }; a < agents; ++a) {
+                auto [it, added] = occupied.try_emplace(at(a, t), a);
+                if (!added) {
+                    first = it->second;
+                    second = a;
+                    firstConstraint = secondConstraint = { at(a, t), at(a, t), t };
+                    break;
+                }
+            }
+            for (uint32_t a{ 0 }; 0 != t && a < agents && Reservations::NONE == first; ++a) {
+                const auto from{ at(a, t - 1) }, to{ at(a, t) };
+                if (from == to)
+                    continue;
+                if (auto it{ occupied.find(from) };
+                    std::end(occupied) != it && it->second != a && at(it->second, t - 1) == to) {
+                    first = a;
+                    second = it->second;
+                    firstConstraint = { from, to, t };
+                    secondConstraint = { to, from, t };
+                }
+            }
+        }
+
+        if (Reservations::NONE == first) {
+            if (0 == _stats.failed && cost >= planned)
+                return false;
+
+            for (uint32_t a{ 0 }; a < agents; ++a)
+                _cells[a] = *paths[a];
+            _stats.planned = agents;
+            _stats.failed = 0;
+            return true;
+        }
+
+        for (auto [agent, added] :
+             { std::make_pair(first, firstConstraint), std::make_pair(second, secondConstraint) }) {
+            // Constraints of the agent along the branch, plus the new one
+            std::vector<Constraint> constraints{ added };
+            for (auto n{ id }; 0 != n; n = tree[n].parent)
+                if (agent == tree[n].agent)
+                    constraints.push_back(tree[n].constraint);
+
+            // Staying on the goal is forbidden up to the last constraint on it
+            const auto goal{ index(_agents[agent].second) };
+            uint32_t   arrival{ 0 };
+            for (const auto& c : constraints)
+                if (c.from == c.to && goal == c.to)
+                    arrival = std::max(arrival, c.t + 1);
+
+            const auto blocked = [&constraints](uint64_t from, uint64_t to, uint32_t t) {
+                return std::any_of(std::begin(constraints), std::end(constraints), [&](auto& c) {
+                    return t == c.t && to == c.to && (c.from == c.to || from == c.from);
+                });
+            };
+
+            Path path;
+            if (!_search(agent, blocked, arrival, 1, path))
+                continue;
+            const auto childCost{ cost - _cost(*paths[agent]) + _cost(path) };
+            tree.push_back({ id, agent, added, std::move(path), childCost });
+            open.emplace(childCost, std::size(tree) - 1);
+        }
+    }
+    return false;
+}
+
+/*****************************************************************************/
+/*!
+ * \brief A* over (cell, time) : every step moves to a neighbour or waits, at
+ * the cost of a straight move. The goal counts only from \a arrival on, and
+ * the heuristic is inflated by \a weight.
+ */
+template<typename T>
+template<typename Blocked>
+bool
+Cooperative<T>::_search(size_t   agent,
+                        Blocked  blocked,
+                        uint32_t arrival,
+                        uint     weight,
+                        Path&    out) noexcept
+{
+    struct Node
+    {
+        uint64_t cell;
+        uint32_t t;
+        uint     g;
+        uint32_t parent;
+        bool     closed;
+    };
+
+    const auto width{ _graph->getWidth() };
+    const auto start{ static_cast<uint64_t>(_graph->index(_agents[agent].first)) };
+    const auto goal{ static_cast<uint64_t>(_graph->index(_agents[agent].second)) };
+    const auto key = [](uint64_t cell, uint32_t t) {
+        return (cell << Reservations::TIME_BITS) | t;
+    };
+
+    out.clear();
+    if (!_components.connected(_agents[agent].first, _agents[agent].second))
+        return false;
+
+    // Waiting for the goal to be free costs at least one straight move per step
+    const auto estimate = [arrival](uint h, uint32_t t) {
+        return std::max(h, t < arrival ? (arrival - t) * STRAIGHT_COST : 0);
+    };
+
+    // f, then closest to the goal, then latest first, node
+    using Entry = std::tuple<uint, uint, uint32_t, uint32_t>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+    std::vector<Node>                                                   nodes;
+    std::unordered_map<uint64_t, uint32_t>                              seen;
+
+    nodes.push_back({ start, 0, 0, NO_PARENT, false });
+    seen[key(start, 0)] = 0;
+    const auto h0{ _heuristic(start, goal) };
+    open.emplace(weight * estimate(h0, 0), h0, ~0u, 0);
+
+    uint64_t expanded{ 0 };
+    uint32_t found{ NO_PARENT };
+    while (!std::empty(open) && expanded < _expansionLimit) {
+        const auto id{ std::get<3>(open.top()) };
+        open.pop();
+        if (nodes[id].closed)
+            continue;
+        nodes[id].closed = true;
+        ++expanded;
+
+        const auto cur{ nodes[id] };
+        if (goal == cur.cell && cur.t >= arrival) {
+            found = id;
+            break;
+        }
+        if (cur.t >= _horizon)
+            continue;
+
+        // The last move is waiting
+        const auto cell{ _graph->cell(cur.cell % width, cur.cell / width) };
+        for (uint i{ 0 }; i <= _dirs; ++i) {
+            const auto next{ _dirs == i
+                               ? cell
+                               : _graph->neighbour(cell, MOVES[i].first, MOVES[i].second) };
+            if (nullptr == next || next->hasState(ICell::WALL))
+                continue;
+
+            const auto to{ static_cast<uint64_t>(_graph->index(next)) };
+            const auto t{ cur.t + 1 };
+            if (blocked(cur.cell, to, t))
+                continue;
+
+            const auto g{ cur.g + (_dirs == i ? STRAIGHT_COST : moveCost(i)) };
+            const auto h{ _heuristic(to, goal) };
+            auto [known, added] = seen.try_emplace(key(to, t), std::size(nodes));
+            if (added) {
+                nodes.push_back({ to, t, g, id, false });
+            } else {
+                auto& node{ nodes[known->second] };
+                if (node.closed || g >= node.g)
+                    continue;
+                node.g = g;
+                node.parent = id;
+            }
+            open.emplace(g + weight * estimate(h, t), h, ~t, known->second);
+        }
+    }
+    _stats.expanded += expanded;
+
+    if (NO_PARENT == found)
+        return false;
+    for (auto id{ found }; NO_PARENT != id; id = nodes[id].parent)
+        out.push_back(nodes[id].cell);
+    std::reverse(std::begin(out), std::end(out));
+    return true;
+}
+
+/*****************************************************************************/
+template<typename T>
+bool
+Cooperative<T>::_spent(void) const noexcept
+{
+    return std::chrono::steady_clock::now() >= _deadline;
+}
+
+/*****************************************************************************/
+template<typename T>
+uint
+Cooperative<T>::_heuristic(uint64_t from, uint64_t to) const noexcept
+{
+    const auto width{ _graph->getWidth() };
+    const auto dx{ static_cast<uint>(std::abs(int64_t(from % width) - int64_t(to % width))) };
+    const auto dy{ static_cast<uint>(std::abs(int64_t(from / width) - int64_t(to / width))) };
+    return octile(dx, dy, _dirs);
+}
+
+/*****************************************************************************/
+template<typename T>
+uint
+Cooperative<T>::_cost(const Path& path) const noexcept
+{
+    const auto width{ _graph->getWidth() };
+    uint       ret{ 0 };
+    for (size_t k{ 1 }; k < std::size(path); ++k) {
+        const bool dx{ path[k] % width != path[k - 1] % width };
+        const bool dy{ path[k] / width != path[k - 1] / width };
+        ret += (dx && dy) ? DIAGONAL_COST : STRAIGHT_COST;
+    }
+    return ret;
+}
+
+template class Cooperative<AStarCell>;
+}
@@ -0,0 +1,171 @@
+/**
+ * @file cooperative.hpp
+ * @brief Multi-agent path-finding : cooperative A* and conflict-based search
+ * @author lhm
+ */
+
+#ifndef SRC_ALGO_COOPERATIVE_HPP
+#define SRC_ALGO_COOPERATIVE_HPP
+
+// Standard headers
+#include <chrono>
+#include <cstdint>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Project's headers
+#include <env/components.hpp>
+#include <env/graph.hpp>
+
+namespace astar {
+
+/*****************************************************************************/
+/*!
+ * \brief Space-time reservations of a multi-agent plan : the agent holding a
+ * cell at a time step.
+ *
+ * Reservations live in an open-addressing hash table keyed by (cell, time),
+ * so memory follows the number of steps planned, not the size of the world.
+ * A parked agent (waiting on its start, or arrived) holds its cell from a
+ * time step on, forever.
+ */
+class Reservations
+{
+public:
+    static constexpr uint32_t NONE{ 0xFFFFFFFF };
+    static constexpr uint     TIME_BITS{ 20 }; //!< Time steps are below 2^20
+
+public:
+    Reservations() noexcept;
+
+    void clear(void) noexcept;
+    void reserve(uint64_t cell, uint32_t t, uint32_t agent) noexcept;
+    void park(uint64_t cell, uint32_t from, uint32_t agent) noexcept;
+    void unpark(uint64_t cell) noexcept;
+
+    /*!
+     * \brief Agent holding \a cell at \a t, parked ones included, NONE if free.
+     */
+    uint32_t owner(uint64_t cell, uint32_t t) const noexcept;
+
+    /*!
+     * \brief First time step from which \a cell is not reserved anymore,
+     * parking excepted.
+     */
+    uint32_t freeFrom(uint64_t cell) const noexcept;
+
+    size_t size(void) const noexcept { return _count; }
+
+protected:
+    size_t _slot(uint64_t key) const noexcept;
+    void   _grow(void) noexcept;
+
+private:
+    std::vector<uint64_t> _keys;
+    std::vector<uint32_t> _agents;
+    size_t                _count{ 0 };
+    uint                  _bits;
+
+    std::unordered_map<uint64_t, std::pair<uint32_t, uint32_t>> _parked; // From, agent
+    std::unordered_map<uint64_t, uint32_t>                      _freeFrom;
+};
+
+/*****************************************************************************/
+/*!
+ * \brief The Cooperative class plans collision-free paths for many agents
+ * sharing a graph. Agents move (or wait) once per time step, never share a
+ * cell and never swap cells, and stay on their goal once arrived.
+ *
+ * Agents are planned one after the other, farthest first, by an A* over
+ * (cell, time) avoiding the \a Reservations of the agents already planned. Its
+ * octile heuristic is inflated twice : paths may cost up to twice the best
+ * ones given the reservations, instead of expanding every equivalent path
+ * each time an agent has to wait.
+ * Agents not planned before the time budget runs out, or without any path,
+ * wait on their start.
+ *
+ * When \a refine is set and time is left, a conflict-based search then looks
+ * for a plan of lower total cost, replanning agents separately under
+ * constraints added where their independent paths collide. Its plan is kept
+ * only if it ends within the budget.
+ */
+template<typename T>
+class Cooperative
+{
+public:
+    using Agent = std::pair<T*, T*>; // Start, goal
+
+    struct Stats
+    {
+        size_t   planned{ 0 };    //!< Agents reaching their goal
+        size_t   failed{ 0 };     //!< Agents waiting on their start
+        uint64_t expanded{ 0 };   //!< (cell, time) states expanded, all searches
+        size_t   cbsNodes{ 0 };   //!< Nodes of the conflict-based search
+        bool     refined{ false }; //!< Whether the conflict-based search plan is kept
+        uint64_t cost{ 0 };       //!< Sum of the costs of the paths
+        double   planMs{ 0 };
+        double   refineMs{ 0 };
+    };
+
+public:
+    Cooperative(uint dirs = 8, double budgetMs = 1000., bool refine = false) noexcept;
+    virtual ~Cooperative() noexcept = default;
+
+    /*!
+     * \return true if every agent reaches its goal
+     */
+    bool plan(const env::Graph<T>*, const std::vector<Agent>&) noexcept;
+
+    /*!
+     * \brief Cell of every agent at every time step, until its arrival.
+     */
+    const std::vector<std::vector<T*>>& paths(void) const noexcept { return _paths; }
+
+    /*!
+     * \brief Cell of \a agent at \a t, its last one after its arrival.
+     */
+    T*     position(size_t agent, size_t t) const noexcept;
+    size_t makespan(void) const noexcept;
+
+    const Stats& stats(void) const noexcept { return _stats; }
+
+protected:
+    using Path = std::vector<uint64_t>; // Cell index per time step
+
+    struct Constraint
+    {
+        uint64_t from; // Origin of a forbidden move, or the forbidden cell itself
+        uint64_t to;
+        uint32_t t;
+    };
+
+    template<typename Blocked>
+    bool _search(size_t agent, Blocked blocked, uint32_t arrival, uint weight, Path& out) noexcept;
+
+    void _cooperative(void) noexcept;
+    bool _refine(void) noexcept;
+    bool _spent(void) const noexcept;
+    uint _heuristic(uint64_t from, uint64_t to) const noexcept;
+    uint _cost(const Path&) const noexcept;
+
+private:
+    uint   _dirs;
+    double _budgetMs;
+    bool   _refineEnabled;
+
+    const env::Graph<T>*                              _graph{ nullptr };
+    std::vector<Agent>                                _agents;
+    std::vector<Path>                                 _cells;
+    std::vector<std::vector<T*>>                      _paths;
+    Reservations                                      _reservations;
+    env::Components<T>                                _components;
+    Stats                                             _stats;
+    uint32_t                                          _horizon{ 0 };
+    uint64_t                                          _expansionLimit{ 0 };
+    std::chrono::steady_clock::time_point             _deadline;
+};
+}
+
+#endif // SRC_ALGO_COOPERATIVE_HPP
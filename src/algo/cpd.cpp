@@ -0,0 +1,293 @@
+/**
+ * @file cpd.cpp
+ * @brief Implementation of \a cpd.hpp
+ * @author lhm
+ */
+
+// Standard headers
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <thread>
+
+// Project's headers
+#include "cpd.hpp"
+#include "distance.hpp"
+#include "moves.hpp"
+#include <utils/Memory.hpp>
+#include <utils/Trace.hpp>
+
+// External headers
+#include <JSON.hpp>
+
+using namespace env;
+
+namespace astar {
+
+constexpr uint32_t NO_POSITION{ 0xFFFFFFFF };
+constexpr uint32_t FILE_MAGIC{ 0x31445043 }; // "CPD1"
+
+/*****************************************************************************/
+template<typename T>
+bool
+Cpd<T>::configure(const JSON::Object& conf) noexcept
+{
+    if (!Impl<T>::configure(conf))
+        return false;
+
+    _file.clear();
+    if (conf["cpd-file"] && conf["cpd-file"].isString())
+        _file = conf["cpd-file"].asString();
+
+    _graph = nullptr;
+    return true;
+}
+
+/*****************************************************************************/
+template<typename T>
+uint64_t
+Cpd<T>::signature(void) const noexcept
+{
+    return std::hash<std::string>()("cpd:" + std::to_string(this->_dirs));
+}
+
+/*****************************************************************************/
+template<typename T>
+bool
+Cpd<T>::run(Graph<T>* world, T* start, T* end) noexcept
+{
+    TRACE_SCOPE("Cpd::run");
+    MEMORY_SCOPE(memory::SEARCH);
+    this->_world = world;
+    this->_path.clear();
+    this->_stats.reset();
+    if (nullptr == world || nullptr == start || nullptr == end)
+        return false;
+
+    SEARCH_STAT(Lap timer);
+
+    this->_components.update(world);
+    if (!this->_components.connected(start, end)) {
+        SEARCH_STAT(this->_stats.setupMs = timer.lap());
+        return false;
+    }
+
+    update(world);
+    SEARCH_STAT(this->_stats.setupMs = timer.lap());
+
+    // Follow the first moves, at most one visit per cell : every move is one
+    // cell expanded
+    uint cost{ 0 };
+    T*   cur{ start };
+    for (this->_path.push_back(cur); cur != end;) {
+        auto move{ _firstMove(cur, end) };
+        SEARCH_STAT(++this->_stats.expanded);
+        if (NO_MOVE == move || std::size(this->_path) > std::size(_order)) {
+            this->_path.clear();
+            SEARCH_STAT(this->_stats.searchMs = timer.lap());
+            return false;
+        }
+
+        cur = world->neighbour(cur, MOVES[move].first, MOVES[move].second);
+        cost += moveCost(move);
+        cur->_G = cost;
+        this->_path.push_back(cur);
+    }
+    SEARCH_STAT(this->_stats.searchMs = timer.lap());
+
+    SEARCH_STAT(this->_stats.cost = cost);
+    SEARCH_STAT(this->_stats.pathLength = std::size(this->_path));
+    SEARCH_STAT(this->_stats.pathMs = timer.lap());
+
+    return true;
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+Cpd<T>::update(const Graph<T>* graph) noexcept
+{
+    if (nullptr == graph || (graph == _graph && graph->version() == _version))
+        return;
+
+    _graph = graph;
+    _version = graph->version();
+    _key = graph->wallsHash() ^ (static_cast<uint64_t>(this->_dirs) << 56);
+
+    if (!std::empty(_file) && load(_file))
+        return;
+
+    _build();
+
+    if (!std::empty(_file))
+        save(_file);
+}
+
+/*****************************************************************************/
+template<typename T>
+bool
+Cpd<T>::save(const std::string& file) const noexcept
+{
+    if (nullptr == _graph)
+        return false;
+
+    std::ofstream ofs(file, std::ios::binary | std::ios::trunc);
+    if (!ofs)
+        return false;
+
+    const uint32_t header[]{ FILE_MAGIC,
+                             static_cast<uint32_t>(_graph->getWidth()),
+                             static_cast<uint32_t>(_graph->getHeight()),
+                             this->_dirs,
+                             static_cast<uint32_t>(std::size(_runs)) };
+
+    ofs.write(reinterpret_cast<const char*>(header), sizeof(header));
+    ofs.write(reinterpret_cast<const char*>(&_key), sizeof(_key));
+    ofs.write(reinterpret_cast<const char*>(_order.data()), std::size(_order) * sizeof(uint32_t));
+    ofs.write(reinterpret_cast<const char*>(_offsets.data()),
+              std::size(_offsets) * sizeof(uint32_t));
+    ofs.write(reinterpret_cast<const char*>(_runs.data()), std::size(_runs) * sizeof(uint32_t));
+
+    return static_cast<bool>(ofs);
+}
+
+/*****************************************************************************/
+template<typename T>
+bool
+Cpd<T>::load(const std::string& file) noexcept
+{
+    if (nullptr == _graph)
+        return false;
+
+    std::ifstream ifs(file, std::ios::binary);
+    if (!ifs)
+        return false;
+
+    uint32_t header[5];
+    uint64_t key;
+    ifs.read(reinterpret_cast<char*>(header), sizeof(header));
+    ifs.read(reinterpret_cast<char*>(&key), sizeof(key));
+
+    // Only accept tables built for this exact walls layout
+    if (!ifs || FILE_MAGIC != header[0] || _graph->getWidth() != header[1] ||
+        _graph->getHeight() != header[2] || this->_dirs != header[3] || _key != key)
+        return false;
+
+    const auto            size{ _graph->getWidth() * _graph->getHeight() };
+    std::vector<uint32_t> order(size), offsets(size + 1), runs(header[4]);
+
+    ifs.read(reinterpret_cast<char*>(order.data()), size * sizeof(uint32_t));
+    ifs.read(reinterpret_cast<char*>(offsets.data()), (size + 1) * sizeof(uint32_t));
+    ifs.read(reinterpret_cast<char*>(runs.data()), std::size(runs) * sizeof(uint32_t));
+    if (!ifs)
+        return false;
+
+    _order = std::move(order);
+    _offsets = std::move(offsets);
+    _runs = std::move(runs);
+    return true;
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+Cpd<T>::_build(void) noexcept
+{
+    TRACE_SCOPE("Cpd::build");
+    MEMORY_SCOPE(memory::SEARCH);
+    const auto width{ _graph->getWidth() };
+    const auto size{ width * _graph->getHeight() };
+    const auto dirs{ this->_dirs };
+
+    auto isWall = [&](size_t idx) {
+        return _graph->cell(idx % width, idx / width)->hasState(ICell::WALL);
+    };
+
+    // Depth-first order of the free cells : neighbours in the graph get close
+    // positions, which makes long runs of identical first moves.
+    std::vector<size_t> cells;
+    std::vector<size_t> stack;
+
+    _order.assign(size, NO_POSITION);
+    for (size_t seed{ 0 }; seed < size; ++seed) {
+        if (NO_POSITION != _order[seed] || isWall(seed))
+            continue;
+
+        stack.push_back(seed);
+        while (!std::empty(stack)) {
+            auto idx{ stack.back() };
+            stack.pop_back();
+            if (NO_POSITION != _order[idx])
+                continue;
+
+            _order[idx] = static_cast<uint32_t>(std::size(cells));
+            cells.push_back(idx);
+
+            for (uint i{ dirs }; i-- > 0;) {
+                auto neigh{ _graph->cell(idx % width + MOVES[i].first,
+                                         idx / width + MOVES[i].second) };
+                if (nullptr != neigh && !neigh->hasState(ICell::WALL) &&
+                    NO_POSITION == _order[_graph->index(neigh)])
+                    stack.push_back(_graph->index(neigh));
+            }
+        }
+    }
+
+    // One first-moves search per source, spread over the available cores
+    std::vector<std::vector<uint32_t>> runs(size);
+    std::atomic<size_t>                next{ 0 };
+
+    auto work = [&]() {
+        std::vector<uint>    dist;
+        std::vector<uint8_t> moves;
+        for (auto k{ next++ }; k < std::size(cells); k = next++) {
+            const auto source{ cells[k] };
+            firstMoves(*_graph, _graph->cell(source % width, source / width), dirs, dist, moves);
+
+            // Targets without a move (the source, unreachable cells) extend
+            // the current run
+            auto& out{ runs[source] };
+            for (uint32_t pos{ 0 }; pos < std::size(cells); ++pos) {
+                auto move{ moves[cells[pos]] };
+                if (NO_MOVE != move && (std::empty(out) || (out.back() & 0x7) != move))
+                    out.push_back((pos << 3) | move);
+            }
+            out.shrink_to_fit();
+        }
+    };
+
+    const auto threads{ std::max(std::thread::hardware_concurrency(), 1u) };
+    std::vector<std::thread> workers;
+    for (uint t{ 1 }; t < threads; ++t)
+        workers.emplace_back(work);
+    work();
+
+    for (auto& w : workers)
+        w.join();
+
+    _offsets.assign(size + 1, 0);
+    _runs.clear();
+    for (size_t idx{ 0 }; idx < size; ++idx) {
+        _offsets[idx] = static_cast<uint32_t>(std::size(_runs));
+        _runs.insert(std::end(_runs), std::begin(runs[idx]), std::end(runs[idx]));
+    }
+    _offsets[size] = static_cast<uint32_t>(std::size(_runs));
+}
+
+/*****************************************************************************/
+template<typename T>
+uint8_t
+Cpd<T>::_firstMove(const T* from, const T* to) const noexcept
+{
+    const auto first{ std::begin(_runs) + _offsets[_graph->index(from)] };
+    const auto last{ std::begin(_runs) + _offsets[_graph->index(from) + 1] };
+    if (first == last)
+        return NO_MOVE;
+
+    // Last run starting at or before the position of the target
+    auto it{ std::upper_bound(first, last, (_order[_graph->index(to)] << 3) | 0x7) };
+    return static_cast<uint8_t>(*((it == first) ? first : std::prev(it)) & 0x7);
+}
+
+template class Cpd<AStarCell>;
+}
@@ -0,0 +1,74 @@
+/**
+ * @file cpd.hpp
+ * @brief Compressed path database : first-move tables
+ * @author lhm
+ */
+
+#ifndef SRC_ALGO_CPD_HPP
+#define SRC_ALGO_CPD_HPP
+
+// Standard headers
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Project's headers
+#include <algo/astar.hpp>
+
+namespace astar {
+
+/*****************************************************************************/
+/*!
+ * \brief The Cpd engine answers queries by table lookups only.
+ *
+ * For every source cell, it stores the first move of a shortest path to every
+ * other cell. Cells are numbered in depth-first order, so that close cells
+ * share the same first move, and each source only keeps the runs of equal
+ * moves in that order. A path is then followed one lookup (binary search in
+ * the runs of the current cell) per move, and is optimal.
+ *
+ * The tables are built in parallel on the first query after the walls changed,
+ * and can be saved to 'cpd-file' to skip this step as long as the walls do not
+ * change.
+ */
+template<typename T>
+class Cpd : public Impl<T>
+{
+public:
+    Cpd() noexcept = default;
+    virtual ~Cpd() noexcept = default;
+
+    [[maybe_unused]] virtual bool configure(const JSON::Object&) noexcept override;
+    [[maybe_unused]] virtual bool run(env::Graph<T>*, T* start, T* end) noexcept override;
+
+    virtual uint64_t signature(void) const noexcept override;
+
+    /*!
+     * \brief Make the tables match the current state of \a graph.
+     * Does nothing unless the graph changed since the last call.
+     */
+    void update(const env::Graph<T>* graph) noexcept;
+
+    [[maybe_unused]] bool save(const std::string& file) const noexcept;
+    [[maybe_unused]] bool load(const std::string& file) noexcept;
+
+    size_t runs(void) const noexcept { return std::size(_runs); }
+
+protected:
+    void    _build(void) noexcept;
+    uint8_t _firstMove(const T* from, const T* to) const noexcept;
+
+private:
+    const env::Graph<T>* _graph{ nullptr };
+    uint64_t             _version{ 0 };
+    uint64_t             _key{ 0 };
+    std::string          _file;
+
+    std::vector<uint32_t> _order;   // Depth-first position of each cell
+    std::vector<uint32_t> _offsets; // First run of each source cell
+    std::vector<uint32_t> _runs;    // Position of the first target << 3 | move
+};
+
+}
+
+#endif // SRC_ALGO_CPD_HPP
@@ -0,0 +1,211 @@
+/**
+ * @file distance.cpp
+ * @brief Implementation of \a distance.hpp
+ * @author lhm
+ */
+
+// Standard headers
+#include <array>
+#include <atomic>
+#include <thread>
+
+// Project's headers
+#include "distance.hpp"
+#include "moves.hpp"
+
+using namespace env;
+
+namespace astar {
+
+// Below this size, a wavefront is not worth spawning threads for
+constexpr size_t PARALLEL_WAVEFRONT{ 4096 };
+
+// One bucket per pending cost, modulo the largest move cost
+using Buckets = std::array<std::vector<uint>, DIAGONAL_COST + 1>;
+
+/*****************************************************************************/
+template<typename G, typename OnLower>
+static void
+_serial(const G&           graph,
+        uint               dirs,
+        std::vector<uint>& out,
+        Buckets&           buckets,
+        OnLower&&          onLower) noexcept
+{
+    const auto width{ graph.getWidth() };
+    size_t     pending{ 1 };
+    uint       cost{ 0 };
+
+    while (pending > 0) {
+        auto& bucket{ buckets[cost % std::size(buckets)] };
+
+        while (!std::empty(bucket)) {
+            auto idx{ bucket.back() };
+            bucket.pop_back();
+            --pending;
+
+            // Stale entry, the cell was settled with a lower cost
+            if (out[idx] != cost)
+                continue;
+
+            const auto cur{ graph.cell(idx % width, idx / width) };
+            for (uint i{ 0 }; i < dirs; ++i) {
+                auto neigh{ graph.neighbour(cur, MOVES[i].first, MOVES[i].second) };
+                if (nullptr == neigh || neigh->hasState(ICell::WALL))
+                    continue;
+
+                auto nidx{ graph.index(neigh) };
+                auto ncost{ cost + moveCost(i) };
+                if (ncost < out[nidx]) {
+                    out[nidx] = ncost;
+                    onLower(idx, nidx, i);
+                    buckets[ncost % std::size(buckets)].push_back(nidx);
+                    ++pending;
+                }
+            }
+        }
+        ++cost;
+    }
+}
+
+/*****************************************************************************/
+template<typename G>
+static void
+_parallel(const G&           graph,
+          uint               dirs,
+          std::vector<uint>& out,
+          Buckets&           buckets,
+          uint               threads) noexcept
+{
+    const auto                     width{ graph.getWidth() };
+    std::vector<std::atomic<uint>> dist(std::size(out));
+    for (size_t idx{ 0 }; idx < std::size(out); ++idx)
+        dist[idx].store(out[idx], std::memory_order_relaxed);
+
+    // Cells reached by one worker : (cost, index)
+    std::vector<std::vector<std::pair<uint, uint>>> found(threads);
+
+    size_t pending{ 1 };
+    uint   cost{ 0 };
+
+    auto expand = [&](const std::vector<uint>& bucket, size_t first, size_t last, uint w) {
+        for (auto k{ first }; k < last; ++k) {
+            auto idx{ bucket[k] };
+            if (dist[idx].load(std::memory_order_relaxed) != cost)
+                continue;
+
+            const auto cur{ graph.cell(idx % width, idx / width) };
+            for (uint i{ 0 }; i < dirs; ++i) {
+                auto neigh{ graph.neighbour(cur, MOVES[i].first, MOVES[i].second) };
+                if (nullptr == neigh || neigh->hasState(ICell::WALL))
+                    continue;
+
+                // Atomic min : several cells of the wavefront may share a neighbour
+                auto  ncost{ cost + moveCost(i) };
+                auto& target{ dist[graph.index(neigh)] };
+                auto  old{ target.load(std::memory_order_relaxed) };
+                while (ncost < old && !target.compare_exchange_weak(old, ncost))
+                    ;
+                if (ncost < old)
+                    found[w].emplace_back(ncost, graph.index(neigh));
+            }
+        }
+    };
+
+    while (pending > 0) {
+        auto& bucket{ buckets[cost % std::size(buckets)] };
+        pending -= std::size(bucket);
+
+        // Every cell of the bucket is final : no move costs 0, so expanding
+        // one cannot lower the cost of another.
+        if (std::size(bucket) < PARALLEL_WAVEFRONT) {
+            expand(bucket, 0, std::size(bucket), 0);
+        } else {
+            std::vector<std::thread> workers;
+            const auto               chunk{ (std::size(bucket) + threads - 1) / threads };
+            for (uint w{ 1 }; w < threads; ++w)
+                workers.emplace_back(expand,
+                                     std::cref(bucket),
+                                     std::min(std::size(bucket), w * chunk),
+                                     std::min(std::size(bucket), (w + 1) * chunk),
+                                     w);
+            expand(bucket, 0, std::min(std::size(bucket), chunk), 0);
+            for (auto& w : workers)
+                w.join();
+        }
+        bucket.clear();
+
+        for (auto& f : found) {
+            for (auto [ncost, nidx] : f)
+                buckets[ncost % std::size(buckets)].push_back(nidx);
+            pending += std::size(f);
+            f.clear();
+        }
+        ++cost;
+    }
+
+    for (size_t idx{ 0 }; idx < std::size(out); ++idx)
+        out[idx] = dist[idx].load(std::memory_order_relaxed);
+}
+
+/*****************************************************************************/
+template<typename T, typename Layout>
+void
+distances(const Graph<T, Layout>& graph,
+          const T*                source,
+          uint                    dirs,
+          std::vector<uint>&      out,
+          uint                    threads) noexcept
+{
+    out.assign(graph.getWidth() * graph.getHeight(), UNREACHABLE);
+    if (nullptr == source || source->hasState(ICell::WALL))
+        return;
+
+    Buckets buckets;
+    out[graph.index(source)] = 0;
+    buckets[0].push_back(graph.index(source));
+
+    if (threads > 1)
+        _parallel(graph, dirs, out, buckets, threads);
+    else
+        _serial(graph, dirs, out, buckets, [](uint, uint, uint) {});
+}
+
+/*****************************************************************************/
+template<typename T, typename Layout>
+void
+firstMoves(const Graph<T, Layout>& graph,
+           const T*                source,
+           uint                    dirs,
+           std::vector<uint>&      out,
+           std::vector<uint8_t>&   moves) noexcept
+{
+    out.assign(graph.getWidth() * graph.getHeight(), UNREACHABLE);
+    moves.assign(std::size(out), NO_MOVE);
+    if (nullptr == source || source->hasState(ICell::WALL))
+        return;
+
+    Buckets    buckets;
+    const auto from{ graph.index(source) };
+    out[from] = 0;
+    buckets[0].push_back(from);
+
+    // A cell inherits the first move of the cell it was lowered from
+    _serial(graph, dirs, out, buckets, [&moves, from](uint idx, uint nidx, uint i) {
+        moves[nidx] = (from == idx) ? static_cast<uint8_t>(i) : moves[idx];
+    });
+}
+
+#define INSTANTIATE(LAYOUT)                                                                        \
+    template void distances<AStarCell, LAYOUT>(                                                    \
+      const Graph<AStarCell, LAYOUT>&, const AStarCell*, uint, std::vector<uint>&, uint) noexcept; \
+    template void firstMoves<AStarCell, LAYOUT>(const Graph<AStarCell, LAYOUT>&,                  \
+                                                const AStarCell*,                                  \
+                                                uint,                                              \
+                                                std::vector<uint>&,                                \
+                                                std::vector<uint8_t>&) noexcept;
+
+INSTANTIATE(layout::RowMajor)
+INSTANTIATE(layout::Tiled<>)
+INSTANTIATE(layout::ZOrder)
+}
@@ -0,0 +1,61 @@
+/**
+ * @file distance.hpp
+ * @brief Exact distances from one cell to every other cell of a graph
+ * @author lhm
+ */
+
+#ifndef SRC_ALGO_DISTANCE_HPP
+#define SRC_ALGO_DISTANCE_HPP
+
+// Standard headers
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Project's headers
+#include <env/graph.hpp>
+
+namespace astar {
+
+constexpr uint    UNREACHABLE{ std::numeric_limits<uint>::max() };
+constexpr uint8_t NO_MOVE{ 0xFF };
+
+/*****************************************************************************/
+/*!
+ * \brief Compute the cost of the shortest path from \a source to every cell of
+ * \a graph, using the same moves and costs as \a Impl.
+ *
+ * Costs only take two small values so the search uses a bucket queue (Dial)
+ * instead of a binary heap. All the cells of a bucket are final, so wide
+ * wavefronts are expanded by several threads at once.
+ *
+ * \param dirs Number of allowed moves (4 or 8)
+ * \param out Filled with one cost per cell (row-major), \a UNREACHABLE for
+ * walls and cells that cannot be reached
+ * \param threads Maximum number of threads expanding a wavefront
+ */
+template<typename T, typename Layout>
+void
+distances(const env::Graph<T, Layout>& graph,
+          const T*                     source,
+          uint                         dirs,
+          std::vector<uint>&           out,
+          uint                         threads = 1) noexcept;
+
+/*****************************************************************************/
+/*!
+ * \brief Same as \a distances, also giving for every cell the first move (index
+ * in \a MOVES) of a shortest path from \a source to it, \a NO_MOVE for the
+ * source itself and the cells that cannot be reached.
+ */
+template<typename T, typename Layout>
+void
+firstMoves(const env::Graph<T, Layout>& graph,
+           const T*                     source,
+           uint                         dirs,
+           std::vector<uint>&           out,
+           std::vector<uint8_t>&        moves) noexcept;
+
+}
+
+#endif // SRC_ALGO_DISTANCE_HPP
@@ -0,0 +1,56 @@
+/**
+ * @file engines.cpp
+ * @brief Implementation of \a engines.hpp
+ * @author lhm
+ */
+
+// Standard headers
+
+// Project's headers
+#include "anytime.hpp"
+#include "automatic.hpp"
+#include "cpd.hpp"
+#include "engines.hpp"
+#include "fringe.hpp"
+#include "rsr.hpp"
+#include "subgoals.hpp"
+#include "theta.hpp"
+
+using namespace env;
+
+namespace astar {
+
+/*****************************************************************************/
+template<typename T>
+std::map<std::string, Factory<T>>&
+factories(void) noexcept
+{
+    static std::map<std::string, Factory<T>> ret{
+        { "astar", []() { return std::make_unique<Impl<T>>(); } },
+        { "theta", []() { return std::make_unique<Theta<T>>(); } },
+        { "lazy-theta", []() { return std::make_unique<Theta<T>>(true); } },
+        { "cpd", []() { return std::make_unique<Cpd<T>>(); } },
+        { "anytime", []() { return std::make_unique<Anytime<T>>(); } },
+        { "fringe", []() { return std::make_unique<Fringe<T>>(); } },
+        { "ida", []() { return std::make_unique<Fringe<T>>(true); } },
+        { "rsr", []() { return std::make_unique<Rsr<T>>(); } },
+        { "subgoals", []() { return std::make_unique<Subgoals<T>>(); } },
+        { "auto", []() { return std::make_unique<Automatic<T>>(); } }
+    };
+    return ret;
+}
+
+/*****************************************************************************/
+template<typename T>
+std::unique_ptr<Impl<T>>
+create(const std::string& engine) noexcept
+{
+    const auto& all{ factories<T>() };
+    if (auto it{ all.find(engine) }; std::end(all) != it)
+        return it->second();
+    return nullptr;
+}
+
+template std::map<std::string, Factory<AStarCell>>& factories<AStarCell>(void) noexcept;
+template std::unique_ptr<Impl<AStarCell>> create<AStarCell>(const std::string&) noexcept;
+}
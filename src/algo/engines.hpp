@@ -0,0 +1,42 @@
+/**
+ * @file engines.hpp
+ * @brief Creation of the path-finding engines by name
+ * @author lhm
+ */
+
+#ifndef SRC_ALGO_ENGINES_HPP
+#define SRC_ALGO_ENGINES_HPP
+
+// Standard headers
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+
+// Project's headers
+#include <algo/astar.hpp>
+
+namespace astar {
+
+template<typename T>
+using Factory = std::function<std::unique_ptr<Impl<T>>(void)>;
+
+/*****************************************************************************/
+/*!
+ * \brief Factories of the engines by name : "astar", "theta", "lazy-theta",
+ * "cpd", "anytime", "fringe", "ida", "rsr", "subgoals" and "auto" to begin
+ * with. More engines may be added before the analyzers are created.
+ */
+template<typename T>
+std::map<std::string, Factory<T>>& factories(void) noexcept;
+
+/*****************************************************************************/
+/*!
+ * \brief Create the engine named \a engine, not configured yet.
+ * \return nullptr if the name is unknown
+ */
+template<typename T>
+std::unique_ptr<Impl<T>> create(const std::string& engine) noexcept;
+}
+
+#endif // SRC_ALGO_ENGINES_HPP
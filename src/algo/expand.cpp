@@ -0,0 +1,340 @@
+/**
+ * @file expand.cpp
+ * @brief Implementation of \a expand.hpp
+ * @author lhm
+ */
+
+// Standard headers
+#include <algorithm>
+#include <cstdlib>
+
+// Project's headers
+#include "expand.hpp"
+#include "moves.hpp"
+
+// The vectorized kernels are compiled for their instruction set only, and
+// called after checking that the CPU supports it
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PATH_FINDER_X86
+#include <immintrin.h>
+#endif
+
+using namespace env;
+
+namespace astar {
+
+constexpr int ESTIMATE_MANHATTAN{ 1 };
+constexpr int ESTIMATE_OCTAGONAL{ 2 };
+
+/*****************************************************************************/
+static inline uint32_t
+_estimate(const ExpandKernel& k, int32_t x, int32_t y) noexcept
+{
+    const auto dx{ std::abs(x - k.goalX) };
+    const auto dy{ std::abs(y - k.goalY) };
+
+    if (ESTIMATE_MANHATTAN == k.estimate)
+        return 10 * (dx + dy);
+    if (ESTIMATE_OCTAGONAL == k.estimate)
+        return 10 * (dx + dy) - 6 * std::min(dx, dy);
+    return 0;
+}
+
+/*****************************************************************************/
+static uint
+_expandScalar(const ExpandKernel& k,
+              uint32_t            cell,
+              uint32_t*           cells,
+              uint32_t*           g,
+              uint32_t*           h) noexcept
+{
+    const int32_t x(cell % k.pitch), y(cell / k.pitch);
+    uint          count{ 0 };
+
+    for (uint i{ 0 }; i < 8; ++i) {
+        const auto next{ cell + k.offsets[i] };
+        const auto cost{ k.g[cell] + k.costs[i] };
+        if (k.blocked[next] || cost >= k.g[next])
+            continue;
+
+        cells[count] = next;
+        g[count] = cost;
+        h[count] = _estimate(k, x + k.dx[i], y + k.dy[i]);
+        ++count;
+    }
+    return count;
+}
+
+#ifdef PATH_FINDER_X86
+/*****************************************************************************/
+/*!
+ * \brief Keep the lanes set in \a mask, in order.
+ */
+static inline uint
+_compress(uint       mask,
+          const int* lanes,
+          const int* costs,
+          const int* estimates,
+          uint32_t*  cells,
+          uint32_t*  g,
+          uint32_t*  h) noexcept
+{
+    uint count{ 0 };
+    for (; 0 != mask; mask &= mask - 1, ++count) {
+        const auto i{ __builtin_ctz(mask) };
+        cells[count] = lanes[i];
+        g[count] = costs[i];
+        h[count] = estimates[i];
+    }
+    return count;
+}
+
+/*****************************************************************************/
+__attribute__((target("sse4.1"))) static uint
+_expandSse4(const ExpandKernel& k,
+            uint32_t            cell,
+            uint32_t*           cells,
+            uint32_t*           g,
+            uint32_t*           h) noexcept
+{
+    alignas(16) int lanes[8], costs[8], estimates[8];
+    uint            mask{ 0 };
+
+    const auto from{ _mm_set1_epi32(k.g[cell]) };
+    const auto x{ _mm_set1_epi32(cell % k.pitch) };
+    const auto y{ _mm_set1_epi32(cell / k.pitch) };
+
+    for (uint half{ 0 }; half < 8; half += 4) {
+        const auto next{ _mm_add_epi32(_mm_set1_epi32(cell),
+                                       _mm_loadu_si128((const __m128i*)(k.offsets + half))) };
+        _mm_store_si128((__m128i*)(lanes + half), next);
+
+        // No gathers before AVX2
+        const auto known{ _mm_setr_epi32(k.g[lanes[half]],
+                                         k.g[lanes[half + 1]],
+                                         k.g[lanes[half + 2]],
+                                         k.g[lanes[half + 3]]) };
+        const auto blocked{ _mm_setr_epi32(k.blocked[lanes[half]],
+                                           k.blocked[lanes[half + 1]],
+                                           k.blocked[lanes[half + 2]],
+                                           k.blocked[lanes[half + 3]]) };
+
+        const auto cost{ _mm_add_epi32(from,
+                                       _mm_loadu_si128((const __m128i*)(k.costs + half))) };
+        const auto better{ _mm_andnot_si128(_mm_cmpgt_epi32(blocked, _mm_setzero_si128()),
+                                            _mm_cmpgt_epi32(known, cost)) };
+        _mm_store_si128((__m128i*)(costs + half), cost);
+        mask |= _mm_movemask_ps(_mm_castsi128_ps(better)) << half;
+
+        const auto dx{ _mm_abs_epi32(
+          _mm_sub_epi32(_mm_add_epi32(x, _mm_loadu_si128((const __m128i*)(k.dx + half))),
+                        _mm_set1_epi32(k.goalX))) };
+        const auto dy{ _mm_abs_epi32(
+          _mm_sub_epi32(_mm_add_epi32(y, _mm_loadu_si128((const __m128i*)(k.dy + half))),
+                        _mm_set1_epi32(k.goalY))) };
+        auto estimate{ _mm_mullo_epi32(_mm_add_epi32(dx, dy), _mm_set1_epi32(10)) };
+        if (ESTIMATE_OCTAGONAL == k.estimate)
+            estimate =
+              _mm_sub_epi32(estimate, _mm_mullo_epi32(_mm_min_epi32(dx, dy), _mm_set1_epi32(6)));
+        else if (ESTIMATE_MANHATTAN != k.estimate)
+            estimate = _mm_setzero_si128();
+        _mm_store_si128((__m128i*)(estimates + half), estimate);
+    }
+
+    return _compress(mask, lanes, costs, estimates, cells, g, h);
+}
+
+/*****************************************************************************/
+__attribute__((target("avx2"))) static uint
+_expandAvx2(const ExpandKernel& k,
+            uint32_t            cell,
+            uint32_t*           cells,
+            uint32_t*           g,
+            uint32_t*           h) noexcept
+{
+    alignas(32) int lanes[8], costs[8], estimates[8];
+
+    const auto next{ _mm256_add_epi32(_mm256_set1_epi32(cell),
+                                      _mm256_loadu_si256((const __m256i*)k.offsets)) };
+    const auto known{ _mm256_i32gather_epi32((const int*)k.g, next, 4) };
+
+    // Bytes gathered 4 at a time, hence the padding of the flags
+    const auto blocked{ _mm256_and_si256(_mm256_i32gather_epi32((const int*)k.blocked, next, 1),
+                                         _mm256_set1_epi32(0xFF)) };
+
+    const auto cost{ _mm256_add_epi32(_mm256_set1_epi32(k.g[cell]),
+                                      _mm256_loadu_si256((const __m256i*)k.costs)) };
+    const auto better{ _mm256_andnot_si256(_mm256_cmpgt_epi32(blocked, _mm256_setzero_si256()),
+                                           _mm256_cmpgt_epi32(known, cost)) };
+    const uint mask(_mm256_movemask_ps(_mm256_castsi256_ps(better)));
+    if (0 == mask)
+        return 0;
+
+    const auto dx{ _mm256_abs_epi32(_mm256_sub_epi32(
+      _mm256_add_epi32(_mm256_set1_epi32(cell % k.pitch), _mm256_loadu_si256((const __m256i*)k.dx)),
+      _mm256_set1_epi32(k.goalX))) };
+    const auto dy{ _mm256_abs_epi32(_mm256_sub_epi32(
+      _mm256_add_epi32(_mm256_set1_epi32(cell / k.pitch), _mm256_loadu_si256((const __m256i*)k.dy)),
+      _mm256_set1_epi32(k.goalY))) };
+    auto estimate{ _mm256_mullo_epi32(_mm256_add_epi32(dx, dy), _mm256_set1_epi32(10)) };
+    if (ESTIMATE_OCTAGONAL == k.estimate)
+        estimate = _mm256_sub_epi32(
+          estimate, _mm256_mullo_epi32(_mm256_min_epi32(dx, dy), _mm256_set1_epi32(6)));
+    else if (ESTIMATE_MANHATTAN != k.estimate)
+        estimate = _mm256_setzero_si256();
+
+    _mm256_store_si256((__m256i*)lanes, next);
+    _mm256_store_si256((__m256i*)costs, cost);
+    _mm256_store_si256((__m256i*)estimates, estimate);
+    return _compress(mask, lanes, costs, estimates, cells, g, h);
+}
+#endif
+
+/*****************************************************************************/
+template<typename T>
+Expander<T>::Expander(uint dirs, Estimate estimate, Isa isa) noexcept
+  : _dirs{ 4 == dirs ? 4u : 8u }
+  , _estimate{ estimate }
+  , _isa{ std::min(isa, best()) }
+{
+    _kernel.estimate = MANHATTAN == estimate   ? ESTIMATE_MANHATTAN
+                       : OCTAGONAL == estimate ? ESTIMATE_OCTAGONAL
+                                               : 0;
+    for (uint i{ 0 }; i < _dirs; ++i) {
+        _kernel.costs[i] = moveCost(i);
+        _kernel.dx[i] = MOVES[i].first;
+        _kernel.dy[i] = MOVES[i].second;
+    }
+}
+
+/*****************************************************************************/
+template<typename T>
+typename Expander<T>::Isa
+Expander<T>::best(void) noexcept
+{
+#ifdef PATH_FINDER_X86
+    static const Isa ret{ __builtin_cpu_supports("avx2")     ? AVX2
+                          : __builtin_cpu_supports("sse4.1") ? SSE4
+                                                             : SCALAR };
+    return ret;
+#else
+    return SCALAR;
+#endif
+}
+
+/*****************************************************************************/
+template<typename T>
+const char*
+Expander<T>::name(Isa isa) noexcept
+{
+    switch (isa) {
+        case AVX2:
+            return "avx2";
+        case SSE4:
+            return "sse4";
+        default:
+            return "scalar";
+    }
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+Expander<T>::begin(const Graph<T>* graph, const T* goal) noexcept
+{
+    std::vector<size_t> edits;
+    if (graph != _graph || graph->getWidth() != _width || graph->getHeight() != _height ||
+        !graph->editsSince(_version, edits)) {
+        _graph = graph;
+        _version = graph->version();
+        _width = graph->getWidth();
+        _height = graph->getHeight();
+        _pitch = _width + 2;
+
+        const auto size{ _pitch * (_height + 2) };
+        _blocked.assign(size + 3, WALL);
+        _g.assign(size, UNREACHED);
+        _touched.clear();
+        for (size_t j{ 0 }; j < _height; ++j)
+            for (size_t i{ 0 }; i < _width; ++i)
+                _blocked[(j + 1) * _pitch + i + 1] = graph->cell(i, j)->hasState(ICell::WALL);
+
+        _kernel.blocked = _blocked.data();
+        _kernel.g = _g.data();
+        _kernel.pitch = static_cast<uint32_t>(_pitch);
+        for (uint i{ 0 }; i < _dirs; ++i)
+            _kernel.offsets[i] = MOVES[i].first + MOVES[i].second * static_cast<int32_t>(_pitch);
+    } else if (!edits.empty()) {
+        // Only the edited cells changed : the closed flags are cleared below
+        _version = graph->version();
+        for (auto idx : edits) {
+            const size_t i{ idx % _width }, j{ idx / _width };
+            auto&        blocked{ _blocked[(j + 1) * _pitch + i + 1] };
+            blocked = (blocked & ~WALL) | graph->cell(i, j)->hasState(ICell::WALL);
+        }
+    }
+
+    for (auto cell : _touched) {
+        _g[cell] = UNREACHED;
+        _blocked[cell] &= ~CLOSED;
+    }
+    _touched.clear();
+
+    _kernel.goalX = goal->x() + 1;
+    _kernel.goalY = goal->y() + 1;
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+Expander<T>::seed(uint32_t cell) noexcept
+{
+    _g[cell] = 0;
+    _touched.push_back(cell);
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+Expander<T>::expand(uint32_t cell, Batch& out) noexcept
+{
+    _blocked[cell] |= CLOSED;
+
+    switch (_isa) {
+#ifdef PATH_FINDER_X86
+        case AVX2:
+            out.count = _expandAvx2(_kernel, cell, out.cells, out.g, out.h);
+            break;
+        case SSE4:
+            out.count = _expandSse4(_kernel, cell, out.cells, out.g, out.h);
+            break;
+#endif
+        default:
+            out.count = _expandScalar(_kernel, cell, out.cells, out.g, out.h);
+            break;
+    }
+
+    for (uint k{ 0 }; k < out.count; ++k) {
+        _g[out.cells[k]] = out.g[k];
+        _touched.push_back(out.cells[k]);
+    }
+}
+
+/*****************************************************************************/
+template<typename T>
+uint32_t
+Expander<T>::index(const T* c) const noexcept
+{
+    return static_cast<uint32_t>((c->y() + 1) * _pitch + c->x() + 1);
+}
+
+/*****************************************************************************/
+template<typename T>
+T*
+Expander<T>::cell(uint32_t idx) const noexcept
+{
+    return _graph->cell(idx % _pitch - 1, idx / _pitch - 1);
+}
+
+template class Expander<AStarCell>;
+}
@@ -0,0 +1,143 @@
+/**
+ * @file expand.hpp
+ * @brief Batch expansion of the neighbours of a cell, vectorized when possible
+ * @author lhm
+ */
+
+#ifndef SRC_ALGO_EXPAND_HPP
+#define SRC_ALGO_EXPAND_HPP
+
+// Standard headers
+#include <cstdint>
+#include <vector>
+
+// Project's headers
+#include <env/graph.hpp>
+
+namespace astar {
+
+/*****************************************************************************/
+/*!
+ * \brief What the expansion kernels read : the search arrays, and the moves
+ * as offsets in the padded grid. Lanes past \a dirs stay on the expanded
+ * cell, which is closed.
+ */
+struct ExpandKernel
+{
+    const uint8_t*  blocked{ nullptr };
+    const uint32_t* g{ nullptr };
+    int32_t         offsets[8]{};
+    int32_t         costs[8]{};
+    int32_t         dx[8]{};
+    int32_t         dy[8]{};
+    uint32_t        pitch{ 0 };
+    int32_t         goalX{ 0 };
+    int32_t         goalY{ 0 };
+    int             estimate{ 0 };
+};
+
+/*****************************************************************************/
+/*!
+ * \brief The Expander class holds the state of an A* search in flat arrays,
+ * and expands the neighbours of a cell all at once.
+ *
+ * Cells are numbered in a grid padded by one blocked cell on every side, so
+ * that the neighbours of any cell are at fixed offsets without bounds checks.
+ * A batch gathers the blocked (wall or closed) flags and the costs of the
+ * neighbours, computes their tentative costs and, for the manhattan and
+ * octagonal heuristics, their estimates, and keeps the improved neighbours
+ * only. The kernel uses AVX2 (8 neighbours per instruction), SSE4.1 (4) or
+ * plain C++, chosen at runtime from what the CPU supports.
+ *
+ * The walls follow the journal of the graph, read again entirely only when it
+ * is lost or the graph is resized, and only the cells reached by a search are
+ * reset before the next one.
+ */
+template<typename T>
+class Expander
+{
+public:
+    enum Isa
+    {
+        SCALAR,
+        SSE4,
+        AVX2
+    };
+
+    enum Estimate
+    {
+        NONE, //!< Heuristic computed by the caller, \a Batch::h is 0
+        MANHATTAN,
+        OCTAGONAL
+    };
+
+    static constexpr uint32_t UNREACHED{ 0x7FFFFFFF };
+
+    /*!
+     * \brief Neighbours improved by the latest expansion.
+     */
+    struct Batch
+    {
+        uint32_t cells[8];
+        uint32_t g[8];
+        uint32_t h[8];
+        uint     count{ 0 };
+    };
+
+public:
+    Expander(uint dirs = 8, Estimate estimate = NONE, Isa isa = best()) noexcept;
+    virtual ~Expander() noexcept = default;
+
+    /*!
+     * \brief Most efficient kernel supported by the CPU, and its name.
+     */
+    static Isa         best(void) noexcept;
+    static const char* name(Isa) noexcept;
+
+    Isa      isa(void) const noexcept { return _isa; }
+    Estimate estimate(void) const noexcept { return _estimate; }
+
+    /*!
+     * \brief Apply the walls edited in \a graph since the last call, and
+     * forget the previous search.
+     */
+    void begin(const env::Graph<T>* graph, const T* goal) noexcept;
+
+    void seed(uint32_t cell) noexcept;
+    void expand(uint32_t cell, Batch& out) noexcept;
+
+    uint32_t index(const T*) const noexcept;
+    T*       cell(uint32_t) const noexcept;
+    uint32_t g(uint32_t cell) const noexcept { return _g[cell]; }
+    bool     closed(uint32_t cell) const noexcept { return _blocked[cell] & CLOSED; }
+
+    /*!
+     * \brief Cells reached by the current search, in the order they were
+     * reached. Cells reached again at a lower cost come again.
+     */
+    const std::vector<uint32_t>& touched(void) const noexcept { return _touched; }
+    bool                         begun(void) const noexcept { return nullptr != _graph; }
+
+protected:
+    static constexpr uint8_t WALL{ 1 << 0 };
+    static constexpr uint8_t CLOSED{ 1 << 1 };
+
+private:
+    uint     _dirs;
+    Estimate _estimate;
+    Isa      _isa;
+
+    const env::Graph<T>* _graph{ nullptr };
+    uint64_t             _version{ 0 };
+    size_t               _width{ 0 };
+    size_t               _height{ 0 };
+    size_t               _pitch{ 0 }; // Width of the padded grid
+
+    std::vector<uint8_t>  _blocked; // Padded with 3 bytes, read 4 at a time
+    std::vector<uint32_t> _g;
+    std::vector<uint32_t> _touched; // Cells to reset before the next search
+    ExpandKernel          _kernel;
+};
+}
+
+#endif // SRC_ALGO_EXPAND_HPP
@@ -0,0 +1,244 @@
+/**
+ * @file flowfield.cpp
+ * @brief Implementation of \a flowfield.hpp
+ * @author lhm
+ */
+
+// Standard headers
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <thread>
+
+// Project's headers
+#include "distance.hpp"
+#include "flowfield.hpp"
+#include "moves.hpp"
+#include <utils/Memory.hpp>
+#include <utils/Trace.hpp>
+
+using namespace env;
+
+namespace astar {
+
+/*****************************************************************************/
+template<typename T>
+FlowField<T>::FlowField(uint dirs, uint threads) noexcept
+  : _dirs{ dirs }
+  , _threads{ std::max(threads, 1u) }
+{}
+
+/*****************************************************************************/
+template<typename T>
+void
+FlowField<T>::compute(const Graph<T>* graph, const T* goal) noexcept
+{
+    TRACE_SCOPE("FlowField::compute");
+    MEMORY_SCOPE(memory::SEARCH);
+    _graph = graph;
+    _goal = goal;
+    if (nullptr == _graph)
+        return;
+
+    _version = _graph->version();
+    distances(*_graph, _goal, _dirs, _dist, _threads);
+
+    _max = 0;
+    for (auto d : _dist)
+        if (UNREACHABLE != d)
+            _max = std::max(_max, d);
+
+    // Directions only read the distances : split the rows among the threads
+    const auto size{ std::size(_dist) };
+    const auto band{ (_graph->getHeight() + _threads - 1) / _threads * _graph->getWidth() };
+
+    _next.assign(size, NO_MOVE);
+    std::vector<std::thread> workers;
+    for (size_t first{ band }; first < size; first += band)
+        workers.emplace_back(&FlowField<T>::_directions, this, first, std::min(size, first + band));
+    _directions(0, std::min(size, band));
+
+    for (auto& w : workers)
+        w.join();
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+FlowField<T>::update(void) noexcept
+{
+    if (nullptr == _graph || _graph->version() == _version)
+        return;
+
+    std::vector<size_t> edits;
+    if (nullptr == _goal || _goal->hasState(ICell::WALL) || !_graph->editsSince(_version, edits)) {
+        compute(_graph, _goal);
+        return;
+    }
+
+    _repair(edits);
+    _version = _graph->version();
+}
+
+/*****************************************************************************/
+template<typename T>
+T*
+FlowField<T>::next(const T* c) const noexcept
+{
+    if (nullptr == _graph || nullptr == c)
+        return nullptr;
+
+    auto move{ _next[_graph->index(c)] };
+    if (NO_MOVE == move)
+        return nullptr;
+
+    return _graph->cell(c->x() + MOVES[move].first, c->y() + MOVES[move].second);
+}
+
+/*****************************************************************************/
+template<typename T>
+uint
+FlowField<T>::distance(const T* c) const noexcept
+{
+    return (nullptr == _graph || nullptr == c) ? UNREACHABLE : _dist[_graph->index(c)];
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+FlowField<T>::_directions(size_t first, size_t last) noexcept
+{
+    for (auto idx{ first }; idx < last; ++idx)
+        _direction(idx);
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+FlowField<T>::_direction(size_t idx) noexcept
+{
+    const auto width{ _graph->getWidth() };
+
+    _next[idx] = NO_MOVE;
+    if (UNREACHABLE == _dist[idx] || 0 == _dist[idx])
+        return;
+
+    // First move leading to a neighbour on a shortest path, straight ones first
+    for (uint i{ 0 }; i < _dirs; ++i) {
+        auto neigh{ _graph->cell(idx % width + MOVES[i].first, idx / width + MOVES[i].second) };
+        if (nullptr == neigh)
+            continue;
+
+        if (auto d{ _dist[_graph->index(neigh)] };
+            UNREACHABLE != d && d + moveCost(i) == _dist[idx]) {
+            _next[idx] = static_cast<uint8_t>(i);
+            return;
+        }
+    }
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+FlowField<T>::_repair(const std::vector<size_t>& edits) noexcept
+{
+    const auto width{ _graph->getWidth() };
+
+    using Entry = std::pair<uint, size_t>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    std::vector<size_t>                                                 changed;
+
+    auto neighbour = [&](size_t idx, uint i) {
+        return _graph->cell(idx % width + MOVES[i].first, idx / width + MOVES[i].second);
+    };
+
+    // Lowest cost from the (up to date) neighbours of a cell
+    auto reseed = [&](size_t idx) {
+        uint best{ UNREACHABLE };
+        for (uint i{ 0 }; i < _dirs; ++i) {
+            auto neigh{ neighbour(idx, i) };
+            if (nullptr == neigh || neigh->hasState(ICell::WALL))
+                continue;
+            if (auto d{ _dist[_graph->index(neigh)] }; UNREACHABLE != d)
+                best = std::min(best, d + moveCost(i));
+        }
+        if (UNREACHABLE != best) {
+            _dist[idx] = best;
+            queue.emplace(best, idx);
+        }
+    };
+
+    std::vector<size_t> cells(edits);
+    std::sort(std::begin(cells), std::end(cells));
+    cells.erase(std::unique(std::begin(cells), std::end(cells)), std::end(cells));
+
+    // New walls : every cell whose flow went through one of them must be
+    // computed again.
+    std::vector<size_t> region;
+    for (auto idx : cells)
+        if (UNREACHABLE != _dist[idx] && _graph->cell(idx % width, idx / width)->hasState(ICell::WALL))
+            region.push_back(idx);
+
+    for (size_t k{ 0 }; k < std::size(region); ++k) {
+        auto idx{ region[k] };
+        for (uint i{ 0 }; i < _dirs; ++i) {
+            auto neigh{ neighbour(idx, i) };
+            if (nullptr == neigh)
+                continue;
+
+            auto nidx{ _graph->index(neigh) };
+            auto move{ _next[nidx] };
+            if (NO_MOVE != move && UNREACHABLE != _dist[nidx] &&
+                nidx + MOVES[move].first + MOVES[move].second * static_cast<int>(width) == idx) {
+                _next[nidx] = NO_MOVE;
+                region.push_back(nidx);
+            }
+        }
+        _dist[idx] = UNREACHABLE;
+        _next[idx] = NO_MOVE;
+    }
+
+    for (auto idx : region)
+        if (!_graph->cell(idx % width, idx / width)->hasState(ICell::WALL))
+            reseed(idx);
+
+    // Removed walls : they can only shorten paths
+    for (auto idx : cells)
+        if (UNREACHABLE == _dist[idx] && !_graph->cell(idx % width, idx / width)->hasState(ICell::WALL))
+            reseed(idx);
+
+    changed = region;
+    changed.insert(std::end(changed), std::begin(cells), std::end(cells));
+
+    while (!std::empty(queue)) {
+        auto [cost, idx] = queue.top();
+        queue.pop();
+        if (cost != _dist[idx])
+            continue;
+
+        _max = std::max(_max, cost);
+        for (uint i{ 0 }; i < _dirs; ++i) {
+            auto neigh{ neighbour(idx, i) };
+            if (nullptr == neigh || neigh->hasState(ICell::WALL))
+                continue;
+
+            auto nidx{ _graph->index(neigh) };
+            if (auto ncost{ cost + moveCost(i) }; ncost < _dist[nidx]) {
+                _dist[nidx] = ncost;
+                queue.emplace(ncost, nidx);
+                changed.push_back(nidx);
+            }
+        }
+    }
+
+    // The first move of a cell depends on its neighbours' distances
+    for (auto idx : changed) {
+        _direction(idx);
+        for (uint i{ 0 }; i < _dirs; ++i)
+            if (auto neigh{ neighbour(idx, i) }; nullptr != neigh)
+                _direction(_graph->index(neigh));
+    }
+}
+
+template class FlowField<AStarCell>;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file flowfield.hpp
+ * @brief Distance field rooted on a single goal, shared by many agents
+ * @author lhm
+ */
+
+#ifndef SRC_ALGO_FLOWFIELD_HPP
+#define SRC_ALGO_FLOWFIELD_HPP
+
+// Standard headers
+#include <cstdint>
+#include <vector>
+
+// Project's headers
+#include <env/graph.hpp>
+
+namespace astar {
+
+/*****************************************************************************/
+/*!
+ * \brief The FlowField class stores the cost from every cell of a graph to a
+ * goal, and the first move of a shortest path towards it.
+ *
+ * Once computed, any number of agents can read their next step in O(1)
+ * instead of running one search each. After walls were edited, \a update only
+ * repairs the cells whose distance changed.
+ */
+template<typename T>
+class FlowField
+{
+public:
+    FlowField(uint dirs = 8, uint threads = 1) noexcept;
+    virtual ~FlowField() noexcept = default;
+
+    /*!
+     * \brief Compute the whole field towards \a goal.
+     */
+    void compute(const env::Graph<T>* graph, const T* goal) noexcept;
+
+    /*!
+     * \brief Repair the field after walls were edited in the graph.
+     * Falls back to \a compute when the edits are not known anymore.
+     */
+    void update(void) noexcept;
+
+    /*!
+     * \brief Next cell to go to from \a c, nullptr at the goal or when the goal
+     * cannot be reached from \a c.
+     */
+    T* next(const T* c) const noexcept;
+
+    uint distance(const T* c) const noexcept;
+    uint maxDistance(void) const noexcept { return _max; }
+
+    const T* goal(void) const noexcept { return _goal; }
+    bool     valid(void) const noexcept { return nullptr != _graph; }
+
+protected:
+    void _directions(size_t first, size_t last) noexcept;
+    void _direction(size_t idx) noexcept;
+    void _repair(const std::vector<size_t>& edits) noexcept;
+
+private:
+    const env::Graph<T>* _graph{ nullptr };
+    const T*             _goal{ nullptr };
+    uint64_t             _version{ 0 };
+
+    uint _dirs;
+    uint _threads;
+    uint _max{ 0 };
+
+    std::vector<uint>    _dist;
+    std::vector<uint8_t> _next; // Index in MOVES, NO_MOVE if none
+};
+
+}
+
+#endif // SRC_ALGO_FLOWFIELD_HPP
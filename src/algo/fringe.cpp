@@ -0,0 +1,303 @@
+/**
+ * @file fringe.cpp
+ * @brief Implementation of \a fringe.hpp
+ * @author lhm
+ */
+
+// Standard headers
+#include <algorithm>
+#include <limits>
+
+// Project's headers
+#include "fringe.hpp"
+#include "moves.hpp"
+#include <utils/Memory.hpp>
+#include <utils/Trace.hpp>
+
+// External headers
+#include <JSON.hpp>
+
+using namespace env;
+
+namespace astar {
+
+constexpr uint     INFINITE{ std::numeric_limits<uint>::max() };
+constexpr uint64_t NO_PARENT{ std::numeric_limits<uint64_t>::max() };
+constexpr uint     DEFAULT_TABLE_BITS{ 20 }; // 16 MiB of transposition table
+constexpr uint     MAX_TABLE_BITS{ 32 };
+
+/*****************************************************************************/
+template<typename T>
+Fringe<T>::Fringe(bool ida) noexcept
+  : _idaMode{ ida }
+{}
+
+/*****************************************************************************/
+template<typename T>
+bool
+Fringe<T>::configure(const JSON::Object& conf) noexcept
+{
+    if (!Impl<T>::configure(conf))
+        return false;
+
+    // Rounded down to a power of 2, fewer than 2 entries disabling the table
+    _tableBits = DEFAULT_TABLE_BITS;
+    if (conf["transposition-table"] && conf["transposition-table"].isInt()) {
+        const auto entries{ std::max(0, conf["transposition-table"].asInt()) };
+        _tableBits = 0;
+        while (_tableBits < MAX_TABLE_BITS && (2ull << _tableBits) <= uint64_t(entries))
+            ++_tableBits;
+        if (entries < 2)
+            _tableBits = std::numeric_limits<uint>::max();
+    }
+    _table.clear();
+    _table.shrink_to_fit();
+    return true;
+}
+
+/*****************************************************************************/
+template<typename T>
+uint64_t
+Fringe<T>::signature(void) const noexcept
+{
+    return Impl<T>::signature() ^ std::hash<std::string>()(_idaMode ? "ida:" : "fringe:");
+}
+
+/*****************************************************************************/
+template<typename T>
+bool
+Fringe<T>::run(Graph<T>* world, T* start, T* end) noexcept
+{
+    TRACE_SCOPE(_idaMode ? "Ida::run" : "Fringe::run");
+    MEMORY_SCOPE(memory::SEARCH);
+
+    this->_world = world;
+    this->_path.clear();
+    this->_stats.reset();
+    if (nullptr == world || nullptr == start || nullptr == end)
+        return false;
+
+    SEARCH_STAT(Lap timer);
+
+    this->_components.update(world);
+    if (!this->_components.connected(start, end)) {
+        SEARCH_STAT(this->_stats.setupMs = timer.lap());
+        return false;
+    }
+    if (this->_landmarks)
+        this->_landmarks->update(world);
+    SEARCH_STAT(this->_stats.setupMs = timer.lap());
+
+    const bool found{ _idaMode ? _ida(start, end) : _fringe(start, end) };
+    SEARCH_STAT(this->_stats.searchMs = timer.lap());
+    if (!found)
+        return false;
+
+    SEARCH_STAT(this->_stats.cost = end->_G);
+    SEARCH_STAT(this->_stats.pathLength = std::size(this->_path));
+    SEARCH_STAT(this->_stats.pathMs = timer.lap());
+
+    return true;
+}
+
+/*****************************************************************************/
+/*!
+ * \brief Fringe search : cells whose score exceeds the threshold are skipped
+ * and kept for the next pass, children are visited right after their parent.
+ */
+template<typename T>
+bool
+Fringe<T>::_fringe(T* start, T* end) noexcept
+{
+    const auto startIdx{ static_cast<uint64_t>(this->_world->index(start)) };
+    const auto endIdx{ static_cast<uint64_t>(this->_world->index(end)) };
+
+    _nodes.clear();
+    _list.clear();
+    _nodes[startIdx] = { 0, this->_heuristic(start, end), NO_PARENT, _list.end(), true };
+    _nodes[startIdx].it = _list.insert(_list.end(), startIdx);
+    SEARCH_STAT(++this->_stats.generated);
+    SEARCH_STAT(++this->_stats.heuristicCalls);
+
+    // Bytes used by a reached cell and by a fringe entry, allocator overhead excluded
+    [[maybe_unused]] constexpr size_t NODE_BYTES{ sizeof(typename decltype(_nodes)::value_type) +
+                                                  2 * sizeof(void*) };
+    [[maybe_unused]] constexpr size_t ENTRY_BYTES{ sizeof(uint64_t) + 2 * sizeof(void*) };
+
+    uint threshold{ _nodes[startIdx].h };
+    bool found{ false };
+    while (!found && !std::empty(_list)) {
+        uint next{ INFINITE };
+        for (auto it{ std::begin(_list) }; it != std::end(_list);) {
+            auto& node{ _nodes[*it] };
+            if (node.g + node.h > threshold) {
+                next = std::min(next, node.g + node.h);
+                ++it;
+                continue;
+            }
+            if (endIdx == *it) {
+                found = true;
+                break;
+            }
+
+            SEARCH_STAT(++this->_stats.expanded);
+            auto cur{ _cell(*it) };
+            for (uint i{ this->_dirs }; i-- > 0;) {
+                auto neigh{ this->_world->neighbour(cur, MOVES[i].first, MOVES[i].second) };
+                if (!this->_eligible(neigh))
+                    continue;
+
+                const auto nidx{ static_cast<uint64_t>(this->_world->index(neigh)) };
+                const auto cost{ node.g + moveCost(i) };
+                auto       known{ _nodes.find(nidx) };
+                if (std::end(_nodes) != known) {
+                    if (cost >= known->second.g)
+                        continue;
+                    if (known->second.inFringe) {
+                        _list.erase(known->second.it);
+                    } else {
+                        SEARCH_STAT(++this->_stats.reopened);
+                    }
+                } else {
+                    const Node reached{
+                        INFINITE, this->_heuristic(neigh, end), NO_PARENT, std::end(_list), false
+                    };
+                    known = _nodes.emplace(nidx, reached).first;
+                    SEARCH_STAT(++this->_stats.heuristicCalls);
+                }
+
+                // Visited later in this pass, right after the current cell
+                auto& child{ known->second };
+                child.g = cost;
+                child.parent = *it;
+                child.it = _list.insert(std::next(it), nidx);
+                child.inFringe = true;
+                SEARCH_STAT(++this->_stats.generated);
+            }
+
+            node.inFringe = false;
+            it = _list.erase(it);
+            SEARCH_STAT(this->_stats.open(std::size(_list)));
+            SEARCH_STAT(this->_stats.memory(std::size(_nodes) * NODE_BYTES +
+                                            _nodes.bucket_count() * sizeof(void*) +
+                                            std::size(_list) * ENTRY_BYTES));
+        }
+        threshold = next;
+    }
+
+    if (found) {
+        end->_G = _nodes[endIdx].g;
+        for (auto idx{ endIdx }; NO_PARENT != idx; idx = _nodes[idx].parent)
+            this->_path.push_back(_cell(idx));
+        std::reverse(std::begin(this->_path), std::end(this->_path));
+    }
+
+    // The nodes go back to the pool, for the next search
+    _nodes.clear();
+    _list.clear();
+    return found;
+}
+
+/*****************************************************************************/
+/*!
+ * \brief IDA* : depth-first searches bounded by a score threshold, raised to
+ * the lowest score beyond it until the end is reached. The transposition table
+ * remembers the lowest cost each cell was reached at during the current
+ * iteration, colliding cells replacing each other.
+ */
+template<typename T>
+bool
+Fringe<T>::_ida(T* start, T* end) noexcept
+{
+    const auto endIdx{ static_cast<uint64_t>(this->_world->index(end)) };
+    const bool useTable{ _tableBits <= MAX_TABLE_BITS };
+    if (useTable && std::size(_table) != (size_t(1) << _tableBits))
+        _table.assign(size_t(1) << _tableBits, { 0, 0, 0 });
+
+    const auto slot = [this](uint64_t idx) -> Entry& {
+        return _table[(idx * 0x9E3779B97F4A7C15ull) >> (64 - _tableBits)];
+    };
+
+    uint threshold{ this->_heuristic(start, end) };
+    SEARCH_STAT(++this->_stats.heuristicCalls);
+    bool found{ false };
+    while (!found) {
+        // Table entries of the previous iterations no longer prune anything
+        if (0 == ++_iteration) {
+            std::fill(std::begin(_table), std::end(_table), Entry{ 0, 0, 0 });
+            _iteration = 1;
+        }
+
+        uint next{ INFINITE };
+        _stack.clear();
+        _stack.push_back({ static_cast<uint64_t>(this->_world->index(start)), 0, 0 });
+        SEARCH_STAT(++this->_stats.generated);
+
+        while (!std::empty(_stack)) {
+            SEARCH_STAT(this->_stats.open(std::size(_stack)));
+            const auto top{ _stack.back() };
+            if (endIdx == top.idx) {
+                found = true;
+                break;
+            }
+            if (top.dir >= this->_dirs) {
+                _stack.pop_back();
+                continue;
+            }
+            SEARCH_STAT(this->_stats.expanded += (0 == top.dir));
+            ++_stack.back().dir;
+
+            auto neigh{ this->_world->neighbour(
+              _cell(top.idx), MOVES[top.dir].first, MOVES[top.dir].second) };
+            if (!this->_eligible(neigh))
+                continue;
+
+            const auto nidx{ static_cast<uint64_t>(this->_world->index(neigh)) };
+            if (std::size(_stack) > 1 && _stack[std::size(_stack) - 2].idx == nidx)
+                continue;
+
+            const auto cost{ top.g + moveCost(top.dir) };
+            const auto score{ cost + this->_heuristic(neigh, end) };
+            SEARCH_STAT(++this->_stats.heuristicCalls);
+            if (score > threshold) {
+                next = std::min(next, score);
+                continue;
+            }
+
+            if (useTable) {
+                auto& entry{ slot(nidx) };
+                if (entry.iteration == _iteration && entry.idx == nidx && entry.g <= cost)
+                    continue;
+                entry = { nidx, cost, _iteration };
+            }
+            _stack.push_back({ nidx, cost, 0 });
+            SEARCH_STAT(++this->_stats.generated);
+        }
+        SEARCH_STAT(this->_stats.memory(std::size(_table) * sizeof(Entry) +
+                                        _stack.capacity() * sizeof(Frame)));
+
+        if (!found && INFINITE == next)
+            break;
+        threshold = next;
+    }
+
+    if (found) {
+        end->_G = _stack.back().g;
+        for (const auto& frame : _stack)
+            this->_path.push_back(_cell(frame.idx));
+    }
+    _stack = {};
+    return found;
+}
+
+/*****************************************************************************/
+template<typename T>
+T*
+Fringe<T>::_cell(uint64_t idx) const noexcept
+{
+    const auto width{ this->_world->getWidth() };
+    return this->_world->cell(idx % width, idx / width);
+}
+
+template class Fringe<AStarCell>;
+}
@@ -0,0 +1,88 @@
+/**
+ * @file fringe.hpp
+ * @brief Low-memory searches : Fringe search and IDA*
+ * @author lhm
+ */
+
+#ifndef SRC_ALGO_FRINGE_HPP
+#define SRC_ALGO_FRINGE_HPP
+
+// Standard headers
+#include <cstdint>
+#include <vector>
+
+// Project's headers
+#include <algo/astar.hpp>
+
+namespace astar {
+
+/*****************************************************************************/
+/*!
+ * \brief Searches without a priority queue, for worlds too large for the open
+ * and closed lists of A*.
+ *
+ * Fringe search visits a linked list of cells over and over, expanding those
+ * whose score does not exceed a threshold raised after each pass. Its memory
+ * only holds the reached cells.
+ *
+ * The IDA* variant runs depth-first searches of increasing score threshold.
+ * Its memory is the current branch plus a fixed-size transposition table
+ * ('transposition-table' entries) pruning the cells already reached at a lower
+ * cost, at the price of searching again the same cells at each threshold.
+ *
+ * Both return shortest paths, and report their peak memory in \a stats.
+ */
+template<typename T>
+class Fringe : public Impl<T>
+{
+public:
+    Fringe(bool ida = false) noexcept;
+    virtual ~Fringe() noexcept = default;
+
+    [[maybe_unused]] virtual bool configure(const JSON::Object&) noexcept override;
+    [[maybe_unused]] virtual bool run(env::Graph<T>*, T* start, T* end) noexcept override;
+
+    virtual uint64_t signature(void) const noexcept override;
+
+protected:
+    struct Node
+    {
+        uint                                 g;
+        uint                                 h;
+        uint64_t                             parent;
+        memory::PoolList<uint64_t>::iterator it; // Position in the fringe, if inFringe
+        bool                                 inFringe;
+    };
+
+    struct Frame
+    {
+        uint64_t idx;
+        uint     g;
+        uint     dir; // Next move to try
+    };
+
+    struct Entry
+    {
+        uint64_t idx;
+        uint     g;
+        uint     iteration;
+    };
+
+    bool _fringe(T* start, T* end) noexcept;
+    bool _ida(T* start, T* end) noexcept;
+    T*   _cell(uint64_t idx) const noexcept;
+
+private:
+    bool _idaMode;
+
+    memory::Pool                    _pool; // Nodes and entries, recycled from a run to the next
+    memory::PoolMap<uint64_t, Node> _nodes{ _pool };
+    memory::PoolList<uint64_t>      _list{ _pool };
+    std::vector<Frame>              _stack;
+    std::vector<Entry>              _table;
+    uint                            _tableBits{ 0 };
+    uint                            _iteration{ 0 };
+};
+}
+
+#endif // SRC_ALGO_FRINGE_HPP
@@ -0,0 +1,99 @@
+/**
+ * @file goals.cpp
+ * @brief Implementation of \a goals.hpp
+ * @author lhm
+ */
+
+// Standard headers
+#include <algorithm>
+#include <limits>
+
+// Project's headers
+#include "goals.hpp"
+#include "moves.hpp"
+
+using namespace env;
+
+namespace astar {
+
+/*****************************************************************************/
+template<typename T>
+GoalIndex<T>::GoalIndex(uint bucket) noexcept
+  : _bucket{ std::max(1u, bucket) }
+{}
+
+/*****************************************************************************/
+template<typename T>
+void
+GoalIndex<T>::assign(const std::vector<T*>& goals) noexcept
+{
+    _goals = goals;
+    _buckets.clear();
+    _cols = _rows = 0;
+    if (std::empty(goals))
+        return;
+
+    // Buckets only cover the bounding box of the goals
+    int64_t x1{ 0 }, y1{ 0 };
+    _x0 = _y0 = std::numeric_limits<int64_t>::max();
+    for (auto goal : goals) {
+        _x0 = std::min<int64_t>(_x0, goal->x());
+        _y0 = std::min<int64_t>(_y0, goal->y());
+        x1 = std::max<int64_t>(x1, goal->x());
+        y1 = std::max<int64_t>(y1, goal->y());
+    }
+    _cols = (x1 - _x0) / _bucket + 1;
+    _rows = (y1 - _y0) / _bucket + 1;
+    _buckets.resize(_cols * _rows);
+    for (auto goal : goals)
+        _buckets[((goal->y() - _y0) / _bucket) * _cols + (goal->x() - _x0) / _bucket].push_back(
+          goal);
+}
+
+/*****************************************************************************/
+template<typename T>
+uint
+GoalIndex<T>::estimate(T* c, const HeuristicFunction<T>& h, bool geometric) const noexcept
+{
+    uint best{ std::numeric_limits<uint>::max() };
+    if (!geometric || std::size(_goals) < 2) {
+        for (auto goal : _goals)
+            best = std::min(best, h(c, goal));
+        return best;
+    }
+
+    // Bucket of c, possibly outside of the bounding box
+    const auto floorDiv = [](int64_t a, int64_t b) { return a >= 0 ? a / b : (a - b + 1) / b; };
+    const auto cx{ floorDiv(static_cast<int64_t>(c->x()) - _x0, _bucket) };
+    const auto cy{ floorDiv(static_cast<int64_t>(c->y()) - _y0, _bucket) };
+    const auto last{ std::max({ cx, _cols - 1 - cx, cy, _rows - 1 - cy }) };
+
+    const auto visit = [&](int64_t bx, int64_t by) {
+        if (bx < 0 || by < 0 || bx >= _cols || by >= _rows)
+            return;
+        for (auto goal : _buckets[by * _cols + bx])
+            best = std::min(best, h(c, goal));
+    };
+
+    for (int64_t r{ 0 }; r <= last; ++r) {
+        // Goals of this ring are at least (r - 1) * bucket + 1 cells away
+        if (r > 0 && static_cast<uint64_t>(STRAIGHT_COST) * ((r - 1) * _bucket + 1) >= best)
+            break;
+        if (0 == r) {
+            visit(cx, cy);
+            continue;
+        }
+        for (auto bx{ cx - r }; bx <= cx + r; ++bx) {
+            visit(bx, cy - r);
+            visit(bx, cy + r);
+        }
+        for (auto by{ cy - r + 1 }; by < cy + r; ++by) {
+            visit(cx - r, by);
+            visit(cx + r, by);
+        }
+    }
+    return best;
+}
+
+template class GoalIndex<AStarCell>;
+}
@@ -0,0 +1,57 @@
+/**
+ * @file goals.hpp
+ * @brief Spatial index of the goals of a multi-target search
+ * @author lhm
+ */
+
+#ifndef SRC_ALGO_GOALS_HPP
+#define SRC_ALGO_GOALS_HPP
+
+// Standard headers
+#include <cstdint>
+#include <vector>
+
+// Project's headers
+#include <algo/astar.hpp>
+
+namespace astar {
+
+/*****************************************************************************/
+/*!
+ * \brief The GoalIndex class buckets goal cells on a coarse grid, to evaluate
+ * the lowest heuristic over all the goals without visiting each of them.
+ *
+ * Buckets are visited by rings of growing distance around the cell. When the
+ * heuristic is geometric (never below 10 times the largest coordinate
+ * difference, like manhattan, octagonal and euclidean), the rings stop as soon
+ * as they cannot hold a closer goal. Otherwise every goal is evaluated.
+ */
+template<typename T>
+class GoalIndex
+{
+public:
+    GoalIndex(uint bucket = 16) noexcept;
+    virtual ~GoalIndex() noexcept = default;
+
+    void assign(const std::vector<T*>& goals) noexcept;
+
+    /*!
+     * \brief Lowest value of \a h between \a c and the goals.
+     * \param geometric Whether \a h allows to skip the far buckets
+     */
+    uint estimate(T* c, const HeuristicFunction<T>& h, bool geometric) const noexcept;
+
+    size_t size(void) const noexcept { return std::size(_goals); }
+
+private:
+    uint                         _bucket;
+    int64_t                      _x0{ 0 };
+    int64_t                      _y0{ 0 };
+    int64_t                      _cols{ 0 };
+    int64_t                      _rows{ 0 };
+    std::vector<T*>              _goals;
+    std::vector<std::vector<T*>> _buckets; // Row-major, _cols * _rows
+};
+}
+
+#endif // SRC_ALGO_GOALS_HPP
@@ -0,0 +1,269 @@
+/**
+ * @file landmarks.cpp
+ * @brief Implementation of \a landmarks.hpp
+ * @author lhm
+ */
+
+// Standard headers
+#include <algorithm>
+#include <fstream>
+#include <queue>
+#include <thread>
+
+// Project's headers
+#include "distance.hpp"
+#include "landmarks.hpp"
+#include "moves.hpp"
+#include <utils/Trace.hpp>
+
+using namespace env;
+
+namespace astar {
+
+constexpr uint16_t TABLE_UNREACHABLE{ 0xFFFF };
+constexpr uint16_t TABLE_SATURATED{ 0xFFFE };
+constexpr uint32_t FILE_MAGIC{ 0x31544C41 }; // "ALT1"
+
+/*****************************************************************************/
+template<typename T>
+Landmarks<T>::Landmarks(uint count, uint dirs, const std::string& file) noexcept
+  : _count{ std::max(count, 1u) }
+  , _dirs{ dirs }
+  , _file{ file }
+{}
+
+/*****************************************************************************/
+template<typename T>
+void
+Landmarks<T>::update(const Graph<T>* graph) noexcept
+{
+    if (nullptr == graph || (graph == _graph && graph->version() == _version))
+        return;
+    TRACE_SCOPE("Landmarks::update");
+
+    _graph = graph;
+    _version = graph->version();
+    _key = _hash();
+
+    if (!std::empty(_file) && load(_file))
+        return;
+
+    _select();
+    _compute();
+
+    if (!std::empty(_file))
+        save(_file);
+}
+
+/*****************************************************************************/
+template<typename T>
+uint
+Landmarks<T>::estimate(const T* s, const T* d) const noexcept
+{
+    if (nullptr == _graph || std::empty(_tables))
+        return 0;
+
+    const uint16_t* from{ &_tables[_graph->index(s) * _count] };
+    const uint16_t* to{ &_tables[_graph->index(d) * _count] };
+
+    // d(s, d) >= |d(L, d) - d(L, s)|. Saturated values are lower than the
+    // real distance so they can only be used on the left of the subtraction.
+    uint ret{ 0 };
+    for (uint k{ 0 }; k < _count; ++k) {
+        const uint a{ to[k] }, b{ from[k] };
+        if (TABLE_UNREACHABLE == a || TABLE_UNREACHABLE == b)
+            continue;
+
+        if (a > b && b < TABLE_SATURATED)
+            ret = std::max(ret, a - b);
+        else if (b > a && a < TABLE_SATURATED)
+            ret = std::max(ret, b - a);
+    }
+    return ret;
+}
+
+/*****************************************************************************/
+template<typename T>
+bool
+Landmarks<T>::save(const std::string& file) const noexcept
+{
+    if (nullptr == _graph)
+        return false;
+
+    std::ofstream ofs(file, std::ios::binary | std::ios::trunc);
+    if (!ofs)
+        return false;
+
+    const uint32_t header[]{ FILE_MAGIC,
+                             static_cast<uint32_t>(_graph->getWidth()),
+                             static_cast<uint32_t>(_graph->getHeight()),
+                             _dirs,
+                             _count,
+                             static_cast<uint32_t>(std::size(_landmarks)) };
+    std::vector<uint64_t> landmarks(std::begin(_landmarks), std::end(_landmarks));
+
+    ofs.write(reinterpret_cast<const char*>(header), sizeof(header));
+    ofs.write(reinterpret_cast<const char*>(&_key), sizeof(_key));
+    ofs.write(reinterpret_cast<const char*>(landmarks.data()),
+              std::size(landmarks) * sizeof(uint64_t));
+    ofs.write(reinterpret_cast<const char*>(_tables.data()), std::size(_tables) * sizeof(uint16_t));
+
+    return static_cast<bool>(ofs);
+}
+
+/*****************************************************************************/
+template<typename T>
+bool
+Landmarks<T>::load(const std::string& file) noexcept
+{
+    if (nullptr == _graph)
+        return false;
+
+    std::ifstream ifs(file, std::ios::binary);
+    if (!ifs)
+        return false;
+
+    uint32_t header[6];
+    uint64_t key;
+    ifs.read(reinterpret_cast<char*>(header), sizeof(header));
+    ifs.read(reinterpret_cast<char*>(&key), sizeof(key));
+
+    // Only accept tables computed for this exact walls layout. Fewer landmarks
+    // than asked for are placed when the free cells run out, never more
+    if (!ifs || FILE_MAGIC != header[0] || _graph->getWidth() != header[1] ||
+        _graph->getHeight() != header[2] || _dirs != header[3] || _count != header[4] ||
+        header[5] > _count || _key != key)
+        return false;
+
+    const auto            size{ _graph->getWidth() * _graph->getHeight() };
+    std::vector<uint64_t> landmarks(header[5]);
+    std::vector<uint16_t> tables(size * _count);
+
+    ifs.read(reinterpret_cast<char*>(landmarks.data()), std::size(landmarks) * sizeof(uint64_t));
+    ifs.read(reinterpret_cast<char*>(tables.data()), std::size(tables) * sizeof(uint16_t));
+    if (!ifs || std::any_of(std::begin(landmarks), std::end(landmarks), [size](uint64_t idx) {
+            return idx >= size;
+        }))
+        return false;
+
+    _landmarks.assign(std::begin(landmarks), std::end(landmarks));
+    _tables = std::move(tables);
+    return true;
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+Landmarks<T>::_select(void) noexcept
+{
+    const auto width{ _graph->getWidth() };
+    const auto size{ width * _graph->getHeight() };
+
+    _landmarks.clear();
+
+    // Farthest-point selection, on hop counts : each new landmark is the cell
+    // the farthest away from the already selected ones. Cells out of reach of
+    // every landmark come first so that each connected area gets one.
+    std::vector<uint> closest(size, UNREACHABLE);
+    std::vector<uint> hops;
+    std::queue<size_t> queue;
+
+    auto bfs = [&](size_t from) {
+        hops.assign(size, UNREACHABLE);
+        hops[from] = 0;
+        queue.push(from);
+        while (!std::empty(queue)) {
+            auto idx{ queue.front() };
+            queue.pop();
+            for (uint i{ 0 }; i < _dirs; ++i) {
+                auto neigh{ _graph->cell(idx % width + MOVES[i].first,
+                                         idx / width + MOVES[i].second) };
+                if (nullptr == neigh || neigh->hasState(ICell::WALL))
+                    continue;
+                if (auto nidx{ _graph->index(neigh) }; UNREACHABLE == hops[nidx]) {
+                    hops[nidx] = hops[idx] + 1;
+                    queue.push(nidx);
+                }
+            }
+        }
+    };
+
+    auto farthest = [&](const std::vector<uint>& dist) {
+        size_t ret{ size };
+        for (size_t idx{ 0 }; idx < size; ++idx) {
+            if (_graph->cell(idx % width, idx / width)->hasState(ICell::WALL) || 0 == dist[idx])
+                continue;
+            if (size == ret || dist[idx] > dist[ret])
+                ret = idx;
+        }
+        return ret;
+    };
+
+    // Start from the cell the farthest away from an arbitrary free one
+    size_t seed{ 0 };
+    while (seed < size && _graph->cell(seed % width, seed / width)->hasState(ICell::WALL))
+        ++seed;
+    if (seed == size)
+        return;
+
+    bfs(seed);
+    for (auto next{ farthest(hops) }; size != next && std::size(_landmarks) < _count;
+         next = farthest(closest)) {
+        _landmarks.push_back(next);
+        bfs(next);
+        std::transform(std::begin(closest),
+                       std::end(closest),
+                       std::begin(hops),
+                       std::begin(closest),
+                       [](auto a, auto b) { return std::min(a, b); });
+    }
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+Landmarks<T>::_compute(void) noexcept
+{
+    const auto width{ _graph->getWidth() };
+    const auto size{ width * _graph->getHeight() };
+    const auto count{ std::size(_landmarks) };
+
+    _tables.assign(size * _count, TABLE_UNREACHABLE);
+    if (0 == count)
+        return;
+
+    // One exact distance table per landmark, spread over the available cores
+    auto work = [&](size_t first, size_t step) {
+        std::vector<uint> dist;
+        for (auto k{ first }; k < count; k += step) {
+            distances(*_graph, _graph->cell(_landmarks[k] % width, _landmarks[k] / width), _dirs, dist);
+            for (size_t idx{ 0 }; idx < size; ++idx) {
+                if (UNREACHABLE == dist[idx])
+                    continue;
+                _tables[idx * _count + k] =
+                  static_cast<uint16_t>(std::min<uint>(dist[idx], TABLE_SATURATED));
+            }
+        }
+    };
+
+    const size_t threads{ std::clamp<size_t>(std::thread::hardware_concurrency(), 1, count) };
+    std::vector<std::thread> workers;
+    for (size_t t{ 1 }; t < threads; ++t)
+        workers.emplace_back(work, t, threads);
+    work(0, threads);
+
+    for (auto& w : workers)
+        w.join();
+}
+
+/*****************************************************************************/
+template<typename T>
+uint64_t
+Landmarks<T>::_hash(void) const noexcept
+{
+    // The tables also depend on the allowed moves
+    return _graph->wallsHash() ^ (static_cast<uint64_t>(_dirs) << 56);
+}
+
+template class Landmarks<AStarCell>;
+}
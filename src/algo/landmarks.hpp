@@ -0,0 +1,76 @@
+/**
+ * @file landmarks.hpp
+ * @brief ALT (A*, Landmarks, Triangle inequality) heuristic
+ * @author lhm
+ */
+
+#ifndef SRC_ALGO_LANDMARKS_HPP
+#define SRC_ALGO_LANDMARKS_HPP
+
+// Standard headers
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Project's headers
+#include <env/graph.hpp>
+
+namespace astar {
+
+/*****************************************************************************/
+/*!
+ * \brief The Landmarks class stores the exact distances from a few landmark
+ * cells to every cell of a graph.
+ *
+ * For any landmark L, the triangle inequality gives
+ * d(s, t) >= d(L, t) - d(L, s), which is an admissible heuristic that takes
+ * the walls into account.
+ *
+ * Landmarks are picked by farthest-point selection and their tables are
+ * computed in parallel. The tables are refreshed lazily (see \a update) when
+ * the walls of the graph change, and can be persisted to a file.
+ */
+template<typename T>
+class Landmarks
+{
+public:
+    Landmarks(uint count, uint dirs, const std::string& file = {}) noexcept;
+    virtual ~Landmarks() noexcept = default;
+
+    /*!
+     * \brief Make the tables match the current state of \a graph.
+     * Does nothing unless the graph changed since the last call.
+     */
+    void update(const env::Graph<T>* graph) noexcept;
+
+    uint estimate(const T* s, const T* d) const noexcept;
+
+    [[maybe_unused]] bool save(const std::string& file) const noexcept;
+    [[maybe_unused]] bool load(const std::string& file) noexcept;
+
+    const std::vector<size_t>& landmarks(void) const noexcept { return _landmarks; }
+
+protected:
+    void     _select(void) noexcept;
+    void     _compute(void) noexcept;
+    uint64_t _hash(void) const noexcept;
+
+private:
+    const env::Graph<T>* _graph{ nullptr };
+    uint64_t             _version{ 0 };
+    uint64_t             _key{ 0 };
+
+    uint        _count;
+    uint        _dirs;
+    std::string _file;
+
+    std::vector<size_t> _landmarks;
+
+    // Distances are stored cell-major : the _count entries of a cell are
+    // contiguous so that an estimate only touches two cache lines.
+    std::vector<uint16_t> _tables;
+};
+
+}
+
+#endif // SRC_ALGO_LANDMARKS_HPP
@@ -0,0 +1,50 @@
+/**
+ * @file lineofsight.cpp
+ * @brief Implementation of \a lineofsight.hpp
+ * @author lhm
+ */
+
+// Standard headers
+#include <math.h>
+
+// Project's headers
+#include "lineofsight.hpp"
+#include "moves.hpp"
+
+using namespace env;
+
+namespace astar {
+
+/*****************************************************************************/
+uint
+distance(const ICell* a, const ICell* b) noexcept
+{
+    const double dx{ static_cast<double>(a->x()) - b->x() };
+    const double dy{ static_cast<double>(a->y()) - b->y() };
+    return static_cast<uint>(lround(STRAIGHT_COST * sqrt(dx * dx + dy * dy)));
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+smooth(const Graph<T>& graph, std::vector<T*>& path) noexcept
+{
+    if (std::size(path) < 3)
+        return;
+
+    size_t anchor{ 0 }, out{ 1 };
+    for (size_t i{ 2 }; i < std::size(path); ++i) {
+        if (lineOfSight(graph, path[anchor], path[i]))
+            continue;
+
+        // path[i - 1] is the farthest cell seen from the anchor
+        path[out] = path[i - 1];
+        anchor = out++;
+    }
+    path[out++] = path.back();
+    path.resize(out);
+}
+
+template void
+smooth<AStarCell>(const Graph<AStarCell>&, std::vector<AStarCell*>&) noexcept;
+}
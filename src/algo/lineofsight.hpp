@@ -0,0 +1,95 @@
+/**
+ * @file lineofsight.hpp
+ * @brief Grid line of sight, and any-angle paths utilities
+ * @author lhm
+ */
+
+#ifndef SRC_ALGO_LINEOFSIGHT_HPP
+#define SRC_ALGO_LINEOFSIGHT_HPP
+
+// Standard headers
+#include <cstdlib>
+#include <vector>
+
+// Project's headers
+#include <env/graph.hpp>
+
+namespace astar {
+
+/*****************************************************************************/
+/*!
+ * \brief Call \a visit on every cell crossed by the segment joining the
+ * centers of \a a and \a b (supercover : when the segment goes exactly through
+ * a corner, both cells sharing that corner are visited).
+ * Stops as soon as \a visit returns false.
+ * \return false if the traversal was stopped
+ */
+template<typename T, typename Visitor>
+bool
+supercover(const env::Graph<T>& graph, const T* a, const T* b, Visitor&& visit) noexcept
+{
+    int       x{ static_cast<int>(a->x()) }, y{ static_cast<int>(a->y()) };
+    const int dx{ std::abs(static_cast<int>(b->x()) - x) };
+    const int dy{ std::abs(static_cast<int>(b->y()) - y) };
+    const int sx{ (static_cast<int>(b->x()) > x) ? 1 : -1 };
+    const int sy{ (static_cast<int>(b->y()) > y) ? 1 : -1 };
+
+    // Error term of Bresenham, doubled to stay on integers
+    int error{ dx - dy };
+    for (int n{ dx + dy }; ; --n) {
+        if (!visit(graph.cell(x, y)))
+            return false;
+        if (n <= 0)
+            break;
+
+        if (error > 0) {
+            x += sx;
+            error -= 2 * dy;
+        } else if (error < 0) {
+            y += sy;
+            error += 2 * dx;
+        } else {
+            if (!visit(graph.cell(x + sx, y)) || !visit(graph.cell(x, y + sy)))
+                return false;
+            x += sx;
+            y += sy;
+            error += 2 * (dx - dy);
+            --n;
+        }
+    }
+    return true;
+}
+
+/*****************************************************************************/
+/*!
+ * \brief Check that the segment joining the centers of \a a and \a b does not
+ * cross any wall.
+ */
+template<typename T>
+bool
+lineOfSight(const env::Graph<T>& graph, const T* a, const T* b) noexcept
+{
+    return supercover(graph, a, b, [](const T* c) {
+        return nullptr != c && !c->hasState(env::ICell::WALL);
+    });
+}
+
+/*****************************************************************************/
+/*!
+ * \brief Any-angle distance between the centers of two cells, in the units of
+ * the moves costs.
+ */
+uint distance(const env::ICell* a, const env::ICell* b) noexcept;
+
+/*****************************************************************************/
+/*!
+ * \brief Remove the intermediate cells of \a path that can be skipped in a
+ * straight line (greedy string pulling). Only the turning points remain.
+ */
+template<typename T>
+void
+smooth(const env::Graph<T>& graph, std::vector<T*>& path) noexcept;
+
+}
+
+#endif // SRC_ALGO_LINEOFSIGHT_HPP
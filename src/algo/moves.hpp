@@ -0,0 +1,97 @@
+/**
+ * @file moves.hpp
+ * @brief Grid moves shared by the path-finding engines
+ * @author lhm
+ */
+
+#ifndef SRC_ALGO_MOVES_HPP
+#define SRC_ALGO_MOVES_HPP
+
+// Standard headers
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <utility>
+
+typedef unsigned int uint;
+
+namespace astar {
+
+/*****************************************************************************/
+/*!
+ * \brief The 8 grid moves : the 4 straight ones first, then the diagonals.
+ * Using only the first 4 entries forbids diagonal moves.
+ */
+constexpr std::array<std::pair<int, int>, 8> MOVES{ { { 0, 1 },
+                                                      { 1, 0 },
+                                                      { 0, -1 },
+                                                      { -1, 0 },
+                                                      { -1, -1 },
+                                                      { 1, 1 },
+                                                      { -1, 1 },
+                                                      { 1, -1 } } };
+
+constexpr uint STRAIGHT_COST{ 10 };
+constexpr uint DIAGONAL_COST{ 14 };
+
+/*****************************************************************************/
+constexpr uint
+moveCost(uint i) noexcept
+{
+    return (i < 4) ? STRAIGHT_COST : DIAGONAL_COST;
+}
+
+/*****************************************************************************/
+/*!
+ * \brief Index in \a MOVES of the move by \a dx, \a dy, -1 if none.
+ */
+constexpr int
+moveIndex(int dx, int dy) noexcept
+{
+    for (uint i{ 0 }; i < std::size(MOVES); ++i)
+        if (MOVES[i].first == dx && MOVES[i].second == dy)
+            return static_cast<int>(i);
+    return -1;
+}
+
+/*****************************************************************************/
+/*!
+ * \brief Cost of the cheapest walk over \a dx, \a dy cells without walls with
+ * \a dirs moves : octile distance, manhattan distance with 4 moves.
+ */
+constexpr uint
+octile(uint dx, uint dy, uint dirs = 8) noexcept
+{
+    if (4 == dirs)
+        return STRAIGHT_COST * (dx + dy);
+    return STRAIGHT_COST * (dx + dy) - (2 * STRAIGHT_COST - DIAGONAL_COST) * std::min(dx, dy);
+}
+
+/*****************************************************************************/
+/*!
+ * \brief Walk from (\a x, \a y) to (\a tx, \a ty) as if there were no walls :
+ * diagonal moves first, then straight ones (with 4 \a dirs, along x first), so
+ * the cells stay in the rectangle between both ends. \a visit is called with
+ * the coordinates of every cell after the first one and its cost, the walk
+ * starting at \a cost.
+ * \return The cost at (\a tx, \a ty)
+ */
+template<typename Visit>
+uint
+walk(int64_t x, int64_t y, int64_t tx, int64_t ty, uint dirs, uint cost, Visit&& visit) noexcept
+{
+    while (x != tx || y != ty) {
+        int64_t dx{ (tx > x) - (tx < x) }, dy{ (ty > y) - (ty < y) };
+        if (4 == dirs && 0 != dx)
+            dy = 0;
+        x += dx;
+        y += dy;
+        cost += (0 != dx && 0 != dy) ? DIAGONAL_COST : STRAIGHT_COST;
+        visit(x, y, cost);
+    }
+    return cost;
+}
+
+}
+
+#endif // SRC_ALGO_MOVES_HPP
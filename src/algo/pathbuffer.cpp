@@ -0,0 +1,61 @@
+/**
+ * @file pathbuffer.cpp
+ * @brief Implementation of \a pathbuffer.hpp
+ * @author lhm
+ */
+
+// Project's headers
+#include "pathbuffer.hpp"
+
+using namespace env;
+
+namespace astar {
+
+/*****************************************************************************/
+template<typename T>
+void
+PathBuffer::assign(const Graph<T>& graph, const std::vector<T*>& path) noexcept
+{
+    clear();
+    if (std::empty(path))
+        return;
+
+    _width = static_cast<uint32_t>(graph.getWidth());
+    _first = static_cast<uint32_t>(graph.index(path.front()));
+    _size = std::size(path);
+
+    auto move = [&path](size_t k) {
+        return moveIndex(int(path[k]->x()) - int(path[k - 1]->x()),
+                         int(path[k]->y()) - int(path[k - 1]->y()));
+    };
+    for (size_t k{ 1 }; k < std::size(path) && _contiguous; ++k)
+        _contiguous = move(k) >= 0;
+
+    if (RUNS != _encoding || !_contiguous || 1 == _size) {
+        for (auto c : path)
+            _indices.push_back(static_cast<uint32_t>(graph.index(c)));
+        return;
+    }
+
+    for (size_t k{ 1 }; k < std::size(path); ++k) {
+        const auto m{ static_cast<uint8_t>(move(k)) };
+        if (!std::empty(_runs) && m == (_runs.back() & 7) && (_runs.back() >> 3) < MAX_RUN - 1)
+            _runs.back() += 1 << 3;
+        else
+            _runs.push_back(m);
+    }
+}
+
+/*****************************************************************************/
+void
+PathBuffer::clear(void) noexcept
+{
+    _contiguous = true;
+    _size = 0;
+    _indices.clear();
+    _runs.clear();
+}
+
+template void PathBuffer::assign<AStarCell>(const Graph<AStarCell>&,
+                                            const std::vector<AStarCell*>&) noexcept;
+}
@@ -0,0 +1,126 @@
+/**
+ * @file pathbuffer.hpp
+ * @brief Compact storage of a path, read without decoding it first
+ * @author lhm
+ */
+
+#ifndef SRC_ALGO_PATHBUFFER_HPP
+#define SRC_ALGO_PATHBUFFER_HPP
+
+// Standard headers
+#include <cstdint>
+#include <vector>
+
+// Project's headers
+#include <algo/moves.hpp>
+#include <env/graph.hpp>
+
+namespace astar {
+
+/*****************************************************************************/
+/*!
+ * \brief The PathBuffer class holds a path as the indices of its cells
+ * (x + y * width, 32 bits each), or as its first cell and its moves.
+ *
+ * Moves are run-length encoded, one byte per run : the index of the move in
+ * \a MOVES (3 bits) and the length of the run minus one (5 bits). Straight
+ * paths take a byte per 32 cells. Paths with steps other than single moves
+ * (any-angle or smoothed ones) are kept as indices whatever the encoding.
+ *
+ * Buffers are reused from a path to the next without allocating once they
+ * grew, and are read in place by \a forEach and \a forEachMove.
+ */
+class PathBuffer
+{
+public:
+    enum Encoding : uint8_t
+    {
+        INDICES,
+        RUNS //!< Runs of moves
+    };
+
+    static constexpr uint MAX_RUN{ 32 };
+
+public:
+    PathBuffer(Encoding encoding = INDICES) noexcept
+      : _encoding{ encoding }
+    {}
+
+    template<typename T>
+    void assign(const env::Graph<T>&, const std::vector<T*>& path) noexcept;
+    void clear(void) noexcept;
+
+    /*!
+     * \brief Encoding of the path held, which is \a INDICES for the paths
+     * that are not made of single moves.
+     */
+    Encoding encoding(void) const noexcept { return std::empty(_runs) ? INDICES : RUNS; }
+    bool     contiguous(void) const noexcept { return _contiguous; }
+
+    size_t size(void) const noexcept { return _size; }
+    bool   empty(void) const noexcept { return 0 == _size; }
+    size_t bytes(void) const noexcept { return 4 * std::size(_indices) + std::size(_runs); }
+
+    const std::vector<uint32_t>& indices(void) const noexcept { return _indices; }
+    const std::vector<uint8_t>&  runs(void) const noexcept { return _runs; }
+
+    /*!
+     * \brief Call \a fn with the index of every cell of the path, in order.
+     */
+    template<typename Fn>
+    void forEach(Fn&& fn) const noexcept
+    {
+        if (std::empty(_runs)) {
+            for (auto idx : _indices)
+                fn(idx);
+            return;
+        }
+
+        auto idx{ _first };
+        fn(idx);
+        for (auto run : _runs)
+            for (uint k{ 0 }; k <= (run >> 3); ++k) {
+                const auto& [dx, dy]{ MOVES[run & 7] };
+                idx += dx + dy * static_cast<int64_t>(_width);
+                fn(idx);
+            }
+    }
+
+    /*!
+     * \brief Call \a fn with the index in \a MOVES of every move of the path,
+     * in order. Nothing is called for the paths which are not contiguous.
+     */
+    template<typename Fn>
+    void forEachMove(Fn&& fn) const noexcept
+    {
+        if (!_contiguous)
+            return;
+
+        if (!std::empty(_runs)) {
+            for (auto run : _runs)
+                for (uint k{ 0 }; k <= (run >> 3); ++k)
+                    fn(static_cast<uint>(run & 7));
+            return;
+        }
+
+        const int64_t width{ _width };
+        for (size_t k{ 1 }; k < std::size(_indices); ++k) {
+            const int64_t from{ _indices[k - 1] }, to{ _indices[k] };
+            fn(static_cast<uint>(
+              moveIndex(int(to % width - from % width), int(to / width - from / width))));
+        }
+    }
+
+private:
+    Encoding _encoding;
+    bool     _contiguous{ true };
+    uint32_t _width{ 0 };
+    uint32_t _first{ 0 };
+    size_t   _size{ 0 };
+
+    std::vector<uint32_t> _indices;
+    std::vector<uint8_t>  _runs;
+};
+}
+
+#endif // SRC_ALGO_PATHBUFFER_HPP
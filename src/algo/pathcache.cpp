@@ -0,0 +1,191 @@
+/**
+ * @file pathcache.cpp
+ * @brief Implementation of \a pathcache.hpp
+ * @author lhm
+ */
+
+// Standard headers
+#include <algorithm>
+#include <math.h>
+
+// Project's headers
+#include "lineofsight.hpp"
+#include "moves.hpp"
+#include "pathcache.hpp"
+
+using namespace env;
+
+namespace astar {
+
+/*****************************************************************************/
+template<typename T>
+PathCache<T>::PathCache(size_t capacity) noexcept
+  : _capacity{ capacity }
+{}
+
+/*****************************************************************************/
+template<typename T>
+void
+PathCache<T>::sync(const Graph<T>* graph) noexcept
+{
+    if (graph != _graph) {
+        clear();
+        _graph = graph;
+        _version = (nullptr == graph) ? 0 : graph->version();
+        return;
+    }
+
+    if (nullptr == _graph || _graph->version() == _version)
+        return;
+
+    std::vector<size_t> edits;
+    if (!_graph->editsSince(_version, edits)) {
+        _stats.invalidations += size();
+        clear();
+        _version = _graph->version();
+        return;
+    }
+
+    std::sort(std::begin(edits), std::end(edits));
+    edits.erase(std::unique(std::begin(edits), std::end(edits)), std::end(edits));
+
+    const auto width{ _graph->getWidth() };
+
+    // Lowest possible cost between two cells whatever the walls, even for
+    // any-angle paths
+    auto lowerBound = [width](size_t a, size_t b) {
+        const double dx{ static_cast<double>(a % width) - static_cast<double>(b % width) };
+        const double dy{ static_cast<double>(a / width) - static_cast<double>(b / width) };
+        return static_cast<uint>(STRAIGHT_COST * sqrt(dx * dx + dy * dy));
+    };
+
+    for (auto idx : edits) {
+        if (_graph->cell(idx % width, idx / width)->hasState(ICell::WALL)) {
+            auto found{ _crossing.find(idx) };
+            if (std::end(_crossing) == found)
+                continue;
+
+            auto keys{ found->second };
+            for (const auto& k : keys) {
+                _erase(_entries.at(k));
+                ++_stats.invalidations;
+            }
+            continue;
+        }
+
+        for (auto it{ std::begin(_lru) }; it != std::end(_lru);) {
+            const auto& [key, res] = *it;
+            auto cur{ it++ };
+            if (!res.found || lowerBound(key.start, idx) + lowerBound(idx, key.end) < res.cost) {
+                _erase(cur);
+                ++_stats.invalidations;
+            }
+        }
+    }
+
+    _version = _graph->version();
+}
+
+/*****************************************************************************/
+template<typename T>
+const typename PathCache<T>::Result*
+PathCache<T>::find(size_t start, size_t end, uint64_t signature) noexcept
+{
+    auto it{ _entries.find({ start, end, signature }) };
+    if (std::end(_entries) == it) {
+        ++_stats.misses;
+        return nullptr;
+    }
+
+    ++_stats.hits;
+    _lru.splice(std::begin(_lru), _lru, it->second);
+    return &it->second->second;
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+PathCache<T>::insert(size_t start, size_t end, uint64_t signature, Result result) noexcept
+{
+    if (0 == _capacity)
+        return;
+
+    Key key{ start, end, signature };
+    if (auto it{ _entries.find(key) }; std::end(_entries) != it)
+        _erase(it->second);
+
+    _cells(result);
+    for (auto idx : result.crossed)
+        _crossing[idx].push_back(key);
+
+    _lru.emplace_front(key, std::move(result));
+    _entries[key] = std::begin(_lru);
+
+    while (size() > _capacity) {
+        _erase(std::prev(std::end(_lru)));
+        ++_stats.evictions;
+    }
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+PathCache<T>::clear(void) noexcept
+{
+    _lru.clear();
+    _entries.clear();
+    _crossing.clear();
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+PathCache<T>::_erase(typename std::list<Entry>::iterator it) noexcept
+{
+    const auto& [key, res] = *it;
+
+    for (auto idx : res.crossed) {
+        auto& keys{ _crossing[idx] };
+        keys.erase(std::find(std::begin(keys), std::end(keys), key));
+        if (std::empty(keys))
+            _crossing.erase(idx);
+    }
+
+    _entries.erase(key);
+    _lru.erase(it);
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+PathCache<T>::_cells(Result& result) const noexcept
+{
+    result.crossed.clear();
+    if (nullptr == _graph)
+        return;
+
+    // Any-angle paths only hold their turning points : add the cells their
+    // segments go through.
+    const auto width{ _graph->getWidth() };
+    for (size_t k{ 0 }; k < std::size(result.path); ++k) {
+        if (0 == k) {
+            result.crossed.push_back(result.path[k]);
+            continue;
+        }
+
+        const T* from{ _graph->cell(result.path[k - 1] % width, result.path[k - 1] / width) };
+        const T* to{ _graph->cell(result.path[k] % width, result.path[k] / width) };
+        supercover(*_graph, from, to, [&](const T* c) {
+            if (nullptr != c && c != from)
+                result.crossed.push_back(_graph->index(c));
+            return true;
+        });
+    }
+
+    std::sort(std::begin(result.crossed), std::end(result.crossed));
+    result.crossed.erase(std::unique(std::begin(result.crossed), std::end(result.crossed)),
+                         std::end(result.crossed));
+}
+
+template class PathCache<AStarCell>;
+}
@@ -0,0 +1,110 @@
+/**
+ * @file pathcache.hpp
+ * @brief Cache of the latest search results
+ * @author lhm
+ */
+
+#ifndef SRC_ALGO_PATHCACHE_HPP
+#define SRC_ALGO_PATHCACHE_HPP
+
+// Standard headers
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+// Project's headers
+#include <env/graph.hpp>
+
+namespace astar {
+
+/*****************************************************************************/
+/*!
+ * \brief The PathCache class keeps the results of the latest searches, least
+ * recently used first out.
+ *
+ * Results are keyed by their endpoints and the signature of the engine that
+ * found them. They are valid for one version of the graph : \a sync moves them
+ * to the current one, only dropping the results that the edits may change.
+ * - A new wall drops the paths crossing it.
+ * - A removed wall drops the failed searches, and the paths that could be
+ *   shortened by going through it.
+ */
+template<typename T>
+class PathCache
+{
+public:
+    struct Result
+    {
+        bool                found{ false };
+        uint                cost{ 0 };
+        std::vector<size_t> path;    // Cells indexes, from start to end
+        std::vector<size_t> crossed; // Every cell the path goes through, sorted
+    };
+
+    struct Stats
+    {
+        uint64_t hits{ 0 };
+        uint64_t misses{ 0 };
+        uint64_t evictions{ 0 };
+        uint64_t invalidations{ 0 };
+    };
+
+public:
+    PathCache(size_t capacity = 256) noexcept;
+    virtual ~PathCache() noexcept = default;
+
+    /*!
+     * \brief Drop the results that edits of \a graph since the last call may
+     * change. Everything is dropped if these edits are not known anymore.
+     */
+    void sync(const env::Graph<T>* graph) noexcept;
+
+    const Result* find(size_t start, size_t end, uint64_t signature) noexcept;
+    void          insert(size_t start, size_t end, uint64_t signature, Result result) noexcept;
+    void          clear(void) noexcept;
+
+    const Stats& stats(void) const noexcept { return _stats; }
+    size_t       size(void) const noexcept { return std::size(_lru); }
+
+protected:
+    struct Key
+    {
+        size_t   start, end;
+        uint64_t signature;
+
+        bool operator==(const Key& o) const noexcept
+        {
+            return start == o.start && end == o.end && signature == o.signature;
+        }
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& k) const noexcept
+        {
+            return std::hash<uint64_t>()(k.signature) ^ (k.start * 0x9E3779B97F4A7C15ULL) ^
+                   (k.end << 1);
+        }
+    };
+
+    using Entry = std::pair<Key, Result>;
+
+    void _erase(typename std::list<Entry>::iterator it) noexcept;
+    void _cells(Result& result) const noexcept;
+
+private:
+    size_t _capacity;
+    Stats  _stats;
+
+    const env::Graph<T>* _graph{ nullptr };
+    uint64_t             _version{ 0 };
+
+    std::list<Entry>                                                      _lru; // Most recent first
+    std::unordered_map<Key, typename std::list<Entry>::iterator, KeyHash> _entries;
+    std::unordered_map<size_t, std::vector<Key>>                          _crossing;
+};
+
+}
+
+#endif // SRC_ALGO_PATHCACHE_HPP
@@ -0,0 +1,256 @@
+/**
+ * @file rsr.cpp
+ * @brief Implementation of \a rsr.hpp
+ * @author lhm
+ */
+
+// Standard headers
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <queue>
+#include <tuple>
+
+// Project's headers
+#include "moves.hpp"
+#include "rsr.hpp"
+#include <utils/Memory.hpp>
+#include <utils/Trace.hpp>
+
+using namespace env;
+
+namespace astar {
+
+constexpr uint64_t NO_PARENT{ std::numeric_limits<uint64_t>::max() };
+
+/*****************************************************************************/
+template<typename T>
+bool
+Rsr<T>::configure(const JSON::Object& conf) noexcept
+{
+    if (!Impl<T>::configure(conf))
+        return false;
+
+    _rectangles = Rectangles<T>();
+    return true;
+}
+
+/*****************************************************************************/
+template<typename T>
+uint64_t
+Rsr<T>::signature(void) const noexcept
+{
+    return Impl<T>::signature() ^ std::hash<std::string>()("rsr:");
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+Rsr<T>::refresh(const Graph<T>* graph) noexcept
+{
+    _rectangles.update(graph);
+}
+
+/*****************************************************************************/
+template<typename T>
+bool
+Rsr<T>::run(Graph<T>* world, T* start, T* end) noexcept
+{
+    TRACE_SCOPE("Rsr::run");
+    MEMORY_SCOPE(memory::SEARCH);
+
+    this->_world = world;
+    this->_path.clear();
+    this->_stats.reset();
+    if (nullptr == world || nullptr == start || nullptr == end)
+        return false;
+
+    SEARCH_STAT(Lap timer);
+
+    this->_components.update(world);
+    if (!this->_components.connected(start, end)) {
+        SEARCH_STAT(this->_stats.setupMs = timer.lap());
+        return false;
+    }
+    if (this->_landmarks)
+        this->_landmarks->update(world);
+    _rectangles.update(world);
+    SEARCH_STAT(this->_stats.setupMs = timer.lap());
+
+    const auto     width{ world->getWidth() };
+    const uint64_t startIdx{ world->index(start) };
+    const uint64_t endIdx{ world->index(end) };
+    const auto     goalRect{ _rectangles.id(endIdx) };
+    const auto     cell = [&](uint64_t idx) { return world->cell(idx % width, idx / width); };
+
+    // f, h (ties go closest to the goal first), cell
+    using Entry = std::tuple<uint, uint, uint64_t>;
+    this->_scratch.reset();
+    std::priority_queue<Entry, memory::ArenaVector<Entry>, std::greater<Entry>> open{
+        std::greater<Entry>(), memory::ArenaVector<Entry>(this->_scratch)
+    };
+
+    auto relax = [&](uint64_t from, uint64_t to, uint cost) {
+        const auto g{ _nodes[from].g + cost };
+        auto [it, added] = _nodes.try_emplace(to, Node{ g, from });
+        if (!added) {
+            if (g >= it->second.g)
+                return;
+            it->second = { g, from };
+        }
+        const auto h{ this->_heuristic(cell(to), end) };
+        open.emplace(g + h, h, to);
+        SEARCH_STAT(++this->_stats.generated);
+        SEARCH_STAT(++this->_stats.heuristicCalls);
+        SEARCH_STAT(this->_stats.open(std::size(open)));
+    };
+
+    // Border cells of a rectangle, each one once
+    auto border = [width](const typename Rectangles<T>::Rect& r, auto&& fn) {
+        for (auto x{ r.x0 }; x <= r.x1; ++x) {
+            fn(r.y0 * width + x);
+            if (r.y1 != r.y0)
+                fn(r.y1 * width + x);
+        }
+        for (auto y{ r.y0 + 1 }; y < r.y1; ++y) {
+            fn(y * width + r.x0);
+            if (r.x1 != r.x0)
+                fn(y * width + r.x1);
+        }
+    };
+
+    _nodes.clear();
+    _nodes[startIdx] = { 0, NO_PARENT };
+    const auto h0{ this->_heuristic(start, end) };
+    open.emplace(h0, h0, startIdx);
+    SEARCH_STAT(++this->_stats.generated);
+    SEARCH_STAT(++this->_stats.heuristicCalls);
+
+    bool found{ false };
+    while (!std::empty(open)) {
+        const auto [f, h, entry] = open.top();
+        const auto idx{ entry };
+        open.pop();
+
+        // Entries left behind by a cell reached again at a lower cost
+        if (_nodes[idx].g + h != f)
+            continue;
+        if (idx == endIdx) {
+            found = true;
+            break;
+        }
+        SEARCH_STAT(++this->_stats.expanded);
+
+        const auto  id{ _rectangles.id(idx) };
+        const auto& r{ _rectangles.rect(id) };
+        const auto  x{ idx % width };
+        const auto  y{ idx / width };
+
+        if (goalRect == id)
+            relax(idx, endIdx, _distance(idx, endIdx));
+
+        // Only the start can be inside a rectangle : it leaves through any
+        // cell of the borders
+        if (!_rectangles.perimeter(idx)) {
+            border(r, [&](uint64_t to) { relax(idx, to, _distance(idx, to)); });
+            continue;
+        }
+
+        // Neighbours along the borders, or in other rectangles
+        const auto cur{ cell(idx) };
+        for (uint i{ 0 }; i < this->_dirs; ++i) {
+            const auto next{ world->neighbour(cur, MOVES[i].first, MOVES[i].second) };
+            if (nullptr == next || next->hasState(ICell::WALL))
+                continue;
+
+            const uint64_t nidx{ world->index(next) };
+            if (_rectangles.id(nidx) != id || _rectangles.perimeter(nidx))
+                relax(idx, nidx, moveCost(i));
+        }
+
+        // Jumps across the rectangle. Cells sharing a border with this one are
+        // reached as cheaply along this border.
+        const bool left{ x == r.x0 }, right{ x == r.x1 }, top{ y == r.y0 }, bottom{ y == r.y1 };
+        if (4 == this->_dirs) {
+            if (left && !right)
+                relax(idx, y * width + r.x1, _distance(idx, y * width + r.x1));
+            if (right && !left)
+                relax(idx, y * width + r.x0, _distance(idx, y * width + r.x0));
+            if (top && !bottom)
+                relax(idx, r.y1 * width + x, _distance(idx, r.y1 * width + x));
+            if (bottom && !top)
+                relax(idx, r.y0 * width + x, _distance(idx, r.y0 * width + x));
+        } else {
+            border(r, [&](uint64_t to) {
+                const auto tx{ to % width }, ty{ to / width };
+                if (!((left && tx == r.x0) || (right && tx == r.x1) || (top && ty == r.y0) ||
+                      (bottom && ty == r.y1)))
+                    relax(idx, to, _distance(idx, to));
+            });
+        }
+    }
+    SEARCH_STAT(this->_stats.memory(std::size(_nodes) * (sizeof(Node) + sizeof(uint64_t))));
+    SEARCH_STAT(this->_stats.searchMs = timer.lap());
+
+    if (!found) {
+        _nodes.clear();
+        return false;
+    }
+
+    _unfold(startIdx, endIdx);
+    _nodes.clear();
+
+    SEARCH_STAT(this->_stats.cost = end->_G);
+    SEARCH_STAT(this->_stats.pathLength = std::size(this->_path));
+    SEARCH_STAT(this->_stats.pathMs = timer.lap());
+
+    return true;
+}
+
+/*****************************************************************************/
+template<typename T>
+uint
+Rsr<T>::_distance(uint64_t from, uint64_t to) const noexcept
+{
+    const auto width{ this->_world->getWidth() };
+    const auto dx{ static_cast<uint>(std::abs(int64_t(from % width) - int64_t(to % width))) };
+    const auto dy{ static_cast<uint>(std::abs(int64_t(from / width) - int64_t(to / width))) };
+    return octile(dx, dy, this->_dirs);
+}
+
+/*****************************************************************************/
+/*!
+ * \brief Fill \a _path with every cell between the jumps leading to \a end :
+ * diagonal moves first, then straight ones, all inside the rectangle jumped.
+ */
+template<typename T>
+void
+Rsr<T>::_unfold(uint64_t start, uint64_t end) noexcept
+{
+    const auto width{ this->_world->getWidth() };
+
+    memory::ArenaVector<uint64_t> jumps{ this->_scratch };
+    for (auto idx{ end }; NO_PARENT != idx; idx = _nodes[idx].parent)
+        jumps.push_back(idx);
+    std::reverse(std::begin(jumps), std::end(jumps));
+
+    auto first{ this->_world->cell(start % width, start / width) };
+    first->_G = 0;
+    this->_path.push_back(first);
+
+    auto visit = [this](int64_t x, int64_t y, uint cost) {
+        auto cur{ this->_world->cell(x, y) };
+        cur->_G = cost;
+        this->_path.push_back(cur);
+    };
+    uint64_t from{ start };
+    uint     cost{ 0 };
+    for (auto jump : jumps) {
+        const int64_t x(from % width), y(from / width), tx(jump % width), ty(jump / width);
+        cost = walk(x, y, tx, ty, this->_dirs, cost, visit);
+        from = jump;
+    }
+}
+
+template class Rsr<AStarCell>;
+}
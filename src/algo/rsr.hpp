@@ -0,0 +1,66 @@
+/**
+ * @file rsr.hpp
+ * @brief Rectangular symmetry reduction : A* over the borders of empty rectangles
+ * @author lhm
+ */
+
+#ifndef SRC_ALGO_RSR_HPP
+#define SRC_ALGO_RSR_HPP
+
+// Standard headers
+#include <cstdint>
+
+// Project's headers
+#include <algo/astar.hpp>
+#include <env/rectangles.hpp>
+
+namespace astar {
+
+/*****************************************************************************/
+/*!
+ * \brief The Rsr engine only searches the borders of the empty rectangles
+ * covering the free cells (see \a env::Rectangles).
+ *
+ * Inside an empty rectangle every shortest path between two cells costs their
+ * octile (or manhattan) distance, so the interior cells are skipped : a cell
+ * of a border leads to its neighbours on that border or in other rectangles,
+ * and jumps across its rectangle to the cells of the other borders. An
+ * interior start jumps to the borders of its rectangle, and every cell of the
+ * rectangle of the goal jumps to it. The paths stay optimal.
+ *
+ * The rectangles follow the walls edits through \a refresh, repairing only
+ * the rectangles around the edited cells.
+ */
+template<typename T>
+class Rsr : public Impl<T>
+{
+public:
+    Rsr() noexcept = default;
+    virtual ~Rsr() noexcept = default;
+
+    [[maybe_unused]] virtual bool configure(const JSON::Object&) noexcept override;
+    [[maybe_unused]] virtual bool run(env::Graph<T>*, T* start, T* end) noexcept override;
+
+    virtual uint64_t signature(void) const noexcept override;
+    virtual void     refresh(const env::Graph<T>*) noexcept override;
+
+    const env::Rectangles<T>& rectangles(void) const noexcept { return _rectangles; }
+
+protected:
+    struct Node
+    {
+        uint     g;
+        uint64_t parent;
+    };
+
+    uint _distance(uint64_t from, uint64_t to) const noexcept;
+    void _unfold(uint64_t start, uint64_t end) noexcept;
+
+private:
+    env::Rectangles<T>              _rectangles;
+    memory::Pool                    _pool;
+    memory::PoolMap<uint64_t, Node> _nodes{ _pool }; // Nodes recycled from a run to the next
+};
+}
+
+#endif // SRC_ALGO_RSR_HPP
@@ -0,0 +1,79 @@
+/**
+ * @file stats.hpp
+ * @brief Statistics of a search
+ * @author lhm
+ */
+
+#ifndef SRC_ALGO_STATS_HPP
+#define SRC_ALGO_STATS_HPP
+
+// Standard headers
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+typedef unsigned int uint;
+
+/*!
+ * Searches statistics are gathered unless PATH_FINDER_NO_STATS is defined :
+ * the counting statements are then compiled out and \a SearchStats stays zero.
+ */
+#ifndef PATH_FINDER_NO_STATS
+#define SEARCH_STAT(statement) statement
+#else
+#define SEARCH_STAT(statement)
+#endif
+
+namespace astar {
+
+/*****************************************************************************/
+/*!
+ * \brief What the latest search of an engine did, and how long it took.
+ */
+struct SearchStats
+{
+    uint64_t expanded{ 0 };       //!< Cells taken out of the open list
+    uint64_t generated{ 0 };      //!< Cells put in the open list (again, if improved)
+    uint64_t reopened{ 0 };       //!< Cells expanded more than once
+    uint64_t heuristicCalls{ 0 }; //!< Evaluations of the heuristic
+    size_t   peakOpen{ 0 };       //!< Largest size of the open list
+    size_t   peakBytes{ 0 };      //!< Largest memory of the search structures, if reported
+    size_t   pathLength{ 0 };     //!< Cells of the path found
+    uint     cost{ 0 };           //!< Cost of the path found
+
+    double setupMs{ 0 };  //!< Refresh of the derived data (components, tables...)
+    double searchMs{ 0 }; //!< Search itself
+    double pathMs{ 0 };   //!< Path extraction
+
+    double totalMs(void) const noexcept { return setupMs + searchMs + pathMs; }
+
+    void reset(void) noexcept { *this = SearchStats(); }
+    void open(size_t size) noexcept { peakOpen = size > peakOpen ? size : peakOpen; }
+    void memory(size_t bytes) noexcept { peakBytes = bytes > peakBytes ? bytes : peakBytes; }
+};
+
+/*****************************************************************************/
+/*!
+ * \brief Time spent between consecutive calls of \a lap, in milliseconds.
+ */
+class Lap
+{
+public:
+    Lap() noexcept
+      : _last{ std::chrono::steady_clock::now() }
+    {}
+
+    double lap(void) noexcept
+    {
+        const auto now{ std::chrono::steady_clock::now() };
+        const auto ret{ std::chrono::duration<double, std::milli>(now - _last).count() };
+        _last = now;
+        return ret;
+    }
+
+private:
+    std::chrono::steady_clock::time_point _last;
+};
+}
+
+#endif // SRC_ALGO_STATS_HPP
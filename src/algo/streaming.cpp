@@ -0,0 +1,150 @@
+/**
+ * @file streaming.cpp
+ * @brief Implementation of \a streaming.hpp
+ * @author lhm
+ */
+
+// Standard headers
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+
+// Project's headers
+#include "moves.hpp"
+#include "streaming.hpp"
+#include <utils/Memory.hpp>
+#include <utils/Trace.hpp>
+
+using namespace env;
+
+namespace astar {
+
+// Distance to a chunk border under which the next chunk is prefetched
+constexpr int64_t PREFETCH_MARGIN{ 32 };
+
+/*****************************************************************************/
+Streaming::Streaming(uint dirs, uint64_t maxExpansions) noexcept
+  : _dirs{ 4 == dirs ? 4u : 8u }
+  , _maxExpansions{ maxExpansions }
+{}
+
+/*****************************************************************************/
+bool
+Streaming::run(ChunkedWorld& world, Position start, Position end) noexcept
+{
+    TRACE_SCOPE("Streaming::run");
+    MEMORY_SCOPE(memory::SEARCH);
+
+    _path.clear();
+    _stats.reset();
+    _capped = false;
+    if (!world.passable(start.first, start.second) || !world.passable(end.first, end.second))
+        return false;
+
+    SEARCH_STAT(Lap timer);
+
+    struct Node
+    {
+        uint     g;
+        uint64_t parent;
+        bool     closed;
+    };
+
+    const uint64_t width{ world.getWidth() };
+    auto           key = [width](int64_t x, int64_t y) {
+        return static_cast<uint64_t>(y) * width + x;
+    };
+
+    using Entry = std::pair<uint, uint64_t>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+    std::unordered_map<uint64_t, Node>                                  nodes;
+
+    const auto startKey{ key(start.first, start.second) }, endKey{ key(end.first, end.second) };
+    nodes[startKey] = { 0, startKey, false };
+    open.emplace(_heuristic(start.first, start.second, end), startKey);
+    SEARCH_STAT(++_stats.generated);
+    SEARCH_STAT(++_stats.heuristicCalls);
+
+    bool     found{ false };
+    uint64_t expansions{ 0 };
+    while (!std::empty(open)) {
+        SEARCH_STAT(_stats.open(std::size(open)));
+        const auto [score, cur] = open.top();
+        open.pop();
+
+        auto& node{ nodes[cur] };
+        if (node.closed)
+            continue;
+        node.closed = true;
+        SEARCH_STAT(++_stats.expanded);
+
+        if (endKey == cur) {
+            found = true;
+            break;
+        }
+        if (0 != _maxExpansions && ++expansions > _maxExpansions) {
+            _capped = true;
+            break;
+        }
+
+        const int64_t x = cur % width, y = cur / width;
+        const uint    g{ node.g };
+
+        // Close to a chunk border : ask for the chunk on the way to the goal
+        const int64_t dx = (end.first > x) - (end.first < x);
+        const int64_t dy = (end.second > y) - (end.second < y);
+        const int64_t inX{ x % ChunkedWorld::CHUNK_SIDE }, inY{ y % ChunkedWorld::CHUNK_SIDE };
+        if ((dx > 0 && inX >= ChunkedWorld::CHUNK_SIDE - PREFETCH_MARGIN) ||
+            (dx < 0 && inX < PREFETCH_MARGIN) ||
+            (dy > 0 && inY >= ChunkedWorld::CHUNK_SIDE - PREFETCH_MARGIN) ||
+            (dy < 0 && inY < PREFETCH_MARGIN))
+            world.prefetch(x + dx * PREFETCH_MARGIN, y + dy * PREFETCH_MARGIN);
+
+        for (uint i{ 0 }; i < _dirs; ++i) {
+            const int64_t nx{ x + MOVES[i].first }, ny{ y + MOVES[i].second };
+            if (!world.passable(nx, ny))
+                continue;
+
+            const auto nkey{ key(nx, ny) };
+            const auto cost{ g + moveCost(i) };
+            auto [it, added] = nodes.try_emplace(nkey, Node{ cost, cur, false });
+            if (!added) {
+                if (it->second.closed || cost >= it->second.g)
+                    continue;
+                it->second.g = cost;
+                it->second.parent = cur;
+            }
+            open.emplace(cost + _heuristic(nx, ny, end), nkey);
+            SEARCH_STAT(++_stats.generated);
+            SEARCH_STAT(++_stats.heuristicCalls);
+        }
+    }
+    SEARCH_STAT(_stats.searchMs = timer.lap());
+
+    if (!found)
+        return false;
+
+    SEARCH_STAT(_stats.cost = nodes[endKey].g);
+    for (auto cur{ endKey };; cur = nodes[cur].parent) {
+        _path.emplace_back(cur % width, cur / width);
+        if (startKey == cur)
+            break;
+    }
+    std::reverse(std::begin(_path), std::end(_path));
+    SEARCH_STAT(_stats.pathLength = std::size(_path));
+    SEARCH_STAT(_stats.pathMs = timer.lap());
+
+    return true;
+}
+
+/*****************************************************************************/
+uint
+Streaming::_heuristic(int64_t x, int64_t y, Position end) const noexcept
+{
+    const auto dx{ static_cast<uint>(std::abs(x - static_cast<int64_t>(end.first))) };
+    const auto dy{ static_cast<uint>(std::abs(y - static_cast<int64_t>(end.second))) };
+    return octile(dx, dy, _dirs);
+}
+}
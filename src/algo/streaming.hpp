@@ -0,0 +1,79 @@
+/**
+ * @file streaming.hpp
+ * @brief A* on worlds paged in from disk
+ * @author lhm
+ */
+
+#ifndef SRC_ALGO_STREAMING_HPP
+#define SRC_ALGO_STREAMING_HPP
+
+// Standard headers
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Project's headers
+#include <algo/stats.hpp>
+#include <env/chunked.hpp>
+
+typedef unsigned int uint;
+
+namespace astar {
+
+/*****************************************************************************/
+/*!
+ * \brief The Streaming class runs A* (octile or manhattan heuristic, same moves
+ * and costs as the other engines) on a \a ChunkedWorld.
+ *
+ * Search data lives in a hash map of the reached cells rather than in the
+ * cells, so memory follows the size of the search, not of the world. Chunks
+ * the frontier moves towards are prefetched when it gets close to them.
+ *
+ * Proving that there is no path means expanding the whole area reachable from
+ * the start, which on such worlds may not fit in memory : runs give up after
+ * a number of expansions.
+ */
+class Streaming
+{
+public:
+    using Position = std::pair<uint32_t, uint32_t>;
+
+    // About 1 GB of search data
+    static constexpr uint64_t MAX_EXPANSIONS{ 1ULL << 24 };
+
+public:
+    /*!
+     * \param maxExpansions Cells expanded before a run gives up and reports no
+     * path, 0 : no limit
+     */
+    Streaming(uint dirs = 8, uint64_t maxExpansions = MAX_EXPANSIONS) noexcept;
+    virtual ~Streaming() noexcept = default;
+
+    [[maybe_unused]] bool run(env::ChunkedWorld&, Position start, Position end) noexcept;
+
+    /*!
+     * \brief Cells of the path found by the latest successful run, from start
+     * to end.
+     */
+    const std::vector<Position>& path(void) const noexcept { return _path; }
+    const SearchStats&           stats(void) const noexcept { return _stats; }
+
+    /*!
+     * \brief Whether the latest run stopped on the expansion limit rather than
+     * proving that there is no path.
+     */
+    bool capped(void) const noexcept { return _capped; }
+
+protected:
+    uint _heuristic(int64_t x, int64_t y, Position end) const noexcept;
+
+protected:
+    uint                  _dirs;
+    uint64_t              _maxExpansions; // 0 : no limit
+    bool                  _capped{ false };
+    std::vector<Position> _path;
+    SearchStats           _stats;
+};
+}
+
+#endif // SRC_ALGO_STREAMING_HPP
@@ -0,0 +1,544 @@
+/**
+ * @file subgoals.cpp
+ * @brief Implementation of \a subgoals.hpp
+ * @author lhm
+ */
+
+// Standard headers
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <queue>
+#include <thread>
+#include <tuple>
+
+// Project's headers
+#include "moves.hpp"
+#include "subgoals.hpp"
+#include <utils/Memory.hpp>
+#include <utils/Trace.hpp>
+
+using namespace env;
+
+namespace astar {
+
+constexpr uint NO_COST{ std::numeric_limits<uint>::max() };
+
+// Below this many subgoals to link, the threads cost more than they save
+constexpr size_t LINKS_PER_THREAD{ 256 };
+
+// Above this share of the subgoals to link again, they are all built again
+constexpr size_t REPAIR_MAX_SHARE{ 4 };
+
+/*****************************************************************************/
+template<typename T>
+bool
+Subgoals<T>::configure(const JSON::Object& conf) noexcept
+{
+    if (!Impl<T>::configure(conf))
+        return false;
+
+    // The subgoals depend on the moves allowed
+    _graph = nullptr;
+    return true;
+}
+
+/*****************************************************************************/
+template<typename T>
+uint64_t
+Subgoals<T>::signature(void) const noexcept
+{
+    return Impl<T>::signature() ^ std::hash<std::string>()("subgoals:");
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+Subgoals<T>::refresh(const Graph<T>* graph) noexcept
+{
+    update(graph);
+}
+
+/*****************************************************************************/
+template<typename T>
+size_t
+Subgoals<T>::edges(void) const noexcept
+{
+    size_t ret{ 0 };
+    for (const auto& s : _subgoals)
+        ret += std::size(s.edges);
+    return ret;
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+Subgoals<T>::update(const Graph<T>* graph) noexcept
+{
+    if (nullptr == graph || (graph == _graph && graph->version() == _version))
+        return;
+
+    std::vector<size_t> edits;
+    if (graph != _graph || !graph->editsSince(_version, edits)) {
+        _graph = graph;
+        _version = graph->version();
+        _rebuild();
+        return;
+    }
+
+    TRACE_SCOPE("Subgoals::repair");
+    MEMORY_SCOPE(memory::SEARCH);
+    _version = graph->version();
+
+    // Walls of the edits, before and after
+    std::vector<std::pair<uint8_t, uint8_t>> walls;
+    for (auto idx : edits)
+        walls.emplace_back(_walls[idx],
+                           _graph->cell(idx % _width, idx / _width)->hasState(ICell::WALL));
+
+    // Cells whose wall or subgoal changes : the edits, and the cells around
+    // them becoming or ceasing to be subgoals with the new walls
+    std::vector<size_t> changed{ edits }, flipped;
+    for (size_t k{ 0 }; k < std::size(edits); ++k)
+        _walls[edits[k]] = walls[k].second;
+    for (auto idx : edits) {
+        const int64_t x(idx % _width), y(idx / _width);
+        for (int64_t j{ y - 1 }; j <= y + 1; ++j)
+            for (int64_t i{ x - 1 }; i <= x + 1; ++i) {
+                if (i < 0 || j < 0 || i >= int64_t(_width) || j >= int64_t(_height))
+                    continue;
+
+                const size_t cell(j * _width + i);
+                if (_corner(i, j) != (NONE != _id[cell]))
+                    flipped.push_back(cell);
+            }
+    }
+    std::sort(std::begin(flipped), std::end(flipped));
+    flipped.erase(std::unique(std::begin(flipped), std::end(flipped)), std::end(flipped));
+    changed.insert(std::end(changed), std::begin(flipped), std::end(flipped));
+
+    // Scans are reversible : the subgoals whose scan read a changed cell are
+    // the ones a reverse scan from that cell meets, with the former walls
+    for (size_t k{ 0 }; k < std::size(edits); ++k)
+        _walls[edits[k]] = walls[k].first;
+
+    std::vector<uint32_t> dirty;
+    for (auto idx : changed)
+        _scan(idx, true, [&](size_t cell) {
+            if (NONE == _id[cell])
+                return true;
+            dirty.push_back(_id[cell]);
+            return false;
+        });
+
+    std::sort(std::begin(dirty), std::end(dirty));
+    dirty.erase(std::unique(std::begin(dirty), std::end(dirty)), std::end(dirty));
+    if (std::size(dirty) > count() / REPAIR_MAX_SHARE) {
+        _rebuild();
+        return;
+    }
+
+    for (size_t k{ 0 }; k < std::size(edits); ++k)
+        _walls[edits[k]] = walls[k].second;
+    for (auto cell : flipped) {
+        if (NONE != _id[cell]) {
+            _release(_id[cell]);
+            continue;
+        }
+        _add(cell);
+        dirty.push_back(_id[cell]);
+    }
+
+    // Released identifiers may be given again to the subgoals added
+    std::sort(std::begin(dirty), std::end(dirty));
+    dirty.erase(std::unique(std::begin(dirty), std::end(dirty)), std::end(dirty));
+    dirty.erase(std::remove_if(std::begin(dirty),
+                               std::end(dirty),
+                               [this](uint32_t id) { return NONE == _subgoals[id].cell; }),
+                std::end(dirty));
+    _connect(dirty);
+}
+
+/*****************************************************************************/
+template<typename T>
+bool
+Subgoals<T>::run(Graph<T>* world, T* start, T* end) noexcept
+{
+    TRACE_SCOPE("Subgoals::run");
+    MEMORY_SCOPE(memory::SEARCH);
+
+    this->_world = world;
+    this->_path.clear();
+    this->_stats.reset();
+    if (nullptr == world || nullptr == start || nullptr == end)
+        return false;
+
+    SEARCH_STAT(Lap timer);
+
+    this->_components.update(world);
+    if (!this->_components.connected(start, end)) {
+        SEARCH_STAT(this->_stats.setupMs = timer.lap());
+        return false;
+    }
+    update(world);
+    SEARCH_STAT(this->_stats.setupMs = timer.lap());
+
+    const size_t   startIdx{ world->index(start) };
+    const size_t   endIdx{ world->index(end) };
+    const uint32_t source(std::size(_subgoals)), goal(source + 1);
+
+    _nodes.resize(std::size(_subgoals) + 2);
+    _toGoal.resize(std::size(_subgoals), NO_COST);
+    if (0 == ++_round) {
+        for (auto& node : _nodes)
+            node.round = 0;
+        _round = 1;
+    }
+
+    // f, h (ties go closest to the goal first), node
+    using Entry = std::tuple<uint, uint, uint32_t>;
+    this->_scratch.reset();
+    std::priority_queue<Entry, memory::ArenaVector<Entry>, std::greater<Entry>> open{
+        std::greater<Entry>(), memory::ArenaVector<Entry>(this->_scratch)
+    };
+
+    auto relax = [&](uint32_t from, uint32_t to, uint cost) {
+        const auto g{ _nodes[from].g + cost };
+        auto&      node{ _nodes[to] };
+        if (node.round == _round && g >= node.g)
+            return;
+
+        node = { g, from, _round };
+        const auto h{ goal == to ? 0 : _distance(_subgoals[to].cell, endIdx) };
+        open.emplace(g + h, h, to);
+        SEARCH_STAT(++this->_stats.generated);
+        SEARCH_STAT(++this->_stats.heuristicCalls);
+        SEARCH_STAT(this->_stats.open(std::size(open)));
+    };
+
+    // Subgoals h-reachable from the goal, which lead to it
+    memory::ArenaVector<uint32_t> linked{ this->_scratch };
+    auto                          toGoal = [&](uint32_t id, uint cost) {
+        if (NO_COST == _toGoal[id])
+            linked.push_back(id);
+        _toGoal[id] = std::min(_toGoal[id], cost);
+    };
+    if (NONE != _id[endIdx])
+        toGoal(_id[endIdx], 0);
+    _scan(endIdx, true, [&](size_t idx) {
+        if (NONE == _id[idx])
+            return true;
+        toGoal(_id[idx], _distance(idx, endIdx));
+        return false;
+    });
+
+    // The start leads to the subgoals h-reachable from it, or to the goal
+    _nodes[source] = { 0, NONE, _round };
+    if (startIdx == endIdx)
+        relax(source, goal, 0);
+    _scan(startIdx, false, [&](size_t idx) {
+        if (idx == endIdx)
+            relax(source, goal, _distance(startIdx, endIdx));
+        if (NONE == _id[idx])
+            return true;
+        relax(source, _id[idx], _distance(startIdx, idx));
+        return false;
+    });
+
+    bool found{ false };
+    while (!std::empty(open)) {
+        const auto [f, h, id] = open.top();
+        open.pop();
+
+        // Entries left behind by a node reached again at a lower cost
+        if (_nodes[id].g + h != f)
+            continue;
+        if (goal == id) {
+            found = true;
+            break;
+        }
+        SEARCH_STAT(++this->_stats.expanded);
+
+        if (NO_COST != _toGoal[id])
+            relax(id, goal, _toGoal[id]);
+        const auto cell{ _subgoals[id].cell };
+        for (auto to : _subgoals[id].edges)
+            relax(id, to, _distance(cell, _subgoals[to].cell));
+    }
+    for (auto id : linked)
+        _toGoal[id] = NO_COST;
+    SEARCH_STAT(this->_stats.memory(std::size(_nodes) * sizeof(Node)));
+    SEARCH_STAT(this->_stats.searchMs = timer.lap());
+
+    if (!found)
+        return false;
+
+    memory::ArenaVector<size_t> cells{ this->_scratch };
+    for (auto id{ goal }; NONE != id; id = _nodes[id].parent)
+        cells.push_back(goal == id ? endIdx : source == id ? startIdx : _subgoals[id].cell);
+    std::reverse(std::begin(cells), std::end(cells));
+
+    start->_G = 0;
+    this->_path.push_back(start);
+    uint cost{ 0 };
+    for (size_t k{ 1 }; k < std::size(cells); ++k)
+        cost = _refine(cells[k - 1], cells[k], cost);
+
+    SEARCH_STAT(this->_stats.cost = end->_G);
+    SEARCH_STAT(this->_stats.pathLength = std::size(this->_path));
+    SEARCH_STAT(this->_stats.pathMs = timer.lap());
+
+    return true;
+}
+
+/*****************************************************************************/
+template<typename T>
+bool
+Subgoals<T>::_wall(int64_t x, int64_t y) const noexcept
+{
+    return x >= 0 && y >= 0 && x < int64_t(_width) && y < int64_t(_height) &&
+           _walls[y * _width + x];
+}
+
+/*****************************************************************************/
+template<typename T>
+bool
+Subgoals<T>::_open(int64_t x, int64_t y) const noexcept
+{
+    return x >= 0 && y >= 0 && x < int64_t(_width) && y < int64_t(_height) &&
+           !_walls[y * _width + x];
+}
+
+/*****************************************************************************/
+/*!
+ * \brief Whether the cell at \a x, \a y is a subgoal. The borders of the
+ * graph make none : they never stand in the way of a straight path.
+ */
+template<typename T>
+bool
+Subgoals<T>::_corner(int64_t x, int64_t y) const noexcept
+{
+    if (!_open(x, y))
+        return false;
+
+    // Paths go round the walls from a cell diagonal to their corner
+    if (4 == this->_dirs) {
+        for (uint i{ 4 }; i < 8; ++i) {
+            const auto [dx, dy]{ MOVES[i] };
+            if (_wall(x + dx, y + dy) && _open(x + dx, y) && _open(x, y + dy))
+                return true;
+        }
+        return false;
+    }
+
+    // Diagonal moves cut the corners of the walls : paths go round a wall
+    // from the cells beside its end, leaving them for the cell past the end
+    for (uint i{ 0 }; i < 4; ++i) {
+        const auto [dx, dy]{ MOVES[i] };
+        if (_wall(x + dx, y + dy) &&
+            (_open(x + dx + dy, y + dy + dx) || _open(x + dx - dy, y + dy - dx)))
+            return true;
+    }
+    return false;
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+Subgoals<T>::_rebuild(void) noexcept
+{
+    TRACE_SCOPE("Subgoals::build");
+    MEMORY_SCOPE(memory::SEARCH);
+
+    _width = _graph->getWidth();
+    _height = _graph->getHeight();
+    _walls.assign(_width * _height, 0);
+    for (size_t y{ 0 }; y < _height; ++y)
+        for (size_t x{ 0 }; x < _width; ++x)
+            _walls[y * _width + x] = _graph->cell(x, y)->hasState(ICell::WALL);
+
+    _id.assign(_width * _height, NONE);
+    _subgoals.clear();
+    _free.clear();
+    for (size_t y{ 0 }; y < _height; ++y)
+        for (size_t x{ 0 }; x < _width; ++x)
+            if (_corner(x, y))
+                _add(y * _width + x);
+
+    std::vector<uint32_t> ids(std::size(_subgoals));
+    for (uint32_t id{ 0 }; id < std::size(ids); ++id)
+        ids[id] = id;
+    _connect(ids);
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+Subgoals<T>::_add(size_t idx) noexcept
+{
+    uint32_t id(std::size(_subgoals));
+    if (!std::empty(_free)) {
+        id = _free.back();
+        _free.pop_back();
+    } else {
+        _subgoals.emplace_back();
+    }
+
+    auto& s{ _subgoals[id] };
+    s.cell = static_cast<uint32_t>(idx);
+    s.edges.clear();
+    _id[idx] = id;
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+Subgoals<T>::_release(uint32_t id) noexcept
+{
+    auto& s{ _subgoals[id] };
+    _id[s.cell] = NONE;
+    s.cell = NONE;
+    s.edges.clear();
+    _free.push_back(id);
+}
+
+/*****************************************************************************/
+/*!
+ * \brief Link the subgoals \a ids again, spread over the available cores.
+ */
+template<typename T>
+void
+Subgoals<T>::_connect(const std::vector<uint32_t>& ids) noexcept
+{
+    std::atomic<size_t> next{ 0 };
+
+    auto work = [&]() {
+        MEMORY_SCOPE(memory::SEARCH);
+        for (auto k{ next++ }; k < std::size(ids); k = next++)
+            _link(ids[k]);
+    };
+
+    const auto threads{ std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u),
+                                         1 + std::size(ids) / LINKS_PER_THREAD) };
+    std::vector<std::thread> workers;
+    for (size_t t{ 1 }; t < threads; ++t)
+        workers.emplace_back(work);
+    work();
+
+    for (auto& w : workers)
+        w.join();
+}
+
+/*****************************************************************************/
+/*!
+ * \brief Find the edges of the subgoal \a id.
+ */
+template<typename T>
+void
+Subgoals<T>::_link(uint32_t id) noexcept
+{
+    auto& s{ _subgoals[id] };
+
+    s.edges.clear();
+    _scan(s.cell, false, [&](size_t idx) {
+        if (NONE == _id[idx])
+            return true;
+        s.edges.push_back(_id[idx]);
+        return false;
+    });
+    s.edges.shrink_to_fit();
+}
+
+/*****************************************************************************/
+/*!
+ * \brief Call \a fn with the free cells reached from \a from by the moves of
+ * an octant taken in a fixed order, through the cells for which \a fn
+ * returned true : the diagonal move first then a straight one (the horizontal
+ * move then the vertical one without diagonals).
+ *
+ * The primary move is repeated from \a from, and the secondary one from each
+ * cell reached, up to a wall or a cell stopping the scan. Reversed, the scan
+ * meets the cells whose scan reaches \a from : the secondary move is negated
+ * and comes first.
+ *
+ * Any path made of the moves of an octant can take them in that order, or
+ * goes through a subgoal : when swapping a straight move followed by a
+ * diagonal one meets a wall, the cell between them goes round its end. The
+ * edges found this way keep the paths optimal, and each scan reads a few rays
+ * instead of the whole area in the octant.
+ */
+template<typename T>
+template<typename Fn>
+void
+Subgoals<T>::_scan(size_t from, bool reverse, Fn&& fn) const noexcept
+{
+    const int64_t x0(from % _width), y0(from / _width);
+
+    auto ray = [&](int64_t x, int64_t y, int64_t dx, int64_t dy) {
+        for (x += dx, y += dy; _open(x, y) && fn(y * _width + x); x += dx, y += dy)
+            continue;
+    };
+
+    // The other moves are the secondary ones, taken once from the origin
+    std::pair<int64_t, int64_t> primary[4], secondary[4][2];
+    uint                        count{ 0 };
+    for (uint i{ 0 }; i < this->_dirs; ++i) {
+        const int64_t dx{ MOVES[i].first }, dy{ MOVES[i].second };
+        if (4 == this->_dirs ? reverse == (0 == dy) : reverse == (i >= 4)) {
+            ray(x0, y0, dx, dy);
+            continue;
+        }
+
+        primary[count] = { dx, dy };
+        if (4 == this->_dirs) {
+            secondary[count][0] = { dy, dx };
+            secondary[count][1] = { -dy, -dx };
+        } else if (reverse) {
+            secondary[count][0] = { dx + dy, dy + dx };
+            secondary[count][1] = { dx - dy, dy - dx };
+        } else {
+            secondary[count][0] = { dx, 0 };
+            secondary[count][1] = { 0, dy };
+        }
+        ++count;
+    }
+
+    for (uint p{ 0 }; p < count; ++p) {
+        const auto [dx, dy]{ primary[p] };
+        for (int64_t x{ x0 + dx }, y{ y0 + dy }; _open(x, y) && fn(y * _width + x);
+             x += dx, y += dy)
+            for (const auto& [sx, sy] : secondary[p])
+                ray(x, y, sx, sy);
+    }
+}
+
+/*****************************************************************************/
+template<typename T>
+uint
+Subgoals<T>::_distance(size_t from, size_t to) const noexcept
+{
+    const auto dx{ static_cast<uint>(std::abs(int64_t(from % _width) - int64_t(to % _width))) };
+    const auto dy{ static_cast<uint>(std::abs(int64_t(from / _width) - int64_t(to / _width))) };
+    return octile(dx, dy, this->_dirs);
+}
+
+/*****************************************************************************/
+/*!
+ * \brief Append to \a _path the cells after \a from of the path to \a to
+ * found by a scan, \a cost being the cost at \a from.
+ * \return the cost at \a to
+ */
+template<typename T>
+uint
+Subgoals<T>::_refine(size_t from, size_t to, uint cost) noexcept
+{
+    const int64_t x(from % _width), y(from / _width), tx(to % _width), ty(to / _width);
+    return walk(x, y, tx, ty, this->_dirs, cost, [this](int64_t cx, int64_t cy, uint g) {
+        auto cell{ this->_world->cell(cx, cy) };
+        cell->_G = g;
+        this->_path.push_back(cell);
+    });
+}
+
+template class Subgoals<AStarCell>;
+}
@@ -0,0 +1,116 @@
+/**
+ * @file subgoals.hpp
+ * @brief Simple subgoal graph : A* over the corners of the walls
+ * @author lhm
+ */
+
+#ifndef SRC_ALGO_SUBGOALS_HPP
+#define SRC_ALGO_SUBGOALS_HPP
+
+// Standard headers
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Project's headers
+#include <algo/astar.hpp>
+
+namespace astar {
+
+/*****************************************************************************/
+/*!
+ * \brief The Subgoals engine searches a graph of the cells where shortest
+ * paths bend around the walls, instead of the grid.
+ *
+ * A cell is h-reachable from another one when a path between them costs their
+ * octile (or manhattan) distance, that is when a path made of the moves of a
+ * single octant (quadrant) joins them. Shortest paths only turn next to the
+ * walls, at the subgoals :
+ * - with diagonal moves, which may cut the corners of the walls, the free
+ *   cells beside the end of a wall,
+ * - without, the free cells diagonal to the corner of a wall.
+ * Subgoals are linked to the subgoals h-reachable from them by a path taking
+ * the diagonal moves first without going through another one, which keeps
+ * the graph sparse on open maps, all the edges being found in parallel.
+ *
+ * A query links the start and the goal the same way, searches that graph with
+ * the octile distance, and refines its edges into moves. The paths are
+ * optimal whatever the heuristic configured.
+ *
+ * The graph follows the walls journal through \a refresh : the subgoals around
+ * the edited cells are added or removed, and only the subgoals whose scan read
+ * an edited cell are linked again, unless they are too many and the graph is
+ * built again.
+ */
+template<typename T>
+class Subgoals : public Impl<T>
+{
+public:
+    static constexpr uint32_t NONE{ std::numeric_limits<uint32_t>::max() };
+
+public:
+    Subgoals() noexcept = default;
+    virtual ~Subgoals() noexcept = default;
+
+    [[maybe_unused]] virtual bool configure(const JSON::Object&) noexcept override;
+    [[maybe_unused]] virtual bool run(env::Graph<T>*, T* start, T* end) noexcept override;
+
+    virtual uint64_t signature(void) const noexcept override;
+    virtual void     refresh(const env::Graph<T>*) noexcept override;
+
+    /*!
+     * \brief Make the subgoal graph match the current state of \a graph.
+     * Does nothing unless the graph changed since the last call.
+     */
+    void update(const env::Graph<T>* graph) noexcept;
+
+    size_t count(void) const noexcept { return std::size(_subgoals) - std::size(_free); }
+    size_t edges(void) const noexcept;
+
+protected:
+    struct Subgoal
+    {
+        uint32_t              cell;  // Index, NONE once released
+        std::vector<uint32_t> edges; // Subgoals linked, costing their distance
+    };
+
+    struct Node
+    {
+        uint     g;
+        uint32_t parent;
+        uint32_t round; // Nodes of older rounds are not reached yet
+    };
+
+    bool _wall(int64_t x, int64_t y) const noexcept;
+    bool _open(int64_t x, int64_t y) const noexcept;
+    bool _corner(int64_t x, int64_t y) const noexcept;
+
+    void _rebuild(void) noexcept;
+    void _add(size_t idx) noexcept;
+    void _release(uint32_t id) noexcept;
+    void _connect(const std::vector<uint32_t>& ids) noexcept;
+    void _link(uint32_t id) noexcept;
+
+    template<typename Fn>
+    void _scan(size_t from, bool reverse, Fn&& fn) const noexcept;
+
+    uint _distance(size_t from, size_t to) const noexcept;
+    uint _refine(size_t from, size_t to, uint cost) noexcept;
+
+private:
+    const env::Graph<T>*  _graph{ nullptr };
+    uint64_t              _version{ 0 };
+    size_t                _width{ 0 };
+    size_t                _height{ 0 };
+    std::vector<uint8_t>  _walls; // Copy of the walls the subgoals were built from
+    std::vector<uint32_t> _id;    // Subgoal of each cell, NONE if it is not one
+    std::vector<Subgoal>  _subgoals;
+    std::vector<uint32_t> _free; // Identifiers of released subgoals
+
+    std::vector<Node> _nodes;  // By subgoal, then the start and the goal
+    std::vector<uint> _toGoal; // Cost from each subgoal to the goal, if h-reachable
+    uint32_t          _round{ 0 };
+};
+}
+
+#endif // SRC_ALGO_SUBGOALS_HPP
@@ -0,0 +1,179 @@
+/**
+ * @file theta.cpp
+ * @brief Implementation of \a theta.hpp
+ * @author lhm
+ */
+
+// Standard headers
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+
+// Project's headers
+#include "lineofsight.hpp"
+#include "moves.hpp"
+#include "theta.hpp"
+#include <utils/Memory.hpp>
+#include <utils/Trace.hpp>
+
+using namespace env;
+
+namespace astar {
+
+/*****************************************************************************/
+template<typename T>
+Theta<T>::Theta(bool lazy) noexcept
+  : _lazy{ lazy }
+{}
+
+/*****************************************************************************/
+template<typename T>
+bool
+Theta<T>::configure(const JSON::Object& conf) noexcept
+{
+    if (!Impl<T>::configure(conf))
+        return false;
+
+    // Only the euclidean heuristic matches any-angle costs
+    this->_landmarks.reset();
+    this->_heuristic =
+      std::bind(&Heuristic::euclidean, std::placeholders::_1, std::placeholders::_2);
+    return true;
+}
+
+/*****************************************************************************/
+template<typename T>
+uint64_t
+Theta<T>::signature(void) const noexcept
+{
+    return std::hash<std::string>()(_lazy ? "lazy-theta:" : "theta:") ^ (this->_dirs << 1);
+}
+
+/*****************************************************************************/
+template<typename T>
+bool
+Theta<T>::run(Graph<T>* world, T* start, T* end) noexcept
+{
+    TRACE_SCOPE("Theta::run");
+    MEMORY_SCOPE(memory::SEARCH);
+    this->_world = world;
+    this->_path.clear();
+    this->_stats.reset();
+    if (nullptr == world || nullptr == start || nullptr == end)
+        return false;
+
+    [[maybe_unused]] auto& stats{ this->_stats };
+    SEARCH_STAT(Lap timer);
+
+    this->_components.update(world);
+    SEARCH_STAT(stats.setupMs = timer.lap());
+    if (!this->_components.connected(start, end))
+        return false;
+
+    const auto size{ world->getWidth() * world->getHeight() };
+
+    using Entry = std::pair<uint, size_t>;
+    this->_scratch.reset();
+    std::priority_queue<Entry, memory::ArenaVector<Entry>, std::greater<Entry>> open{
+        std::greater<Entry>(), memory::ArenaVector<Entry>(this->_scratch)
+    };
+    memory::ArenaVector<uint8_t> closed(size, 0, this->_scratch), reached(size, 0, this->_scratch);
+
+    start->_G = 0;
+    start->_H = this->_heuristic(start, end);
+    start->_parent = start;
+    reached[world->index(start)] = 1;
+    open.emplace(start->getScore(), world->index(start));
+    SEARCH_STAT(++stats.generated);
+    SEARCH_STAT(++stats.heuristicCalls);
+
+    T* cur{ nullptr };
+    while (!std::empty(open)) {
+        SEARCH_STAT(stats.open(std::size(open)));
+        auto [score, idx] = open.top();
+        open.pop();
+
+        cur = world->cell(idx % world->getWidth(), idx / world->getWidth());
+        if (closed[idx] || score != cur->getScore())
+            continue;
+        SEARCH_STAT(++stats.expanded);
+
+        if (_lazy)
+            _setVertex(cur, closed);
+
+        if (end == cur)
+            break;
+        closed[idx] = 1;
+
+        for (uint i{ 0 }; i < this->_dirs; ++i) {
+            auto neigh{ world->neighbour(cur, MOVES[i].first, MOVES[i].second) };
+            if (!this->_eligible(neigh) || closed[world->index(neigh)])
+                continue;
+
+            if (auto nidx{ world->index(neigh) }; !reached[nidx]) {
+                reached[nidx] = 1;
+                neigh->_G = std::numeric_limits<uint>::max();
+                neigh->_H = this->_heuristic(neigh, end);
+                neigh->_parent = nullptr;
+                SEARCH_STAT(++stats.heuristicCalls);
+            }
+
+            // Try to link the neighbour directly to the parent of the current
+            // cell. The lazy variant assumes it can, and checks on expansion.
+            auto parent{ cur->_parent };
+            auto cost{ parent->_G + distance(parent, neigh) };
+            if (!_lazy && !lineOfSight(*world, parent, neigh)) {
+                parent = cur;
+                cost = cur->_G + moveCost(i);
+            }
+
+            if (cost < neigh->_G) {
+                neigh->_G = cost;
+                neigh->_parent = parent;
+                open.emplace(neigh->getScore(), world->index(neigh));
+                SEARCH_STAT(++stats.generated);
+            }
+        }
+    }
+    SEARCH_STAT(stats.searchMs = timer.lap());
+
+    start->_parent = nullptr;
+    if (cur != end)
+        return false;
+
+    SEARCH_STAT(stats.cost = cur->_G);
+    for (; nullptr != cur; cur = cur->_parent)
+        this->_path.push_back(cur);
+    std::reverse(std::begin(this->_path), std::end(this->_path));
+    SEARCH_STAT(stats.pathLength = std::size(this->_path));
+    SEARCH_STAT(stats.pathMs = timer.lap());
+
+    return true;
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+Theta<T>::_setVertex(T* c, const memory::ArenaVector<uint8_t>& closed) noexcept
+{
+    auto world{ this->_world };
+    if (c->_parent == c || lineOfSight(*world, c->_parent, c))
+        return;
+
+    // The parent cannot be seen : fall back on the best expanded neighbour
+    c->_G = std::numeric_limits<uint>::max();
+    for (uint i{ 0 }; i < this->_dirs; ++i) {
+        auto neigh{ world->neighbour(c, MOVES[i].first, MOVES[i].second) };
+        if (nullptr == neigh || !closed[world->index(neigh)])
+            continue;
+
+        if (auto cost{ neigh->_G + moveCost(i) }; cost < c->_G) {
+            c->_G = cost;
+            c->_parent = neigh;
+        }
+    }
+}
+
+template class Theta<AStarCell>;
+}
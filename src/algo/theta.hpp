@@ -0,0 +1,47 @@
+/**
+ * @file theta.hpp
+ * @brief Theta* any-angle path-finding
+ * @author lhm
+ */
+
+#ifndef SRC_ALGO_THETA_HPP
+#define SRC_ALGO_THETA_HPP
+
+// Standard headers
+#include <cstdint>
+#include <vector>
+
+// Project's headers
+#include <algo/astar.hpp>
+
+namespace astar {
+
+/*****************************************************************************/
+/*!
+ * \brief Theta* : an A* whose cells may take as parent any cell they can see,
+ * which gives any-angle paths. The lazy variant only checks the line of sight
+ * when a cell is expanded, instead of once per neighbour.
+ * Costs are euclidean distances, so is the heuristic.
+ */
+template<typename T>
+class Theta : public Impl<T>
+{
+public:
+    Theta(bool lazy = false) noexcept;
+    virtual ~Theta() noexcept = default;
+
+    [[maybe_unused]] virtual bool configure(const JSON::Object&) noexcept override;
+    [[maybe_unused]] virtual bool run(env::Graph<T>*, T* start, T* end) noexcept override;
+
+    virtual uint64_t signature(void) const noexcept override;
+    virtual bool     anyAngle(void) const noexcept override { return true; }
+
+protected:
+    void _setVertex(T*, const memory::ArenaVector<uint8_t>& closed) noexcept;
+
+private:
+    bool _lazy;
+};
+}
+
+#endif // SRC_ALGO_THETA_HPP
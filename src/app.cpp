@@ -5,11 +5,22 @@
  */
 
 // Standard headers
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <filesystem>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <thread>
 
 // Project headers
+#include <algo/engines.hpp>
+#include <algo/lineofsight.hpp>
 #include <app.hpp>
 #include <utils/Json.hpp>
+#include <utils/Memory.hpp>
+#include <utils/Trace.hpp>
 
 // External libs
 #include <JSON.hpp>
@@ -23,9 +34,21 @@ namespace fs = std::filesystem;
 
 constexpr int WINDOW_DEFAULT_HEIGHT{ 640 };
 constexpr int WINDOW_DEFAULT_WIDTH{ 640 };
+constexpr int CACHE_DEFAULT_SIZE{ 256 };
+
+constexpr size_t FRAME_GRAPH_SIZE{ 240 };    // Frames shown
+constexpr float  FRAME_GRAPH_SCALE{ 4.f };   // Pixels per millisecond
+constexpr float  FRAME_GRAPH_BUDGET{ 16.7f }; // Reference line (60 fps)
+constexpr float  FRAME_GRAPH_ALLOCS{ 1.f };   // Pixels per heap allocation
+
+constexpr size_t AGENTS_DEFAULT_COUNT{ 100 };
+constexpr double AGENTS_DEFAULT_BUDGET_MS{ 1000. };
+constexpr double AGENT_STEP_MS{ 150. };   // Duration of a move in the animation
+constexpr size_t AGENT_PAUSE_STEPS{ 10 }; // Steps shown on the goals before looping
 
 std::map<sf::Keyboard::Key, App::ACTION> _bindings;
 bool                                     need_cleaning{ false };
+bool                                     locked_click{ false };
 
 /*****************************************************************************/
 App&
@@ -80,13 +103,68 @@ App::configure(const std::string_view& file) noexcept
     return true;
 }
 
+/*****************************************************************************/
+/*!
+ * \brief Input of the session matching a window event, if any. Mouse positions
+ * are given as fractions of the window, out of it the mouse has left.
+ */
+static std::optional<session::Input>
+_toInput(const RenderWindow& window, const Event& event) noexcept
+{
+    using session::Input;
+
+    auto position = [&window](Input::Type type, Vector2i pos) {
+        const auto size{ window.getSize() };
+        if (pos.x < 0 || pos.y < 0 || pos.x >= int(size.x) || pos.y >= int(size.y))
+            return Input{ Input::MOUSE_LEFT };
+
+        Input ret{ type };
+        ret.x = static_cast<uint16_t>(uint64_t(pos.x) * 65536 / size.x);
+        ret.y = static_cast<uint16_t>(uint64_t(pos.y) * 65536 / size.y);
+        return ret;
+    };
+    auto button = [](Input::Type type, Mouse::Button code) {
+        Input ret{ type };
+        ret.code = code;
+        if (Keyboard::isKeyPressed(Keyboard::LShift) || Keyboard::isKeyPressed(Keyboard::RShift))
+            ret.modifiers |= Input::SHIFT;
+        if (Keyboard::isKeyPressed(Keyboard::LControl) ||
+            Keyboard::isKeyPressed(Keyboard::RControl))
+            ret.modifiers |= Input::CONTROL;
+        return ret;
+    };
+
+    switch (event.type) {
+        case Event::MouseEntered:
+            return position(Input::MOUSE_ENTERED, Mouse::getPosition(window));
+        case Event::MouseMoved:
+            return position(Input::MOUSE_MOVED, { event.mouseMove.x, event.mouseMove.y });
+        case Event::MouseLeft:
+            return Input{ Input::MOUSE_LEFT };
+        case Event::MouseButtonPressed:
+            return button(Input::BUTTON_PRESSED, event.mouseButton.button);
+        case Event::MouseButtonReleased:
+            return button(Input::BUTTON_RELEASED, event.mouseButton.button);
+        case Event::KeyReleased: {
+            Input ret{ Input::KEY_RELEASED };
+            ret.code = event.key.code;
+            return ret;
+        }
+        default:
+            return std::nullopt;
+    }
+}
+
 /*****************************************************************************/
 void
 App::update(void) noexcept
 {
-    static bool locked_click{ false };
+    TRACE_SCOPE("App::update");
+    _frameStart = trace::now();
 
-    sf::Event event;
+    // Inputs of the frame : from the window, or from the log being replayed
+    std::vector<session::Input> inputs;
+    sf::Event                   event;
     while (_window->pollEvent(event)) {
         switch (event.type) {
             case Event::Resized: {
@@ -95,84 +173,132 @@ App::update(void) noexcept
             case Event::Closed: {
                 _window->close();
             } break;
-            case Event::MouseEntered:
-            case Event::MouseMoved: {
-                auto mousePos{ Mouse::getPosition(*_window) };
-
-                if (_cell_cur = _graph->cell(
-                      mousePos.x / (static_cast<double>(_window->getSize().x) / _graph->getWidth()),
-                      mousePos.y /
-                        (static_cast<double>(_window->getSize().y) / _graph->getHeight()));
-                    nullptr == _cell_cur)
+            default:
+                if (auto input{ _toInput(*_window, event) }; input && !_player)
+                    inputs.push_back(*input);
+                break;
+        }
+    }
+
+    if (_player) {
+        uint64_t ns;
+        if (!_player->next(ns, inputs)) {
+            _endReplay();
+            return;
+        }
+        if (0 == _replayStart)
+            _replayStart = _frameStart;
+        if (_replayRealTime && _replayStart + ns > _frameStart)
+            std::this_thread::sleep_for(std::chrono::nanoseconds(_replayStart + ns - _frameStart));
+    } else if (_recorder) {
+        _recorder->frame(_frameStart, inputs);
+    }
+
+    for (const auto& input : inputs) {
+        _handle(input);
+        _grid->setCursor(_cell_cur);
+    }
+
+    // Engines keeping data derived from the walls repair it as they are painted
+    _analyzer->refresh(_graph.get());
+
+    if (_shared)
+        _shared->publish(*_graph);
+}
+
+/*****************************************************************************/
+void
+App::_handle(const session::Input& input) noexcept
+{
+    using session::Input;
+
+    switch (input.type) {
+        case Input::MOUSE_ENTERED:
+        case Input::MOUSE_MOVED: {
+            _cell_cur = _graph->cell(uint64_t(input.x) * _graph->getWidth() / 65536,
+                                     uint64_t(input.y) * _graph->getHeight() / 65536);
+            if (nullptr == _cell_cur)
+                break;
+
+            if (locked_click && !(_cell_cur->getState() & (ICell::START_CELL | ICell::END_CELL))) {
+                _graph->setWall(_cell_cur, true);
+            }
+        } break;
+        case Input::MOUSE_LEFT: {
+            _cell_cur = nullptr;
+        } break;
+        case Input::BUTTON_PRESSED: {
+            if (need_cleaning) {
+                _path.clear();
+                need_cleaning = false;
+            }
+            switch (input.code) {
+                case Mouse::Button::Left: {
+                    locked_click = true;
+                } break;
+                default:
                     break;
+            }
+        } break;
+        case Input::BUTTON_RELEASED: {
+            if (nullptr == _cell_cur)
+                break;
+            switch (input.code) {
+                case Mouse::Button::Left: {
+                    locked_click = false;
+                    if (!_cell_cur->hasState(ICell::START_CELL | ICell::END_CELL))
+                        _graph->setWall(_cell_cur, true);
 
-                if (locked_click &&
-                    !(_cell_cur->getState() & (ICell::START_CELL | ICell::END_CELL))) {
-                    _cell_cur->addState(ICell::WALL);
-                }
+                } break;
+                case Mouse::Button::Right: {
+                    if (_cell_cur->hasState(ICell::WALL))
+                        break;
 
-            } break;
-            case Event::MouseLeft: {
-                _cell_cur = nullptr;
-            } break;
-            case Event::MouseButtonPressed: {
-                if (need_cleaning) {
-                    _graph->clean();
-                    need_cleaning = false;
-                }
-                switch (event.mouseButton.button) {
-                    case Mouse::Button::Left: {
-                        locked_click = true;
-                    } break;
-                    default:
+                    // Shift adds more ends, Control more starts, for a
+                    // single search between the closest pair
+                    const bool moreEnds{ 0 != (input.modifiers & Input::SHIFT) };
+                    const bool moreStarts{ 0 != (input.modifiers & Input::CONTROL) };
+
+                    if (_removeExtra(_cell_cur))
                         break;
-                }
-            } break;
-            case Event::MouseButtonReleased: {
-                if (nullptr == _cell_cur)
-                    break;
-                switch (event.mouseButton.button) {
-                    case Mouse::Button::Left: {
-                        locked_click = false;
-                        if (!_cell_cur->hasState(ICell::START_CELL | ICell::END_CELL))
-                            _cell_cur->addState(ICell::WALL);
-
-                    } break;
-                    case Mouse::Button::Right: {
-                        if (_cell_cur->hasState(ICell::WALL))
-                            break;
-
-                        if (_cell_cur == _cell_start) {
-                            _cell_cur->remState(ICell::START_CELL);
-                            _cell_start = nullptr;
-                        } else if (_cell_cur == _cell_end) {
-                            _cell_cur->remState(ICell::END_CELL);
-                            _cell_end = nullptr;
-                        } else if (nullptr == _cell_start) {
-                            _cell_start = _cell_cur;
-                            _cell_start->addState(ICell::START_CELL);
-                        } else if (nullptr == _cell_end) {
-                            _cell_end = _cell_cur;
-                            _cell_end->addState(ICell::END_CELL);
-                        } else {
-                            _cell_end->remState(ICell::END_CELL);
-                            _cell_end = _cell_cur;
-                            _cell_end->addState(ICell::END_CELL);
+                    if (moreEnds || moreStarts) {
+                        if (!_cell_cur->hasState(ICell::START_CELL | ICell::END_CELL)) {
+                            (moreEnds ? _extra_ends : _extra_starts).push_back(_cell_cur);
+                            _cell_cur->addState(moreEnds ? ICell::END_CELL : ICell::START_CELL);
                         }
-                    } break;
-                    default:
                         break;
-                }
-            } break;
-            case Event::KeyReleased: {
-                if (auto it{ _bindings.find(event.key.code) }; std::end(_bindings) != it) {
-                    _actionsBoundings.at(it->second)();
-                }
-            } break;
-            default:
-                break;
-        }
-        _grid->setCursor(_cell_cur);
+                    }
+
+                    if (_cell_cur == _cell_start) {
+                        _cell_cur->remState(ICell::START_CELL);
+                        _cell_start = nullptr;
+                    } else if (_cell_cur == _cell_end) {
+                        _cell_cur->remState(ICell::END_CELL);
+                        _cell_end = nullptr;
+                    } else if (nullptr == _cell_start) {
+                        _cell_start = _cell_cur;
+                        _cell_start->addState(ICell::START_CELL);
+                    } else if (nullptr == _cell_end) {
+                        _cell_end = _cell_cur;
+                        _cell_end->addState(ICell::END_CELL);
+                    } else {
+                        _cell_end->remState(ICell::END_CELL);
+                        _cell_end = _cell_cur;
+                        _cell_end->addState(ICell::END_CELL);
+                    }
+                } break;
+                default:
+                    break;
+            }
+        } break;
+        case Input::KEY_RELEASED: {
+            const auto code{ static_cast<Keyboard::Key>(input.code) };
+            if (auto it{ _bindings.find(code) }; std::end(_bindings) != it) {
+                _actionsBoundings.at(it->second)();
+            }
+        } break;
+        default:
+            break;
     }
 }
 
@@ -180,9 +306,114 @@ App::update(void) noexcept
 void
 App::render(void) noexcept
 {
+    TRACE_SCOPE("App::render");
+    MEMORY_SCOPE(memory::RENDER);
+    _frameScratch.reset();
+
+    if (_showFlow) {
+        if (nullptr == _cell_end) {
+            _flowField();
+        } else if (_flow->goal() != _cell_end) {
+            _flow->compute(_graph.get(), _cell_end);
+        } else {
+            _flow->update();
+        }
+    }
+
+    if (_showAreas)
+        _analyzer->components().update(_graph.get());
+
+    if (0 != _agentsStart)
+        _moveAgents();
+
     _window->clear();
     _window->draw(*_grid);
-    _window->display();
+    if (_showFrameTimes)
+        _drawFrames();
+    {
+        TRACE_SCOPE("RenderWindow::display");
+        _window->display();
+    }
+
+    // Allocations of the whole frame, update included
+    uint64_t allocs{ 0 };
+    for (uint k{ 0 }; k < memory::SUBSYSTEMS; ++k)
+        allocs += memory::counters(memory::Subsystem(k)).count;
+
+    const auto now{ trace::now() };
+    if (0 != _lastFrame) {
+        _frameAllocs[_frame % FRAME_GRAPH_SIZE] = static_cast<float>(allocs - _lastAllocs);
+        _frameTimes[_frame++ % FRAME_GRAPH_SIZE] = (now - _lastFrame) / 1e6f;
+    }
+    _lastFrame = now;
+    _lastAllocs = allocs;
+
+    if (_player)
+        _replayTimes.push_back((now - _frameStart) / 1e6);
+}
+
+/*****************************************************************************/
+bool
+App::record(const std::string& file) noexcept
+{
+    _recorder = std::make_unique<session::Recorder>();
+    if (!_recorder->open(file)) {
+        _what = "Cannot record the session to '" + file + "'";
+        _recorder.reset();
+        return false;
+    }
+    return true;
+}
+
+/*****************************************************************************/
+bool
+App::replay(const std::string& file, bool realTime) noexcept
+{
+    _player = std::make_unique<session::Player>();
+    if (!_player->open(file)) {
+        _what = "Cannot replay '" + file + "' : not a session log";
+        _player.reset();
+        return false;
+    }
+
+    _replayRealTime = realTime;
+    _replayStart = 0;
+    _replayTimes.clear();
+    if (!realTime)
+        _window->setFramerateLimit(0);
+    return true;
+}
+
+/*****************************************************************************/
+void
+App::_endReplay(void) noexcept
+{
+    if (std::empty(_replayTimes)) {
+        printf("No frame replayed\n");
+        _player.reset();
+        _window->close();
+        return;
+    }
+
+    auto times{ _replayTimes };
+    std::sort(std::begin(times), std::end(times));
+    const auto count{ std::size(times) };
+    const auto at = [&](double q) { return times[std::min(count - 1, size_t(q * count))]; };
+    const auto slowest{ std::max_element(std::begin(_replayTimes), std::end(_replayTimes)) };
+
+    printf("%zu frames replayed in %.1f ms%s\n",
+           count,
+           (trace::now() - _replayStart) / 1e6,
+           _replayRealTime ? " (real time)" : "");
+    printf("frame (update + render) : mean %.3f ms, median %.3f, p95 %.3f, p99 %.3f\n",
+           std::accumulate(std::begin(times), std::end(times), 0.) / count,
+           at(.5),
+           at(.95),
+           at(.99));
+    printf("slowest : frame %zu, %.3f ms\n", size_t(slowest - std::begin(_replayTimes)), *slowest);
+
+    _player.reset();
+    _window->close();
 }
 
 /*****************************************************************************/
@@ -193,11 +424,23 @@ App::App() noexcept
   , _graph{ std::make_unique<Graph<AStarCell>>() }
   , _grid{ std::make_unique<Grid<AStarCell>>(_graph.get()) }
   , _analyzer{ std::make_unique<astar::Impl<AStarCell>>() }
+  , _flow{ std::make_unique<astar::FlowField<AStarCell>>() }
+  , _cache{ std::make_unique<astar::PathCache<AStarCell>>(CACHE_DEFAULT_SIZE) }
+  , _frameTimes(FRAME_GRAPH_SIZE, 0.f)
+  , _frameAllocs(FRAME_GRAPH_SIZE, 0.f)
   , _actionsBoundings{ { App::CLEAN, [this]() { _clear(); } },
                        { App::ANALYZE, [this]() { _analyze(); } },
                        { App::EXIT, [this]() { _stop(); } },
-                       { App::RELOAD, [this]() { _reload(); } } }
+                       { App::RELOAD, [this]() { _reload(); } },
+                       { App::FLOW, [this]() { _flowField(); } },
+                       { App::COMPONENTS, [this]() { _showComponents(); } },
+                       { App::FRAMES, [this]() { _showFrames(); } },
+                       { App::TRACE, [this]() { _dumpTrace(); } },
+                       { App::AGENTS, [this]() { _planAgents(); } },
+                       { App::ALLOCATIONS, [this]() { _showAllocations(); } } }
 {
+    _grid->setPath(&_path);
+
     View view;
     view.setSize(WINDOW_DEFAULT_WIDTH, WINDOW_DEFAULT_HEIGHT);
     view.setCenter(_window->getSize().x / 2.f, _window->getSize().y / 2.f);
@@ -213,21 +456,302 @@ App::_clear(void) noexcept
 {
     need_cleaning = false;
     _graph->clear();
+    _path.clear();
+    _grid->setAgents({});
+    _agentsStart = 0;
     _cell_start = nullptr;
     _cell_end = nullptr;
+    _extra_starts.clear();
+    _extra_ends.clear();
+}
+
+/*****************************************************************************/
+void
+App::_flowField(void) noexcept
+{
+    _showFlow = !_showFlow && nullptr != _cell_end;
+    if (_showFlow)
+        _flow->compute(_graph.get(), _cell_end);
+
+    _grid->setFlowField(_showFlow ? _flow.get() : nullptr);
+}
+
+/*****************************************************************************/
+void
+App::_showComponents(void) noexcept
+{
+    _showAreas = !_showAreas;
+    _grid->setComponents(_showAreas ? &_analyzer->components() : nullptr);
+}
+
+/*****************************************************************************/
+void
+App::_showFrames(void) noexcept
+{
+    _showFrameTimes = !_showFrameTimes;
+}
+
+/*****************************************************************************/
+void
+App::_dumpTrace(void) noexcept
+{
+    const std::string base{ std::string(PROG_NAME) + "-trace" };
+    if (trace::dumpChrome(base + ".json") && trace::dumpCsv(base + ".csv"))
+        _window->setTitle(std::string(PROG_NAME) + " - trace written to " + base + ".json/.csv");
+    else
+        _window->setTitle(std::string(PROG_NAME) + " - cannot write " + base + ".json/.csv");
+}
+
+/*****************************************************************************/
+void
+App::_drawFrames(void) noexcept
+{
+    // Bottom-left corner, oldest frame on the left
+    const float bottom{ _window->getView().getSize().y - 10.f };
+    auto        point = [bottom](size_t i, float ms) {
+        return Vector2f(10.f + 2.f * i, bottom - std::min(ms * FRAME_GRAPH_SCALE, bottom));
+    };
+
+    memory::ArenaVector<Vertex> budget{ _frameScratch };
+    budget.emplace_back(point(0, FRAME_GRAPH_BUDGET), Color::Red);
+    budget.emplace_back(point(FRAME_GRAPH_SIZE, FRAME_GRAPH_BUDGET), Color::Red);
+
+    // Allocations per frame below the durations, in cyan
+    memory::ArenaVector<Vertex> graph{ _frameScratch }, allocs{ _frameScratch };
+    graph.reserve(FRAME_GRAPH_SIZE);
+    allocs.reserve(FRAME_GRAPH_SIZE);
+    for (size_t i{ 0 }; i < FRAME_GRAPH_SIZE; ++i) {
+        const auto ms{ _frameTimes[(_frame + i) % FRAME_GRAPH_SIZE] };
+        const auto count{ _frameAllocs[(_frame + i) % FRAME_GRAPH_SIZE] };
+        graph.emplace_back(point(i, ms), ms > FRAME_GRAPH_BUDGET ? Color::Yellow : Color::Green);
+        allocs.emplace_back(point(i, count * FRAME_GRAPH_ALLOCS / FRAME_GRAPH_SCALE), Color::Cyan);
+    }
+
+    _window->draw(budget.data(), std::size(budget), Lines);
+    _window->draw(allocs.data(), std::size(allocs), LineStrip);
+    _window->draw(graph.data(), std::size(graph), LineStrip);
+}
+
+/*****************************************************************************/
+void
+App::_showAllocations(void) noexcept
+{
+    std::string title{ std::string(PROG_NAME) + " - allocations :" };
+    for (uint k{ 0 }; k < memory::SUBSYSTEMS; ++k) {
+        const auto subsystem{ memory::Subsystem(k) };
+        const auto counters{ memory::counters(subsystem) };
+        char       buf[128];
+        snprintf(buf,
+                 sizeof(buf),
+                 "%s %s %lu (%.1f MiB, %.1f MiB peak)",
+                 0 == k ? "" : ",",
+                 memory::name(subsystem),
+                 static_cast<unsigned long>(counters.count),
+                 counters.bytes / 1048576.,
+                 counters.peak / 1048576.);
+        title += buf;
+    }
+    _window->setTitle(title);
+}
+
+/*****************************************************************************/
+void
+App::_planAgents(void) noexcept
+{
+    // A second press stops the animation
+    if (0 != _agentsStart) {
+        _agentsStart = 0;
+        _grid->setAgents({});
+        _window->setTitle(PROG_NAME);
+        return;
+    }
+
+    // Distinct random starts and goals among the free cells
+    std::vector<AStarCell*> free;
+    for (size_t j{ 0 }; j < _graph->getHeight(); ++j)
+        for (size_t i{ 0 }; i < _graph->getWidth(); ++i)
+            if (auto cell{ _graph->cell(i, j) }; !cell->hasState(ICell::WALL))
+                free.push_back(cell);
+
+    // Same agents when a recorded session is replayed
+    std::mt19937 rng(_recorder || _player ? 0 : std::random_device{}());
+    std::shuffle(std::begin(free), std::end(free), rng);
+
+    const auto count{ std::min(_agentCount, std::size(free) / 2) };
+    std::vector<astar::Cooperative<AStarCell>::Agent> agents;
+    for (size_t a{ 0 }; a < count; ++a)
+        agents.emplace_back(free[a], free[count + a]);
+    if (std::empty(agents))
+        return;
+
+    _agents->plan(_graph.get(), agents);
+    _agentsStart = trace::now();
+
+    const auto& stats{ _agents->stats() };
+    char        buf[192];
+    snprintf(buf,
+             sizeof(buf),
+             " - %zu agents : %zu planned, %zu waiting, makespan %zu, %.1f ms (%.0f agents/s), "
+             "%lu expanded",
+             count,
+             stats.planned,
+             stats.failed,
+             _agents->makespan(),
+             stats.planMs + stats.refineMs,
+             count / std::max(stats.planMs + stats.refineMs, 1e-3) * 1e3,
+             static_cast<unsigned long>(stats.expanded));
+    std::string title{ std::string(PROG_NAME) + buf };
+    if (0 != stats.cbsNodes)
+        title += " - CBS " + std::to_string(stats.cbsNodes) + " nodes" +
+                 (stats.refined ? ", refined" : ", not kept");
+    _window->setTitle(title);
+}
+
+/*****************************************************************************/
+void
+App::_moveAgents(void) noexcept
+{
+    // Loop over the plan, pausing once every agent is arrived
+    const auto steps{ _agents->makespan() + AGENT_PAUSE_STEPS };
+    const auto elapsedMs{ (trace::now() - _agentsStart) / 1e6 };
+    const auto t{ static_cast<size_t>(elapsedMs / AGENT_STEP_MS) % steps };
+
+    std::vector<AStarCell*> positions;
+    for (size_t a{ 0 }; a < std::size(_agents->paths()); ++a)
+        positions.push_back(_agents->position(a, t));
+    _grid->setAgents(positions);
 }
 
 /*****************************************************************************/
 void
 App::_analyze(void) noexcept
 {
+    if (!std::empty(_extra_starts) || !std::empty(_extra_ends)) {
+        _analyzeMany();
+        return;
+    }
     if (nullptr == _cell_start || nullptr == _cell_end)
         return;
-    _graph->clean();
-    _analyzer->run(_graph.get(), _cell_start, _cell_end);
+    _cache->sync(_graph.get());
+
+    const auto width{ _graph->getWidth() };
+    const auto start{ _graph->index(_cell_start) };
+    const auto end{ _graph->index(_cell_end) };
+
+    std::vector<AStarCell*> path;
+    const auto              cached{ _cache->find(start, end, _analyzer->signature()) };
+    if (nullptr != cached) {
+        for (auto idx : cached->path)
+            path.push_back(_graph->cell(idx % width, idx / width));
+    } else {
+        astar::PathCache<AStarCell>::Result res;
+        if ((res.found = _analyzer->run(_graph.get(), _cell_start, _cell_end))) {
+            res.cost = _cell_end->_G;
+            path = _analyzer->path();
+            for (auto cur : path)
+                res.path.push_back(_graph->index(cur));
+        }
+        // Suboptimal paths of anytime engines are improved by the next runs
+        if (_analyzer->bound() <= 1.)
+            _cache->insert(start, end, _analyzer->signature(), std::move(res));
+    }
+
+    _drawPath(path);
+
+    const auto& stats{ _cache->stats() };
+    std::string title{ std::string(PROG_NAME) + " - cache : " + std::to_string(stats.hits) +
+                       " hits, " + std::to_string(stats.misses) + " misses" };
+#ifndef PATH_FINDER_NO_STATS
+    if (!cached) {
+        const auto& search{ _analyzer->stats() };
+        char        buf[128];
+        snprintf(buf,
+                 sizeof(buf),
+                 " - %lu expanded, %lu generated, open peak %zu, %.2f ms (%.2f setup)",
+                 static_cast<unsigned long>(search.expanded),
+                 static_cast<unsigned long>(search.generated),
+                 search.peakOpen,
+                 search.totalMs(),
+                 search.setupMs);
+        title += buf;
+        if (0 != search.peakBytes) {
+            snprintf(buf, sizeof(buf), ", %.1f KiB peak", search.peakBytes / 1024.);
+            title += buf;
+        }
+    }
+#endif
+    if (!cached && !std::empty(_analyzer->delegate()))
+        title += " - engine " + _analyzer->delegate();
+    if (!cached && _analyzer->bound() > 1.) {
+        char buf[64];
+        snprintf(buf, sizeof(buf), " - within %.2fx of optimal", _analyzer->bound());
+        title += buf;
+    }
+    _window->setTitle(title);
+}
+
+/*****************************************************************************/
+void
+App::_analyzeMany(void) noexcept
+{
+    std::vector<AStarCell*> starts{ _extra_starts };
+    std::vector<AStarCell*> ends{ _extra_ends };
+    if (nullptr != _cell_start)
+        starts.push_back(_cell_start);
+    if (nullptr != _cell_end)
+        ends.push_back(_cell_end);
+    if (std::empty(starts) || std::empty(ends))
+        return;
+
+    // Not cached : entries are keyed by a single pair of cells
+    std::vector<AStarCell*> path;
+    if (_analyzer->runMany(_graph.get(), starts, ends))
+        path = _analyzer->path();
+    _drawPath(path);
+
+    std::string title{ std::string(PROG_NAME) + " - " + std::to_string(std::size(starts)) +
+                       " starts, " + std::to_string(std::size(ends)) + " ends" };
+    if (!std::empty(path))
+        title += ", cost " + std::to_string(path.back()->_G);
+#ifndef PATH_FINDER_NO_STATS
+    const auto& search{ _analyzer->stats() };
+    char        buf[96];
+    snprintf(buf,
+             sizeof(buf),
+             " - %lu expanded, %.2f ms",
+             static_cast<unsigned long>(search.expanded),
+             search.totalMs());
+    title += buf;
+#endif
+    _window->setTitle(title);
+}
+
+/*****************************************************************************/
+void
+App::_drawPath(std::vector<AStarCell*>& path) noexcept
+{
+    // Smoothed paths, as any-angle ones, are drawn as segments by the grid
+    if (_smooth)
+        astar::smooth(*_graph, path);
+    _path.assign(*_graph, path);
     need_cleaning = true;
 }
 
+/*****************************************************************************/
+bool
+App::_removeExtra(AStarCell* cell) noexcept
+{
+    for (auto* cells : { &_extra_starts, &_extra_ends }) {
+        if (auto it{ std::find(std::begin(*cells), std::end(*cells), cell) };
+            std::end(*cells) != it) {
+            cells->erase(it);
+            cell->remState(cells == &_extra_starts ? ICell::START_CELL : ICell::END_CELL);
+            return true;
+        }
+    }
+    return false;
+}
+
 /*****************************************************************************/
 void
 App::_stop(void) noexcept
@@ -253,7 +777,8 @@ App::_initGraphics(const JSON::Object& conf) noexcept
 
     _window->setVerticalSyncEnabled(false);
     _window->setSize(sf::Vector2u(conf["width"].asInt(), conf["height"].asInt()));
-    _window->setFramerateLimit(conf["frame-rate"].asInt());
+    // Sessions replayed as fast as possible are not slowed down on reloads
+    _window->setFramerateLimit(_player && !_replayRealTime ? 0 : conf["frame-rate"].asInt());
 
     return true;
 }
@@ -387,6 +912,31 @@ App::_initBindings(const JSON::Object& conf) noexcept
     if (auto it{ _cvt.find(conf["reload"].asString()) }; std::end(_cvt) != it)
         _bindings[it->second] = RELOAD;
 
+    // Optional bindings
+    if (conf["flow"] && conf["flow"].isString())
+        if (auto it{ _cvt.find(conf["flow"].asString()) }; std::end(_cvt) != it)
+            _bindings[it->second] = FLOW;
+
+    if (conf["components"] && conf["components"].isString())
+        if (auto it{ _cvt.find(conf["components"].asString()) }; std::end(_cvt) != it)
+            _bindings[it->second] = COMPONENTS;
+
+    if (conf["frames"] && conf["frames"].isString())
+        if (auto it{ _cvt.find(conf["frames"].asString()) }; std::end(_cvt) != it)
+            _bindings[it->second] = FRAMES;
+
+    if (conf["trace"] && conf["trace"].isString())
+        if (auto it{ _cvt.find(conf["trace"].asString()) }; std::end(_cvt) != it)
+            _bindings[it->second] = TRACE;
+
+    if (conf["agents"] && conf["agents"].isString())
+        if (auto it{ _cvt.find(conf["agents"].asString()) }; std::end(_cvt) != it)
+            _bindings[it->second] = AGENTS;
+
+    if (conf["allocations"] && conf["allocations"].isString())
+        if (auto it{ _cvt.find(conf["allocations"].asString()) }; std::end(_cvt) != it)
+            _bindings[it->second] = ALLOCATIONS;
+
     return true;
 }
 
@@ -394,10 +944,59 @@ App::_initBindings(const JSON::Object& conf) noexcept
 bool
 App::_initAnalyzer(const JSON::Object& conf) noexcept
 {
+    std::string engine{ "astar" };
+    if (conf["engine"] && conf["engine"].isString())
+        engine = conf["engine"].asString();
+
+    _showAreas = false;
+    _grid->setComponents(nullptr);
+    _path.clear();
+
+    if (auto analyzer{ astar::create<AStarCell>(engine) }; nullptr != analyzer) {
+        _analyzer = std::move(analyzer);
+    } else {
+        _what = "Cannot initialize 'analyzer' : unknown engine";
+        return false;
+    }
+
+    _smooth = conf["smooth"] && conf["smooth"].asBoolean();
+
     auto ret{ _analyzer->configure(conf) };
 
-    if (!ret)
+    if (!ret) {
         _what = "Cannot initialize 'analyzer' : wrong format";
+        return ret;
+    }
+
+    uint threads{ std::max(std::thread::hardware_concurrency(), 1u) };
+    if (conf["flow-threads"] && conf["flow-threads"].isInt() && conf["flow-threads"].asInt() > 0)
+        threads = conf["flow-threads"].asInt();
+
+    size_t cacheSize{ CACHE_DEFAULT_SIZE };
+    if (conf["cache-size"] && conf["cache-size"].isInt() && conf["cache-size"].asInt() >= 0)
+        cacheSize = conf["cache-size"].asInt();
+    _cache = std::make_unique<astar::PathCache<AStarCell>>(cacheSize);
+
+    _showFlow = false;
+    _grid->setFlowField(nullptr);
+    _flow = std::make_unique<astar::FlowField<AStarCell>>(
+      conf["allow-diagonals"].asBoolean() ? 8 : 4, threads);
+
+    _agentCount = AGENTS_DEFAULT_COUNT;
+    if (conf["agents"] && conf["agents"].isInt() && conf["agents"].asInt() >= 0)
+        _agentCount = conf["agents"].asInt();
+
+    double budgetMs{ AGENTS_DEFAULT_BUDGET_MS };
+    if (conf["agents-budget-ms"] && conf["agents-budget-ms"].isInt() &&
+        conf["agents-budget-ms"].asInt() > 0)
+        budgetMs = conf["agents-budget-ms"].asInt();
+
+    _agentsStart = 0;
+    _grid->setAgents({});
+    _agents = std::make_unique<astar::Cooperative<AStarCell>>(
+      conf["allow-diagonals"].asBoolean() ? 8 : 4,
+      budgetMs,
+      conf["cbs"] && conf["cbs"].asBoolean());
 
     return ret;
 }
@@ -418,7 +1017,27 @@ App::_initGrid(const JSON::Object& conf) noexcept
         _cell_cur = nullptr;
         _cell_start = nullptr;
         _cell_end = nullptr;
+        _extra_starts.clear();
+        _extra_ends.clear();
+        _path.clear();
         _graph->resize(cols, rows);
+        _flow->compute(_graph.get(), nullptr);
+    }
+
+    // Publish the walls to other processes, keeping the segment (and its
+    // readers) on reloads that do not rename it
+    if (conf["shared-memory"] && conf["shared-memory"].isString()) {
+        const auto name{ conf["shared-memory"].asString() };
+        if (!_shared || _shared->name() != name)
+            _shared = std::make_unique<SharedMap>();
+        if (!_shared->create(name, cols, rows)) {
+            _what = "Cannot initialize 'grid' : " + _shared->what();
+            _shared.reset();
+            return false;
+        }
+        _shared->publish(*_graph);
+    } else {
+        _shared.reset();
     }
 
     return true;
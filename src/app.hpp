@@ -15,8 +15,13 @@
 
 // Project's headers
 #include <algo/astar.hpp>
+#include <algo/cooperative.hpp>
+#include <algo/pathcache.hpp>
 #include <env/graph.hpp>
+#include <env/sharedmap.hpp>
 #include <graphics/grid.hpp>
+#include <utils/Memory.hpp>
+#include <utils/Session.hpp>
 
 namespace sf {
 class RenderWindow;
@@ -40,7 +45,13 @@ public:
         CLEAN,
         ANALYZE,
         EXIT,
-        RELOAD
+        RELOAD,
+        FLOW,
+        COMPONENTS,
+        FRAMES,
+        TRACE,
+        AGENTS,
+        ALLOCATIONS
     } ACTION;
     using ActionFunction = std::function<void(void)>;
 
@@ -55,11 +66,33 @@ public:
 
     std::string what(void) const noexcept { return _what; }
 
+    /*!
+     * \brief Write the inputs of the session to \a file, or play back those of
+     * a recorded session instead of the live ones, as fast as possible or with
+     * the recorded timing. The frame times are printed at the end of the
+     * replay, which closes the window.
+     */
+    [[maybe_unused]] bool record(const std::string& file) noexcept;
+    [[maybe_unused]] bool replay(const std::string& file, bool realTime) noexcept;
+
 protected:
     void _clear(void) noexcept;
     void _analyze(void) noexcept;
+    void _analyzeMany(void) noexcept;
+    void _drawPath(std::vector<env::AStarCell*>& path) noexcept;
+    bool _removeExtra(env::AStarCell*) noexcept;
     void _stop(void) noexcept;
     void _reload(void) noexcept;
+    void _flowField(void) noexcept;
+    void _showComponents(void) noexcept;
+    void _showFrames(void) noexcept;
+    void _dumpTrace(void) noexcept;
+    void _showAllocations(void) noexcept;
+    void _drawFrames(void) noexcept;
+    void _planAgents(void) noexcept;
+    void _moveAgents(void) noexcept;
+    void _handle(const session::Input&) noexcept;
+    void _endReplay(void) noexcept;
 
     bool _initGraphics(const JSON::Object&) noexcept;
     bool _initBindings(const JSON::Object&) noexcept;
@@ -67,15 +100,48 @@ protected:
     bool _initGrid(const JSON::Object& conf) noexcept;
 
 protected:
-    UPTR<sf::RenderWindow>               _window;
-    UPTR<env::Graph<env::AStarCell>>     _graph;
-    UPTR<graphics::Grid<env::AStarCell>> _grid;
-    UPTR<astar::Impl<env::AStarCell>>    _analyzer;
+    UPTR<sf::RenderWindow>                   _window;
+    UPTR<env::Graph<env::AStarCell>>         _graph;
+    UPTR<graphics::Grid<env::AStarCell>>     _grid;
+    UPTR<astar::Impl<env::AStarCell>>        _analyzer;
+    UPTR<astar::FlowField<env::AStarCell>>   _flow;
+    UPTR<astar::PathCache<env::AStarCell>>   _cache;
+    UPTR<env::SharedMap>                     _shared;
+    UPTR<astar::Cooperative<env::AStarCell>> _agents;
+    astar::PathBuffer                        _path{ astar::PathBuffer::RUNS }; // Drawn by _grid
+    bool                                     _showFlow{ false };
+    bool                                     _showAreas{ false };
+    bool                                     _smooth{ false };
+
+    // Duration (ms) and heap allocations of the latest frames, as rings
+    std::vector<float> _frameTimes;
+    std::vector<float> _frameAllocs;
+    size_t             _frame{ 0 };
+    uint64_t           _lastFrame{ 0 };
+    uint64_t           _lastAllocs{ 0 };
+    bool               _showFrameTimes{ false };
+    memory::Arena      _frameScratch; // Vertexes of the overlays, reset on every frame
 
     env::AStarCell* _cell_start{ nullptr };
     env::AStarCell* _cell_end{ nullptr };
     env::AStarCell* _cell_cur{ nullptr };
 
+    // Session recorded or replayed
+    UPTR<session::Recorder> _recorder;
+    UPTR<session::Player>   _player;
+    bool                    _replayRealTime{ false };
+    uint64_t                _replayStart{ 0 }; // First frame replayed (ns)
+    uint64_t                _frameStart{ 0 };  // Current frame (ns)
+    std::vector<double>     _replayTimes;      // Update and render of each frame (ms)
+
+    // Agents moving along a cooperative plan
+    size_t   _agentCount{ 0 };
+    uint64_t _agentsStart{ 0 }; // Beginning of the animation (ns), 0 when stopped
+
+    // Additional starts and ends of a nearest-goal search
+    std::vector<env::AStarCell*> _extra_starts;
+    std::vector<env::AStarCell*> _extra_ends;
+
     std::string _what;
     std::string _conf_fileName;
 
@@ -0,0 +1,210 @@
+/**
+ * @file chunked.cpp
+ * @brief Implementation of \a chunked.hpp
+ * @author lhm
+ */
+
+// Standard headers
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Project headers
+#include "chunked.hpp"
+
+namespace env {
+
+constexpr uint32_t CHUNKED_MAGIC{ 0x4b4e4843 }; // "CHNK"
+constexpr size_t   CHUNKED_HEADER{ 4096 };      // Keeps the chunks aligned on pages
+
+/*****************************************************************************/
+ChunkedWorld::ChunkedWorld(size_t capacity) noexcept
+  : _capacity{ std::max<size_t>(capacity, 1) }
+{}
+
+/*****************************************************************************/
+ChunkedWorld::~ChunkedWorld() noexcept
+{
+    _close();
+}
+
+/*****************************************************************************/
+bool
+ChunkedWorld::create(const std::string& file, uint32_t width, uint32_t height) noexcept
+{
+    _close();
+
+    _fd = ::open(file.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    _width = width;
+    _height = height;
+    _chunksPerRow = (width + CHUNK_SIDE - 1) / CHUNK_SIDE;
+
+    const uint64_t chunks{ static_cast<uint64_t>(_chunksPerRow) *
+                           ((height + CHUNK_SIDE - 1) / CHUNK_SIDE) };
+    const uint32_t header[4]{ CHUNKED_MAGIC, width, height, CHUNK_SIDE };
+    if (_fd < 0 || sizeof(header) != pwrite(_fd, header, sizeof(header), 0) ||
+        ftruncate(_fd, _offset(chunks)) < 0) {
+        _what = "Cannot create '" + file + "' : " + std::strerror(errno);
+        _close();
+        return false;
+    }
+
+    return true;
+}
+
+/*****************************************************************************/
+bool
+ChunkedWorld::open(const std::string& file) noexcept
+{
+    _close();
+
+    uint32_t header[4];
+    _fd = ::open(file.c_str(), O_RDWR | O_CLOEXEC);
+    if (_fd < 0 || sizeof(header) != pread(_fd, header, sizeof(header), 0) ||
+        CHUNKED_MAGIC != header[0] || CHUNK_SIDE != header[3]) {
+        _what = "Cannot open '" + file + "' : not a chunked world";
+        _close();
+        return false;
+    }
+
+    _width = header[1];
+    _height = header[2];
+    _chunksPerRow = (_width + CHUNK_SIDE - 1) / CHUNK_SIDE;
+
+    return true;
+}
+
+/*****************************************************************************/
+bool
+ChunkedWorld::wall(uint32_t x, uint32_t y) noexcept
+{
+    const auto& chunk{ _chunk(x, y) };
+    const auto  bit{ (y % CHUNK_SIDE) * CHUNK_SIDE + x % CHUNK_SIDE };
+    return chunk.bits[bit / 8] & (1 << (bit % 8));
+}
+
+/*****************************************************************************/
+void
+ChunkedWorld::setWall(uint32_t x, uint32_t y, bool wall) noexcept
+{
+    auto&      chunk{ _chunk(x, y) };
+    const auto bit{ (y % CHUNK_SIDE) * CHUNK_SIDE + x % CHUNK_SIDE };
+    const auto before{ chunk.bits[bit / 8] };
+
+    if (wall)
+        chunk.bits[bit / 8] |= (1 << (bit % 8));
+    else
+        chunk.bits[bit / 8] &= ~(1 << (bit % 8));
+    chunk.dirty |= (before != chunk.bits[bit / 8]);
+}
+
+/*****************************************************************************/
+void
+ChunkedWorld::prefetch(int64_t x, int64_t y) noexcept
+{
+    if (_fd < 0 || x < 0 || y < 0 || x >= _width || y >= _height)
+        return;
+
+    const auto id{ static_cast<uint64_t>((y / CHUNK_SIDE) * _chunksPerRow + x / CHUNK_SIDE) };
+    if (id == _prefetched || _resident.count(id))
+        return;
+
+    _prefetched = id;
+    ++_stats.prefetches;
+    posix_fadvise(_fd, _offset(id), CHUNK_BYTES, POSIX_FADV_WILLNEED);
+}
+
+/*****************************************************************************/
+bool
+ChunkedWorld::flush(void) noexcept
+{
+    // A chunk that cannot be written stays dirty, the next flush retries it
+    bool ret{ true };
+    for (auto& chunk : _lru) {
+        if (chunk.dirty) {
+            chunk.dirty = !_write(chunk);
+            ret &= !chunk.dirty;
+        }
+    }
+    return ret;
+}
+
+/*****************************************************************************/
+ChunkedWorld::Chunk&
+ChunkedWorld::_chunk(uint32_t x, uint32_t y) noexcept
+{
+    const uint64_t id{ static_cast<uint64_t>(y / CHUNK_SIDE) * _chunksPerRow + x / CHUNK_SIDE };
+    if (nullptr != _last && id == _last->id) {
+        ++_stats.hits;
+        return *_last;
+    }
+
+    if (auto it{ _resident.find(id) }; std::end(_resident) != it) {
+        ++_stats.hits;
+        _lru.splice(std::begin(_lru), _lru, it->second);
+        return *(_last = &_lru.front());
+    }
+
+    // Reuse the least recently used chunk once full. When its edits cannot be
+    // written back it stays resident, and the cache grows past its capacity
+    // rather than losing them
+    ++_stats.misses;
+    const bool full{ std::size(_lru) >= _capacity };
+    if (full && _lru.back().dirty) {
+        ++_stats.writebacks;
+        _lru.back().dirty = !_write(_lru.back());
+    }
+    if (full && !_lru.back().dirty) {
+        _resident.erase(_lru.back().id);
+        _lru.splice(std::begin(_lru), _lru, std::prev(std::end(_lru)));
+        ++_stats.evictions;
+    } else {
+        _lru.emplace_front();
+        _lru.front().bits.resize(CHUNK_BYTES);
+    }
+
+    auto& chunk{ _lru.front() };
+    chunk.id = id;
+    chunk.dirty = false;
+    if (CHUNK_BYTES != pread(_fd, chunk.bits.data(), CHUNK_BYTES, _offset(id)))
+        std::fill(std::begin(chunk.bits), std::end(chunk.bits), 0);
+    _resident[id] = std::begin(_lru);
+
+    return *(_last = &chunk);
+}
+
+/*****************************************************************************/
+bool
+ChunkedWorld::_write(const Chunk& chunk) noexcept
+{
+    if (CHUNK_BYTES == pwrite(_fd, chunk.bits.data(), CHUNK_BYTES, _offset(chunk.id)))
+        return true;
+
+    ++_stats.failures;
+    _what = "Cannot write chunk " + std::to_string(chunk.id) + " : " + std::strerror(errno);
+    return false;
+}
+
+/*****************************************************************************/
+uint64_t
+ChunkedWorld::_offset(uint64_t id) const noexcept
+{
+    return CHUNKED_HEADER + id * CHUNK_BYTES;
+}
+
+/*****************************************************************************/
+void
+ChunkedWorld::_close(void) noexcept
+{
+    if (_fd >= 0) {
+        flush();
+        close(_fd);
+    }
+    _fd = -1;
+    _lru.clear();
+    _resident.clear();
+    _last = nullptr;
+    _stats = Stats();
+}
+}
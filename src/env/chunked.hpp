@@ -0,0 +1,121 @@
+/**
+ * @file chunked.hpp
+ * @brief Walls of a grid larger than memory, paged in from a file
+ * @author lhm
+ */
+
+#ifndef SRC_ENV_CHUNKED_HPP
+#define SRC_ENV_CHUNKED_HPP
+
+// Standard headers
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace env {
+
+/*****************************************************************************/
+/*!
+ * \brief The ChunkedWorld class holds the walls of a grid in a file, by square
+ * chunks of CHUNK_SIDE x CHUNK_SIDE cells (one bit each), and keeps the most
+ * recently used ones in memory.
+ *
+ * Graph cells cannot be paged out : engines keep pointers to them. Searches on
+ * such worlds use coordinates instead (see streaming.hpp), so only the walls
+ * need to be stored, 1.25 GB for 100k x 100k cells.
+ *
+ * Edited chunks are written back when evicted, and on \a flush. A chunk that
+ * cannot be written stays in memory until a later write succeeds : the
+ * failures are counted in \a stats and described by \a what.
+ */
+class ChunkedWorld
+{
+public:
+    static constexpr uint32_t CHUNK_SIDE{ 256 };
+    static constexpr size_t   CHUNK_BYTES{ CHUNK_SIDE * CHUNK_SIDE / 8 };
+
+    struct Stats
+    {
+        uint64_t hits{ 0 };
+        uint64_t misses{ 0 };
+        uint64_t evictions{ 0 };
+        uint64_t writebacks{ 0 };
+        uint64_t failures{ 0 }; // Writes that failed, the chunks are kept dirty
+        uint64_t prefetches{ 0 };
+    };
+
+public:
+    /*!
+     * \param capacity Chunks kept in memory (8 KB each)
+     */
+    ChunkedWorld(size_t capacity = 4096) noexcept;
+    virtual ~ChunkedWorld() noexcept;
+
+    ChunkedWorld(const ChunkedWorld&) = delete;
+    ChunkedWorld& operator=(const ChunkedWorld&) = delete;
+
+    /*!
+     * \brief Create \a file for an empty \a width x \a height world. The file is
+     * sparse : chunks without walls take no disk space until written.
+     */
+    [[maybe_unused]] bool create(const std::string& file, uint32_t width, uint32_t height) noexcept;
+    [[maybe_unused]] bool open(const std::string& file) noexcept;
+
+    bool wall(uint32_t x, uint32_t y) noexcept;
+    void setWall(uint32_t x, uint32_t y, bool wall) noexcept;
+
+    /*!
+     * \brief Whether (x, y) is in the world and not a wall
+     */
+    bool passable(int64_t x, int64_t y) noexcept
+    {
+        return x >= 0 && y >= 0 && x < _width && y < _height && !wall(x, y);
+    }
+
+    /*!
+     * \brief Hint that the chunk holding (x, y) will be needed soon : the
+     * kernel starts reading it in the background.
+     */
+    void prefetch(int64_t x, int64_t y) noexcept;
+
+    [[maybe_unused]] bool flush(void) noexcept;
+
+    uint32_t     getWidth(void) const noexcept { return _width; }
+    uint32_t     getHeight(void) const noexcept { return _height; }
+    const Stats& stats(void) const noexcept { return _stats; }
+    std::string  what(void) const noexcept { return _what; }
+
+protected:
+    struct Chunk
+    {
+        uint64_t             id;
+        bool                 dirty{ false };
+        std::vector<uint8_t> bits;
+    };
+
+    Chunk&   _chunk(uint32_t x, uint32_t y) noexcept;
+    bool     _write(const Chunk&) noexcept;
+    uint64_t _offset(uint64_t id) const noexcept;
+    void     _close(void) noexcept;
+
+protected:
+    std::string _what;
+    int         _fd{ -1 };
+    uint32_t    _width{ 0 }, _height{ 0 };
+    uint32_t    _chunksPerRow{ 0 };
+    size_t      _capacity;
+    Stats       _stats;
+
+    // Resident chunks, most recently used first
+    std::list<Chunk>                                         _lru;
+    std::unordered_map<uint64_t, std::list<Chunk>::iterator> _resident;
+
+    // Last chunk used : most accesses hit the same chunk in a row
+    Chunk*   _last{ nullptr };
+    uint64_t _prefetched{ UINT64_MAX };
+};
+}
+
+#endif // SRC_ENV_CHUNKED_HPP
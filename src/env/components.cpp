@@ -0,0 +1,250 @@
+/**
+ * @file components.cpp
+ * @brief Implementation of \a components.hpp
+ * @author lhm
+ */
+
+// Standard headers
+#include <algorithm>
+
+// Project headers
+#include "components.hpp"
+#include <algo/moves.hpp>
+
+using namespace astar;
+
+namespace env {
+
+/*****************************************************************************/
+template<typename T>
+Components<T>::Components(uint dirs) noexcept
+  : _dirs{ dirs }
+{}
+
+/*****************************************************************************/
+template<typename T>
+void
+Components<T>::update(const Graph<T>* graph) noexcept
+{
+    if (nullptr == graph || (graph == _graph && graph->version() == _version))
+        return;
+
+    std::vector<size_t> edits;
+    if (graph != _graph || !graph->editsSince(_version, edits) ||
+        std::size(_parent) > 4 * std::size(_labels) + 1024) {
+        _graph = graph;
+        _version = graph->version();
+        _rebuild();
+        return;
+    }
+
+    std::sort(std::begin(edits), std::end(edits));
+    edits.erase(std::unique(std::begin(edits), std::end(edits)), std::end(edits));
+
+    const auto width{ _graph->getWidth() };
+    auto       isWall = [&](size_t idx) {
+        return _graph->cell(idx % width, idx / width)->hasState(ICell::WALL);
+    };
+
+    // New walls first, so that the removed ones are joined to up to date areas.
+    // They are applied one at a time : the labels stay those of a real layout.
+    for (auto idx : edits)
+        if (isWall(idx) && NONE != _labels[idx]) {
+            _labels[idx] = NONE;
+            _addWall(idx);
+        }
+
+    for (auto idx : edits)
+        if (!isWall(idx) && NONE == _labels[idx])
+            _removeWall(idx);
+
+    _version = _graph->version();
+}
+
+/*****************************************************************************/
+template<typename T>
+uint
+Components<T>::id(const T* c) const noexcept
+{
+    if (nullptr == _graph || nullptr == c)
+        return NONE;
+
+    auto label{ _labels[_graph->index(c)] };
+    return (NONE == label) ? NONE : _find(label);
+}
+
+/*****************************************************************************/
+template<typename T>
+bool
+Components<T>::connected(const T* a, const T* b) const noexcept
+{
+    auto ida{ id(a) };
+    return NONE != ida && ida == id(b);
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+Components<T>::_rebuild(void) noexcept
+{
+    const auto width{ _graph->getWidth() };
+    const auto size{ width * _graph->getHeight() };
+
+    _labels.assign(size, NONE);
+    _parent.clear();
+    _count = 0;
+
+    // Mark the free cells with a temporary node, then fill each area
+    _parent.push_back(0);
+    for (size_t idx{ 0 }; idx < size; ++idx)
+        if (!_graph->cell(idx % width, idx / width)->hasState(ICell::WALL))
+            _labels[idx] = 0;
+
+    for (size_t idx{ 0 }; idx < size; ++idx) {
+        if (0 != _labels[idx])
+            continue;
+
+        _parent.push_back(static_cast<uint>(std::size(_parent)));
+        _fill(idx, 0, _parent.back());
+        ++_count;
+    }
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+Components<T>::_addWall(size_t idx) noexcept
+{
+    const auto width{ _graph->getWidth() };
+    const int  x{ static_cast<int>(idx % width) };
+    const int  y{ static_cast<int>(idx / width) };
+
+    // Free neighbours of the new wall
+    std::vector<size_t> around;
+    for (uint i{ 0 }; i < _dirs; ++i)
+        if (auto neigh{ _graph->cell(x + MOVES[i].first, y + MOVES[i].second) };
+            nullptr != neigh && NONE != _labels[_graph->index(neigh)])
+            around.push_back(_graph->index(neigh));
+
+    if (std::empty(around)) {
+        --_count;
+        return;
+    }
+    if (1 == std::size(around))
+        return;
+
+    // Local check : if the neighbours are still connected within the 3x3
+    // square around the wall, the area cannot have been split.
+    auto inSquare = [&](const T* c) {
+        return nullptr != c && std::abs(static_cast<int>(c->x()) - x) <= 1 &&
+               std::abs(static_cast<int>(c->y()) - y) <= 1 && NONE != _labels[_graph->index(c)];
+    };
+
+    std::vector<size_t> reached{ around.front() };
+    for (size_t k{ 0 }; k < std::size(reached); ++k) {
+        for (uint i{ 0 }; i < _dirs; ++i) {
+            auto neigh{ _graph->cell(reached[k] % width + MOVES[i].first,
+                                     reached[k] / width + MOVES[i].second) };
+            if (inSquare(neigh) && std::end(reached) == std::find(std::begin(reached),
+                                                                  std::end(reached),
+                                                                  _graph->index(neigh)))
+                reached.push_back(_graph->index(neigh));
+        }
+    }
+
+    if (std::all_of(std::begin(around), std::end(around), [&reached](auto n) {
+            return std::end(reached) != std::find(std::begin(reached), std::end(reached), n);
+        }))
+        return;
+
+    // Label again every piece of the area but the last one, which keeps the
+    // previous labels.
+    const auto root{ _find(_labels[around.front()]) };
+    auto       remaining = [&](size_t first) {
+        return std::any_of(std::begin(around) + first, std::end(around), [&](auto n) {
+            return _find(_labels[n]) == root;
+        });
+    };
+
+    for (size_t k{ 0 }; k < std::size(around) && remaining(k + 1); ++k) {
+        if (_find(_labels[around[k]]) != root)
+            continue;
+
+        _parent.push_back(static_cast<uint>(std::size(_parent)));
+        _fill(around[k], root, _parent.back());
+
+        // The whole area may have been reached through a longer way
+        if (!remaining(k + 1))
+            break;
+        ++_count;
+    }
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+Components<T>::_removeWall(size_t idx) noexcept
+{
+    const auto width{ _graph->getWidth() };
+    const int  x{ static_cast<int>(idx % width) };
+    const int  y{ static_cast<int>(idx / width) };
+
+    _parent.push_back(static_cast<uint>(std::size(_parent)));
+    _labels[idx] = _parent.back();
+    ++_count;
+
+    for (uint i{ 0 }; i < _dirs; ++i) {
+        auto neigh{ _graph->cell(x + MOVES[i].first, y + MOVES[i].second) };
+        if (nullptr == neigh || NONE == _labels[_graph->index(neigh)])
+            continue;
+
+        auto a{ _find(_labels[idx]) }, b{ _find(_labels[_graph->index(neigh)]) };
+        if (a != b) {
+            _parent[b] = a;
+            --_count;
+        }
+    }
+}
+
+/*****************************************************************************/
+template<typename T>
+uint
+Components<T>::_find(uint node) const noexcept
+{
+    // Path halving
+    while (_parent[node] != node) {
+        _parent[node] = _parent[_parent[node]];
+        node = _parent[node];
+    }
+    return node;
+}
+
+/*****************************************************************************/
+template<typename T>
+uint
+Components<T>::_fill(size_t from, uint root, uint node) noexcept
+{
+    const auto width{ _graph->getWidth() };
+
+    std::vector<size_t> queue{ from };
+    _labels[from] = node;
+
+    for (size_t k{ 0 }; k < std::size(queue); ++k) {
+        for (uint i{ 0 }; i < _dirs; ++i) {
+            auto neigh{ _graph->cell(queue[k] % width + MOVES[i].first,
+                                     queue[k] / width + MOVES[i].second) };
+            if (nullptr == neigh)
+                continue;
+
+            auto nidx{ _graph->index(neigh) };
+            if (NONE != _labels[nidx] && _find(_labels[nidx]) == root) {
+                _labels[nidx] = node;
+                queue.push_back(nidx);
+            }
+        }
+    }
+    return static_cast<uint>(std::size(queue));
+}
+
+template class Components<AStarCell>;
+}
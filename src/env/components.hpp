@@ -0,0 +1,70 @@
+/**
+ * @file components.hpp
+ * @brief Connected areas of a graph
+ * @author lhm
+ */
+
+#ifndef SRC_ENV_COMPONENTS_HPP
+#define SRC_ENV_COMPONENTS_HPP
+
+// Standard headers
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Project's headers
+#include <env/graph.hpp>
+
+namespace env {
+
+/*****************************************************************************/
+/*!
+ * \brief The Components class labels the connected areas of free cells of a
+ * graph, so that a search between two areas is rejected immediately.
+ *
+ * Labels are nodes of a union-find structure. They follow the walls journal of
+ * the graph (see \a update) :
+ * - a removed wall joins the areas around it,
+ * - a new wall can only split its own area, which is labelled again unless
+ *   its neighbourhood shows that it stays connected.
+ */
+template<typename T>
+class Components
+{
+public:
+    static constexpr uint NONE{ std::numeric_limits<uint>::max() };
+
+public:
+    Components(uint dirs = 8) noexcept;
+    virtual ~Components() noexcept = default;
+
+    void update(const Graph<T>* graph) noexcept;
+
+    /*!
+     * \brief Identifier of the area of \a c, \a NONE for walls.
+     */
+    uint id(const T* c) const noexcept;
+    bool connected(const T* a, const T* b) const noexcept;
+    uint count(void) const noexcept { return _count; }
+
+protected:
+    void _rebuild(void) noexcept;
+    void _addWall(size_t idx) noexcept;
+    void _removeWall(size_t idx) noexcept;
+    uint _find(uint node) const noexcept;
+    uint _fill(size_t from, uint root, uint node) noexcept;
+
+private:
+    const Graph<T>* _graph{ nullptr };
+    uint64_t        _version{ 0 };
+
+    uint _dirs;
+    uint _count{ 0 };
+
+    std::vector<uint>         _labels; // Union-find node of each cell
+    mutable std::vector<uint> _parent; // Union-find parent of each node
+};
+
+}
+
+#endif // SRC_ENV_COMPONENTS_HPP
@@ -9,10 +9,6 @@
 // Project headers
 #include "graph.hpp"
 
-// External libs
-#include <SFML/Graphics.hpp>
-
-using namespace sf;
 using namespace env;
 
 /*****************************************************************************/
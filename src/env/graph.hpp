@@ -9,10 +9,18 @@
 
 // Standard headers
 #include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
 #include <memory>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
+// Project's headers
+#include <env/layout.hpp>
+#include <utils/Trace.hpp>
+
 typedef unsigned int uint;
 
 namespace env {
@@ -71,7 +79,50 @@ public:
 };
 
 /*****************************************************************************/
-template<typename T, typename = std::enable_if_t<std::is_base_of_v<ICell, T>>>
+/*!
+ * \brief Walls of a rectangle of cells, one bit per cell, each row starting
+ * on a new word. Taken by \a Graph::copy, given back by \a Graph::paste.
+ */
+class Stamp
+{
+public:
+    Stamp(size_t width = 0, size_t height = 0) noexcept
+      : _width{ width }
+      , _height{ height }
+      , _words{ (width + 63) / 64 }
+      , _bits(_words * height, 0)
+    {}
+
+    auto getWidth(void) const noexcept { return _width; }
+    auto getHeight(void) const noexcept { return _height; }
+
+    bool wall(size_t i, size_t j) const noexcept
+    {
+        return (_bits[j * _words + i / 64] >> (i % 64)) & 1;
+    }
+    void setWall(size_t i, size_t j, bool wall) noexcept
+    {
+        const uint64_t bit{ 1ULL << (i % 64) };
+        auto&          word{ _bits[j * _words + i / 64] };
+        word = wall ? (word | bit) : (word & ~bit);
+    }
+
+private:
+    size_t                _width, _height;
+    size_t                _words; // Per row
+    std::vector<uint64_t> _bits;
+};
+
+/*****************************************************************************/
+/*!
+ * \brief The Graph class owns the cells of a grid.
+ * \a Layout (see \a layout.hpp) decides how cells are ordered in memory : cells
+ * are only reached through \a cell and \a neighbour, and \a index always gives
+ * the row-major position used by data stored next to the graph.
+ */
+template<typename T,
+         typename Layout = layout::RowMajor,
+         typename = std::enable_if_t<std::is_base_of_v<ICell, T>>>
 class Graph
 {
 public:
@@ -88,25 +139,182 @@ public:
     {
         bool ret{ false };
         std::for_each(std::begin(_data), std::end(_data), [&ret](auto& c) { ret |= c.clear(); });
+        if (ret)
+            _forget();
         return ret;
     }
     [[maybe_unused]] bool clean(void) noexcept
     {
+        TRACE_SCOPE("Graph::clean");
         bool ret{ false };
         std::for_each(std::begin(_data), std::end(_data), [&ret](auto& c) { ret |= c.clean(); });
         return ret;
     }
 
+    /*!
+     * \brief Change the size of the graph, keeping the walls of the cells
+     * still inside.
+     */
     virtual void resize(size_t width, size_t height) noexcept
     {
+        TRACE_SCOPE("Graph::resize");
+        if (!std::empty(_data) && width == _width && height == _height)
+            return;
+
+        Stamp kept;
+        if (!std::empty(_data) && 0 != width && 0 != height)
+            kept = copy(0, 0, std::min(width, _width) - 1, std::min(height, _height) - 1);
+
         _width = width;
         _height = height;
 
-        _data.clear();
-        _data.reserve(_width * _height);
-        for (size_t i{ 0 }; i < _height; ++i)
-            for (size_t j{ 0 }; j < _width; ++j)
-                _data.push_back(T(j, i));
+        // Padding cells of the layout (out of the graph) are never reached
+        std::vector<T> data;
+        data.reserve(Layout::capacity(_width, _height));
+        for (size_t idx{ 0 }; idx < Layout::capacity(_width, _height); ++idx) {
+            auto [i, j] = Layout::coords(idx, _width, _height);
+            data.emplace_back(i, j);
+        }
+        _data = std::move(data);
+
+        for (size_t j{ 0 }; j < kept.getHeight(); ++j)
+            for (size_t i{ 0 }; i < kept.getWidth(); ++i)
+                if (kept.wall(i, j))
+                    cell(i, j)->addState(ICell::WALL);
+        _forget();
+    }
+
+    /*!
+     * \brief Add or remove a wall on a cell.
+     * Walls must be edited through the graph so that the data derived from
+     * them (landmarks tables, ...) knows when to be refreshed.
+     */
+    [[maybe_unused]] bool setWall(T* c, bool wall) noexcept
+    {
+        _set(c, wall);
+        return 0 != _commit();
+    }
+
+    /*!
+     * \brief Bulk edits of the walls : each one bumps the version once, as a
+     * single change, whatever the number of cells edited. Cells out of the
+     * graph are skipped.
+     * \return the number of cells whose wall was added or removed
+     */
+    [[maybe_unused]] size_t fill(size_t x0, size_t y0, size_t x1, size_t y1, bool wall) noexcept
+    {
+        for (auto j{ std::min(y0, y1) }; j <= std::max(y0, y1) && j < _height; ++j)
+            for (auto i{ std::min(x0, x1) }; i <= std::max(x0, x1) && i < _width; ++i)
+                _set(cell(i, j), wall);
+        return _commit();
+    }
+    [[maybe_unused]] size_t line(size_t x0, size_t y0, size_t x1, size_t y1, bool wall) noexcept
+    {
+        // Bresenham, cells touching diagonally
+        const int64_t dx{ std::abs(int64_t(x1) - int64_t(x0)) };
+        const int64_t dy{ -std::abs(int64_t(y1) - int64_t(y0)) };
+        const int64_t sx{ x0 < x1 ? 1 : -1 }, sy{ y0 < y1 ? 1 : -1 };
+        int64_t       x(x0), y(y0), err{ dx + dy };
+        while (true) {
+            _set(cell(x, y), wall);
+            if (x == int64_t(x1) && y == int64_t(y1))
+                break;
+            const auto e2{ 2 * err };
+            if (e2 >= dy) {
+                err += dy;
+                x += sx;
+            }
+            if (e2 <= dx) {
+                err += dx;
+                y += sy;
+            }
+        }
+        return _commit();
+    }
+    /*!
+     * \brief Set the wall of \a from, and of all the cells reached from it
+     * through side neighbours with the same wall as \a from.
+     */
+    [[maybe_unused]] size_t flood(T* from, bool wall) noexcept
+    {
+        if (nullptr == from || from->hasState(ICell::WALL) == wall)
+            return 0;
+
+        // Cells are edited when pushed, which keeps them from being pushed again
+        std::vector<T*> stack{ from };
+        _set(from, wall);
+        while (!std::empty(stack)) {
+            const auto cur{ stack.back() };
+            stack.pop_back();
+            for (auto [dx, dy] : { std::pair{ -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } })
+                if (auto next{ neighbour(cur, dx, dy) };
+                    nullptr != next && next->hasState(ICell::WALL) != wall) {
+                    _set(next, wall);
+                    stack.push_back(next);
+                }
+        }
+        return _commit();
+    }
+    /*!
+     * \brief Any other bulk edit : \a fn gets a function setting the wall of
+     * a cell, \a fn(cell, wall).
+     */
+    template<typename Fn>
+    [[maybe_unused]] size_t edit(Fn&& fn) noexcept
+    {
+        fn([this](T* c, bool wall) { _set(c, wall); });
+        return _commit();
+    }
+    Stamp copy(size_t x0, size_t y0, size_t x1, size_t y1) const noexcept
+    {
+        if (0 == _width || 0 == _height)
+            return {};
+
+        x1 = std::min(std::max(x0, x1), _width - 1);
+        y1 = std::min(std::max(y0, y1), _height - 1);
+        x0 = std::min(x0, x1);
+        y0 = std::min(y0, y1);
+
+        Stamp ret(x1 - x0 + 1, y1 - y0 + 1);
+        for (size_t j{ 0 }; j < ret.getHeight(); ++j)
+            for (size_t i{ 0 }; i < ret.getWidth(); ++i)
+                ret.setWall(i, j, cell(x0 + i, y0 + j)->hasState(ICell::WALL));
+        return ret;
+    }
+    /*!
+     * \brief Give the cells from (\a x, \a y) the walls of \a stamp, added
+     * or removed.
+     */
+    [[maybe_unused]] size_t paste(const Stamp& stamp, size_t x, size_t y) noexcept
+    {
+        for (size_t j{ 0 }; j < stamp.getHeight() && y + j < _height; ++j)
+            for (size_t i{ 0 }; i < stamp.getWidth() && x + i < _width; ++i)
+                _set(cell(x + i, y + j), stamp.wall(i, j));
+        return _commit();
+    }
+
+    /*!
+     * \brief Counter bumped every time the walls layout changes
+     */
+    auto version(void) const noexcept { return _version; }
+
+    /*!
+     * \brief Get the index of the cells edited since \a version, oldest first.
+     * \return false if these edits are not known anymore (too old, or the graph
+     * was cleared or resized) : derived data must then be rebuilt entirely.
+     */
+    [[maybe_unused]] bool editsSince(uint64_t version, std::vector<size_t>& out) const noexcept
+    {
+        if (version < _journalBase || version > _version)
+            return false;
+
+        out.clear();
+        auto it{ std::partition_point(std::begin(_journal), std::end(_journal), [=](auto& edit) {
+            return edit.first <= version;
+        }) };
+        for (; std::end(_journal) != it; ++it)
+            out.push_back(it->second);
+        return true;
     }
 
     auto getWidth(void) const noexcept { return _width; }
@@ -115,12 +323,95 @@ public:
 
     T* cell(size_t i, size_t j) const noexcept
     {
-        return (i < _width && j < _height) ? &_data.at(i + j * _width) : nullptr;
+        return (i < _width && j < _height) ? &_data.at(Layout::index(i, j, _width, _height))
+                                           : nullptr;
+    }
+
+    T* neighbour(const T* c, int dx, int dy) const noexcept
+    {
+        return cell(c->x() + dx, c->y() + dy);
+    }
+
+    size_t index(const T* c) const noexcept { return c->x() + c->y() * _width; }
+
+    /*!
+     * \brief Fingerprint (FNV-1a) of the size and walls layout, to check that
+     * data saved for a graph still matches it.
+     */
+    uint64_t wallsHash(void) const noexcept
+    {
+        uint64_t ret{ 0xcbf29ce484222325ULL };
+        auto     mix = [&ret](uint64_t v) {
+            ret ^= v;
+            ret *= 0x100000001b3ULL;
+        };
+
+        mix(_width);
+        mix(_height);
+        for (size_t j{ 0 }; j < _height; ++j)
+            for (size_t i{ 0 }; i < _width; ++i)
+                mix(cell(i, j)->hasState(ICell::WALL));
+        return ret;
     }
 
 protected:
     size_t                 _width, _height;
     mutable std::vector<T> _data;
+    uint64_t               _version{ 0 };
+
+    // Cells whose wall was toggled, with the version of their change. Every
+    // change after _journalBase is known.
+    std::vector<std::pair<uint64_t, size_t>> _journal;
+    uint64_t                                 _journalBase{ 0 };
+    std::vector<size_t>                      _pending; // Cells of the current change
+
+    static constexpr size_t JOURNAL_SIZE{ 4096 };
+
+private:
+    void _set(T* c, bool wall) noexcept
+    {
+        if (nullptr != c && (wall ? c->addState(ICell::WALL) : c->remState(ICell::WALL)))
+            _pending.push_back(index(c));
+    }
+
+    /*!
+     * \brief Publish the pending edits as one change. Changes too large for the
+     * journal make the derived data rebuild everything.
+     */
+    size_t _commit(void) noexcept
+    {
+        const auto ret{ std::size(_pending) };
+        if (0 == ret)
+            return 0;
+
+        if (ret > JOURNAL_SIZE / 4) {
+            _forget();
+        } else {
+            if (std::size(_journal) + ret > JOURNAL_SIZE) {
+                // Oldest changes first, whole, down to half the journal
+                const auto drop{ std::size(_journal) + ret - JOURNAL_SIZE / 2 };
+                const auto last{ _journal[drop - 1].first };
+                auto       kept{ std::begin(_journal) + drop };
+                while (std::end(_journal) != kept && last == kept->first)
+                    ++kept;
+                _journal.erase(std::begin(_journal), kept);
+                _journalBase = last;
+            }
+
+            ++_version;
+            for (auto idx : _pending)
+                _journal.emplace_back(_version, idx);
+        }
+        _pending.clear();
+        return ret;
+    }
+
+    void _forget(void) noexcept
+    {
+        ++_version;
+        _journal.clear();
+        _journalBase = _version;
+    }
 };
 
 }
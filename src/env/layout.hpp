@@ -0,0 +1,116 @@
+/**
+ * @file layout.hpp
+ * @brief Memory layouts of the cells of a graph
+ * @author lhm
+ */
+
+#ifndef SRC_ENV_LAYOUT_HPP
+#define SRC_ENV_LAYOUT_HPP
+
+// Standard headers
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace env {
+
+/*!
+ * A layout maps the coordinates of a cell to its position in the storage of a
+ * graph. It provides :
+ * - capacity(w, h) : number of stored cells, padding included
+ * - index(x, y, w, h) : storage position of a cell
+ * - coords(idx, w, h) : coordinates stored at a position (may be out of the
+ *   graph for padding)
+ */
+namespace layout {
+
+/*****************************************************************************/
+/*!
+ * \brief Rows one after the other : horizontal neighbours are contiguous,
+ * vertical ones are a whole row away.
+ */
+struct RowMajor
+{
+    static size_t capacity(size_t w, size_t h) noexcept { return w * h; }
+    static size_t index(size_t x, size_t y, size_t w, size_t) noexcept { return x + y * w; }
+    static std::pair<size_t, size_t> coords(size_t idx, size_t w, size_t) noexcept
+    {
+        return { idx % w, idx / w };
+    }
+};
+
+/*****************************************************************************/
+/*!
+ * \brief Square tiles of NxN cells, stored row-major inside and one after the
+ * other : every neighbour of a cell but the ones across a tile border is less
+ * than N rows away.
+ */
+template<size_t N = 32>
+struct Tiled
+{
+    static_assert(N > 0 && 0 == (N & (N - 1)), "Tiles size must be a power of 2");
+
+    static size_t tiles(size_t n) noexcept { return (n + N - 1) / N; }
+
+    static size_t capacity(size_t w, size_t h) noexcept { return tiles(w) * tiles(h) * N * N; }
+    static size_t index(size_t x, size_t y, size_t w, size_t) noexcept
+    {
+        return ((y / N) * tiles(w) + x / N) * N * N + (y % N) * N + x % N;
+    }
+    static std::pair<size_t, size_t> coords(size_t idx, size_t w, size_t) noexcept
+    {
+        const auto tile{ idx / (N * N) }, inside{ idx % (N * N) };
+        return { (tile % tiles(w)) * N + inside % N, (tile / tiles(w)) * N + inside / N };
+    }
+};
+
+/*****************************************************************************/
+/*!
+ * \brief Morton (Z-order) curve : the bits of x and y are interleaved, so that
+ * cells close on the grid are close in memory at every scale. The grid is
+ * padded to a power of 2 square.
+ */
+struct ZOrder
+{
+    static uint64_t spread(uint64_t v) noexcept
+    {
+        v &= 0xFFFFFFFF;
+        v = (v | (v << 16)) & 0x0000FFFF0000FFFFULL;
+        v = (v | (v << 8)) & 0x00FF00FF00FF00FFULL;
+        v = (v | (v << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+        v = (v | (v << 2)) & 0x3333333333333333ULL;
+        v = (v | (v << 1)) & 0x5555555555555555ULL;
+        return v;
+    }
+    static uint64_t compact(uint64_t v) noexcept
+    {
+        v &= 0x5555555555555555ULL;
+        v = (v | (v >> 1)) & 0x3333333333333333ULL;
+        v = (v | (v >> 2)) & 0x0F0F0F0F0F0F0F0FULL;
+        v = (v | (v >> 4)) & 0x00FF00FF00FF00FFULL;
+        v = (v | (v >> 8)) & 0x0000FFFF0000FFFFULL;
+        v = (v | (v >> 16)) & 0x00000000FFFFFFFFULL;
+        return v;
+    }
+
+    static size_t capacity(size_t w, size_t h) noexcept
+    {
+        size_t side{ 1 };
+        while (side < w || side < h)
+            side <<= 1;
+        return side * side;
+    }
+    static size_t index(size_t x, size_t y, size_t, size_t) noexcept
+    {
+        return spread(x) | (spread(y) << 1);
+    }
+    static std::pair<size_t, size_t> coords(size_t idx, size_t, size_t) noexcept
+    {
+        return { compact(idx), compact(idx >> 1) };
+    }
+};
+
+}
+}
+
+#endif // SRC_ENV_LAYOUT_HPP
@@ -0,0 +1,54 @@
+/**
+ * @file mapfile.cpp
+ * @brief Implementation of \a mapfile.hpp
+ * @author lhm
+ */
+
+// Standard headers
+#include <cstdlib>
+#include <fstream>
+
+// Project headers
+#include "mapfile.hpp"
+
+namespace env {
+
+/*****************************************************************************/
+template<typename T, typename Layout>
+bool
+loadMap(const std::string& file, Graph<T, Layout>& graph) noexcept
+{
+    std::ifstream ifs(file);
+    std::string   key, value;
+    size_t        width{ 0 }, height{ 0 };
+
+    while (ifs >> key && key != "map") {
+        if (!(ifs >> value))
+            return false;
+        if (key == "width")
+            width = std::strtoul(value.c_str(), nullptr, 10);
+        else if (key == "height")
+            height = std::strtoul(value.c_str(), nullptr, 10);
+    }
+    if (!ifs || 0 == width || 0 == height)
+        return false;
+
+    Stamp       walls(width, height);
+    std::string line;
+    for (size_t j{ 0 }; j < height; ++j) {
+        if (!(ifs >> line) || std::size(line) < width)
+            return false;
+
+        for (size_t i{ 0 }; i < width; ++i)
+            walls.setWall(i, j, '.' != line[i] && 'G' != line[i] && 'S' != line[i]);
+    }
+
+    // A single change, even when the graph keeps its size
+    graph.resize(width, height);
+    graph.paste(walls, 0, 0);
+    return true;
+}
+
+template bool loadMap<AStarCell, layout::RowMajor>(const std::string&,
+                                                   Graph<AStarCell, layout::RowMajor>&) noexcept;
+}
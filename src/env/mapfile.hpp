@@ -0,0 +1,35 @@
+/**
+ * @file mapfile.hpp
+ * @brief Loading of grid maps files
+ * @author lhm
+ */
+
+#ifndef SRC_ENV_MAPFILE_HPP
+#define SRC_ENV_MAPFILE_HPP
+
+// Standard headers
+#include <string>
+
+// Project's headers
+#include <env/graph.hpp>
+
+namespace env {
+
+/*****************************************************************************/
+/*!
+ * \brief Load a map in the Moving AI format :
+ *
+ *     type octile
+ *     height H
+ *     width W
+ *     map
+ *     H lines of W characters, '.', 'G' and 'S' being passable, walls otherwise
+ *
+ * \a graph is resized to the map.
+ * \return false if the file cannot be read or is malformed
+ */
+template<typename T, typename Layout>
+[[maybe_unused]] bool loadMap(const std::string& file, Graph<T, Layout>& graph) noexcept;
+}
+
+#endif // SRC_ENV_MAPFILE_HPP
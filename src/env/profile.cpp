@@ -0,0 +1,90 @@
+/**
+ * @file profile.cpp
+ * @brief Implementation of \a profile.hpp
+ * @author lhm
+ */
+
+// Standard headers
+#include <utility>
+
+// Project headers
+#include "profile.hpp"
+#include <utils/Trace.hpp>
+
+namespace env {
+
+/*****************************************************************************/
+template<typename T>
+void
+Profile<T>::update(const Graph<T>* graph) noexcept
+{
+    if (nullptr == graph || (graph == _graph && graph->version() == _version))
+        return;
+
+    const auto          width{ graph->getWidth() };
+    std::vector<size_t> edits;
+    if (graph != _graph || !graph->editsSince(_version, edits)) {
+        TRACE_SCOPE("Profile::rebuild");
+        _graph = graph;
+        _kinds.assign(width * graph->getHeight(), WALL);
+        _counts[WALL] = std::size(_kinds);
+        _counts[OPEN] = _counts[CORRIDOR] = 0;
+        for (size_t idx{ 0 }; idx < std::size(_kinds); ++idx)
+            _set(idx, _measure(idx));
+    } else {
+        // Edits are measured against the final layout, a cell toggled twice
+        // is measured twice to the same kind
+        for (auto idx : edits) {
+            const auto x{ idx % width };
+            _set(idx, _measure(idx));
+            if (x > 0)
+                _set(idx - 1, _measure(idx - 1));
+            if (x + 1 < width)
+                _set(idx + 1, _measure(idx + 1));
+            if (idx >= width)
+                _set(idx - width, _measure(idx - width));
+            if (idx + width < std::size(_kinds))
+                _set(idx + width, _measure(idx + width));
+        }
+    }
+    _version = graph->version();
+}
+
+/*****************************************************************************/
+template<typename T>
+double
+Profile<T>::corridors(void) const noexcept
+{
+    const auto free{ _counts[OPEN] + _counts[CORRIDOR] };
+    return 0 == free ? 0. : static_cast<double>(_counts[CORRIDOR]) / free;
+}
+
+/*****************************************************************************/
+template<typename T>
+typename Profile<T>::Kind
+Profile<T>::_measure(size_t idx) const noexcept
+{
+    const auto width{ _graph->getWidth() };
+    const auto cell{ _graph->cell(idx % width, idx / width) };
+    if (cell->hasState(ICell::WALL))
+        return WALL;
+
+    uint free{ 0 };
+    for (auto [dx, dy] : { std::pair{ -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } })
+        if (auto next{ _graph->neighbour(cell, dx, dy) }; next && !next->hasState(ICell::WALL))
+            ++free;
+    return free <= 2 ? CORRIDOR : OPEN;
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+Profile<T>::_set(size_t idx, Kind kind) noexcept
+{
+    --_counts[_kinds[idx]];
+    ++_counts[kind];
+    _kinds[idx] = kind;
+}
+
+template class Profile<AStarCell>;
+}
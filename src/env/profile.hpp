@@ -0,0 +1,58 @@
+/**
+ * @file profile.hpp
+ * @brief Shape of the walls layout of a graph
+ * @author lhm
+ */
+
+#ifndef SRC_ENV_PROFILE_HPP
+#define SRC_ENV_PROFILE_HPP
+
+// Standard headers
+#include <cstdint>
+#include <vector>
+
+// Project's headers
+#include <env/graph.hpp>
+
+namespace env {
+
+/*****************************************************************************/
+/*!
+ * \brief The Profile class measures how open a graph is : the share of free
+ * cells lying in corridors (at most 2 free cells among their 4 side
+ * neighbours : dead ends, corridors and their bends).
+ *
+ * It follows the walls journal of the graph : only the edited cells and their
+ * neighbours are measured again, unless the journal is lost.
+ */
+template<typename T>
+class Profile
+{
+public:
+    Profile() noexcept = default;
+    virtual ~Profile() noexcept = default;
+
+    void update(const Graph<T>* graph) noexcept;
+
+    double corridors(void) const noexcept;
+
+protected:
+    enum Kind : uint8_t
+    {
+        WALL,
+        OPEN,
+        CORRIDOR
+    };
+
+    Kind _measure(size_t idx) const noexcept;
+    void _set(size_t idx, Kind kind) noexcept;
+
+private:
+    const Graph<T>*   _graph{ nullptr };
+    uint64_t          _version{ 0 };
+    std::vector<Kind> _kinds;
+    size_t            _counts[3]{};
+};
+}
+
+#endif // SRC_ENV_PROFILE_HPP
@@ -0,0 +1,200 @@
+/**
+ * @file rectangles.cpp
+ * @brief Implementation of \a rectangles.hpp
+ * @author lhm
+ */
+
+// Standard headers
+#include <algorithm>
+
+// Project headers
+#include "rectangles.hpp"
+#include <utils/Trace.hpp>
+
+namespace env {
+
+/*****************************************************************************/
+template<typename T>
+void
+Rectangles<T>::update(const Graph<T>* graph) noexcept
+{
+    if (nullptr == graph || (graph == _graph && graph->version() == _version))
+        return;
+
+    std::vector<size_t> edits;
+    if (graph != _graph || !graph->editsSince(_version, edits) ||
+        count() > 2 * _built + 1024) {
+        _graph = graph;
+        _version = graph->version();
+        _rebuild();
+        return;
+    }
+
+    TRACE_SCOPE("Rectangles::repair");
+    const auto width{ _graph->getWidth() };
+    const auto height{ _graph->getHeight() };
+
+    // Edits are applied against the final layout : a cell toggled twice, or
+    // already covered by the repair of another edit, needs nothing
+    for (auto idx : edits) {
+        const uint32_t x(idx % width), y(idx / width);
+        Rect           area{ x, y, x, y };
+
+        if (_wall(x, y)) {
+            if (NONE == _owner[idx])
+                continue;
+            _release(_owner[idx], area);
+        } else {
+            if (NONE != _owner[idx])
+                continue;
+            if (x > 0 && NONE != _owner[idx - 1])
+                _release(_owner[idx - 1], area);
+            if (x + 1 < width && NONE != _owner[idx + 1])
+                _release(_owner[idx + 1], area);
+            if (y > 0 && NONE != _owner[idx - width])
+                _release(_owner[idx - width], area);
+            if (y + 1 < height && NONE != _owner[idx + width])
+                _release(_owner[idx + width], area);
+        }
+        _cover(area);
+    }
+
+    _version = _graph->version();
+}
+
+/*****************************************************************************/
+template<typename T>
+bool
+Rectangles<T>::perimeter(size_t idx) const noexcept
+{
+    const auto& r{ _rects[_owner[idx]] };
+    const auto  x{ idx % _graph->getWidth() };
+    const auto  y{ idx / _graph->getWidth() };
+    return x == r.x0 || x == r.x1 || y == r.y0 || y == r.y1;
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+Rectangles<T>::_rebuild(void) noexcept
+{
+    TRACE_SCOPE("Rectangles::rebuild");
+    const auto width{ _graph->getWidth() };
+    const auto height{ _graph->getHeight() };
+
+    _owner.assign(width * height, NONE);
+    _rects.clear();
+    _free.clear();
+    if (0 != width && 0 != height)
+        _cover({ 0, 0, static_cast<uint32_t>(width - 1), static_cast<uint32_t>(height - 1) });
+    _built = count();
+}
+
+/*****************************************************************************/
+/*!
+ * \brief Forget the rectangle \a id, its cells being free again, and extend
+ * \a area to hold it.
+ */
+template<typename T>
+void
+Rectangles<T>::_release(uint32_t id, Rect& area) noexcept
+{
+    const auto r{ _rects[id] };
+    const auto width{ _graph->getWidth() };
+
+    for (auto y{ r.y0 }; y <= r.y1; ++y)
+        std::fill_n(std::begin(_owner) + y * width + r.x0, r.x1 - r.x0 + 1, NONE);
+    _free.push_back(id);
+
+    area = { std::min(area.x0, r.x0),
+             std::min(area.y0, r.y0),
+             std::max(area.x1, r.x1),
+             std::max(area.y1, r.y1) };
+}
+
+/*****************************************************************************/
+/*!
+ * \brief Cover the free cells of \a area not in a rectangle yet, largest
+ * squares first : strips along the rows or the columns would leave almost no
+ * interior cell to skip. Each square is then grown to the right, then
+ * downwards, over such cells.
+ */
+template<typename T>
+void
+Rectangles<T>::_cover(const Rect& area) noexcept
+{
+    const auto width{ _graph->getWidth() };
+    auto       open = [&](uint32_t x, uint32_t y) {
+        return NONE == _owner[y * width + x] && !_wall(x, y);
+    };
+
+    // Side of the largest open square at the top-left of each cell
+    const size_t          w{ area.x1 - area.x0 + 1u }, h{ area.y1 - area.y0 + 1u };
+    std::vector<uint32_t> side(w * h, 0);
+    std::vector<uint32_t> anchors;
+    for (auto j{ h }; j-- > 0;)
+        for (auto i{ w }; i-- > 0;) {
+            if (!open(area.x0 + i, area.y0 + j))
+                continue;
+
+            const auto k{ j * w + i };
+            side[k] = 1;
+            if (i + 1 < w && j + 1 < h)
+                side[k] += std::min({ side[k + 1], side[k + w], side[k + w + 1] });
+            anchors.push_back(static_cast<uint32_t>(k));
+        }
+    std::stable_sort(std::begin(anchors), std::end(anchors), [&side](uint32_t a, uint32_t b) {
+        return side[a] > side[b];
+    });
+
+    auto column = [&](const Rect& r, uint32_t x) {
+        for (auto y{ r.y0 }; y <= r.y1; ++y)
+            if (!open(x, y))
+                return false;
+        return true;
+    };
+    auto row = [&](const Rect& r, uint32_t y) {
+        for (auto x{ r.x0 }; x <= r.x1; ++x)
+            if (!open(x, y))
+                return false;
+        return true;
+    };
+
+    for (auto k : anchors) {
+        const uint32_t x(area.x0 + k % w), y(area.y0 + k / w);
+        if (!open(x, y))
+            continue;
+
+        // Squares claimed before may have taken part of this one
+        Rect r{ x, y, x, y };
+        while (r.x1 - r.x0 + 1 < side[k] && column({ r.x0, r.y0, r.x1, r.y1 + 1 }, r.x1 + 1) &&
+               row(r, r.y1 + 1))
+            ++r.x1, ++r.y1;
+        while (r.x1 < area.x1 && column(r, r.x1 + 1))
+            ++r.x1;
+        while (r.y1 < area.y1 && row(r, r.y1 + 1))
+            ++r.y1;
+
+        uint32_t id(std::size(_rects));
+        if (!std::empty(_free)) {
+            id = _free.back();
+            _free.pop_back();
+            _rects[id] = r;
+        } else {
+            _rects.push_back(r);
+        }
+        for (auto j{ r.y0 }; j <= r.y1; ++j)
+            std::fill_n(std::begin(_owner) + j * width + r.x0, r.x1 - r.x0 + 1, id);
+    }
+}
+
+/*****************************************************************************/
+template<typename T>
+bool
+Rectangles<T>::_wall(size_t x, size_t y) const noexcept
+{
+    return _graph->cell(x, y)->hasState(ICell::WALL);
+}
+
+template class Rectangles<AStarCell>;
+}
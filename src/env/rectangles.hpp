@@ -0,0 +1,82 @@
+/**
+ * @file rectangles.hpp
+ * @brief Decomposition of the free cells into empty rectangles
+ * @author lhm
+ */
+
+#ifndef SRC_ENV_RECTANGLES_HPP
+#define SRC_ENV_RECTANGLES_HPP
+
+// Standard headers
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Project's headers
+#include <env/graph.hpp>
+
+namespace env {
+
+/*****************************************************************************/
+/*!
+ * \brief The Rectangles class covers the free cells of a graph with disjoint
+ * rectangles free of walls, the largest squares first, each one then grown
+ * as wide then as high as possible.
+ *
+ * It follows the walls journal of the graph (see \a update) :
+ * - a new wall splits its rectangle, whose area is covered again,
+ * - a removed wall merges the rectangles around it, whose area is covered
+ *   again together with the freed cell.
+ * Repairs only touch the rectangles around the edits. The whole graph is
+ * covered again when the journal is lost, or when repairs have made too many
+ * small rectangles.
+ */
+template<typename T>
+class Rectangles
+{
+public:
+    static constexpr uint32_t NONE{ std::numeric_limits<uint32_t>::max() };
+
+    struct Rect
+    {
+        uint32_t x0, y0, x1, y1; // Bounds, included
+    };
+
+public:
+    Rectangles() noexcept = default;
+    virtual ~Rectangles() noexcept = default;
+
+    void update(const Graph<T>* graph) noexcept;
+
+    /*!
+     * \brief Identifier of the rectangle of the cell at \a idx (row-major),
+     * \a NONE for walls.
+     */
+    uint32_t    id(size_t idx) const noexcept { return _owner[idx]; }
+    const Rect& rect(uint32_t id) const noexcept { return _rects[id]; }
+
+    /*!
+     * \brief Whether the cell at \a idx lies on the border of its rectangle.
+     */
+    bool perimeter(size_t idx) const noexcept;
+
+    size_t count(void) const noexcept { return std::size(_rects) - std::size(_free); }
+
+protected:
+    void _rebuild(void) noexcept;
+    void _release(uint32_t id, Rect& area) noexcept;
+    void _cover(const Rect& area) noexcept;
+    bool _wall(size_t x, size_t y) const noexcept;
+
+private:
+    const Graph<T>*       _graph{ nullptr };
+    uint64_t              _version{ 0 };
+    std::vector<uint32_t> _owner; // Rectangle of each cell
+    std::vector<Rect>     _rects;
+    std::vector<uint32_t> _free;       // Identifiers of released rectangles
+    size_t                _built{ 0 }; // Rectangles after the latest rebuild
+};
+
+}
+
+#endif // SRC_ENV_RECTANGLES_HPP
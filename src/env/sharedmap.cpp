@@ -0,0 +1,334 @@
+/**
+ * @file sharedmap.cpp
+ * @brief Implementation of \a sharedmap.hpp
+ * @author lhm
+ */
+
+// Standard headers
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+// Project headers
+#include "sharedmap.hpp"
+
+namespace env {
+
+constexpr uint32_t SHARED_MAGIC{ 0x50414d53 }; // "SMAP"
+constexpr uint64_t REMOVED{ ~0ULL };           // Generation of a segment given up
+
+// A writer dying while it publishes leaves the sequence odd : readers give up
+constexpr auto SYNC_TIMEOUT{ std::chrono::milliseconds(100) };
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "Shared memory requires address-free (lock-free) atomics");
+
+/*!
+ * Beginning of the segment, followed by the walls bitset.
+ */
+struct SharedMap::Header
+{
+    uint32_t              magic;
+    uint32_t              wordSize;
+    std::atomic<uint64_t> width, height;
+    std::atomic<uint64_t> sequence;
+    std::atomic<uint64_t> generation; // Bumped by each resize, REMOVED once unlinked
+    uint64_t              padding[3]; // Keep the bitset on its own cache line
+};
+
+/*****************************************************************************/
+SharedMap::~SharedMap() noexcept
+{
+    _unmap();
+}
+
+/*****************************************************************************/
+bool
+SharedMap::create(const std::string& name, size_t width, size_t height) noexcept
+{
+    if (_writer && name == _name)
+        return _resize(width, height);
+
+    _unmap();
+    _width = width;
+    _height = height;
+
+    const int fd{ shm_open(name.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0644) };
+    if (fd < 0 || !_map(fd, sizeof(Header) + _wordsCount() * sizeof(uint64_t), true)) {
+        _what = "Cannot create shared memory '" + name + "' : " + std::strerror(errno);
+        if (fd >= 0)
+            close(fd);
+        shm_unlink(name.c_str());
+        return false;
+    }
+    close(fd);
+
+    new (_header) Header{ SHARED_MAGIC, sizeof(uint64_t), { width }, { height }, { 0 }, { 0 }, {} };
+    for (size_t w{ 0 }; w < _wordsCount(); ++w)
+        new (&_words()[w]) std::atomic<uint64_t>(0);
+
+    _name = name;
+    _writer = true;
+    return true;
+}
+
+/*****************************************************************************/
+bool
+SharedMap::open(const std::string& name) noexcept
+{
+    _unmap();
+    _name = name;
+
+    struct stat st;
+    const int   fd{ shm_open(name.c_str(), O_RDONLY, 0) };
+    if (fd < 0 || fstat(fd, &st) < 0 || static_cast<size_t>(st.st_size) < sizeof(Header) ||
+        !_map(fd, st.st_size, false)) {
+        _what = "Cannot open shared memory '" + name + "' : " + std::strerror(errno);
+        if (fd >= 0)
+            close(fd);
+        return false;
+    }
+    close(fd);
+
+    // The size follows the generation it was published with
+    _generation = _header->generation.load(std::memory_order_acquire);
+    _width = _header->width.load(std::memory_order_relaxed);
+    _height = _header->height.load(std::memory_order_relaxed);
+    if (SHARED_MAGIC != _header->magic || sizeof(uint64_t) != _header->wordSize ||
+        REMOVED == _generation || _size < sizeof(Header) + _wordsCount() * sizeof(uint64_t)) {
+        _what = "Shared memory '" + name + "' does not hold a map";
+        _unmap();
+        return false;
+    }
+
+    return true;
+}
+
+/*****************************************************************************/
+template<typename T, typename Layout>
+void
+SharedMap::publish(const Graph<T, Layout>& graph) noexcept
+{
+    if (!_writer || graph.getWidth() != _width || graph.getHeight() != _height)
+        return;
+    if (&graph == _graph && graph.version() == _version)
+        return;
+
+    std::vector<size_t> edits;
+    const bool          full{ &graph != _graph || !graph.editsSince(_version, edits) };
+    auto                words{ _words() };
+    auto                wall = [&graph](size_t idx) {
+        return graph.cell(idx % graph.getWidth(), idx / graph.getWidth())->hasState(ICell::WALL);
+    };
+
+    // Odd sequence : readers know the walls are being edited
+    const auto seq{ _header->sequence.load(std::memory_order_relaxed) };
+    _header->sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    if (full) {
+        for (size_t w{ 0 }; w < _wordsCount(); ++w) {
+            uint64_t bits{ 0 };
+            for (size_t idx{ w * 64 }; idx < std::min((w + 1) * 64, _width * _height); ++idx)
+                bits |= static_cast<uint64_t>(wall(idx)) << (idx % 64);
+            words[w].store(bits, std::memory_order_relaxed);
+        }
+    } else {
+        for (auto idx : edits) {
+            const uint64_t mask{ 1ULL << (idx % 64) };
+            auto&          word{ words[idx / 64] };
+            const auto     bits{ word.load(std::memory_order_relaxed) };
+            word.store(wall(idx) ? bits | mask : bits & ~mask, std::memory_order_relaxed);
+        }
+    }
+
+    _header->sequence.store(seq + 2, std::memory_order_release);
+    _graph = &graph;
+    _version = graph.version();
+}
+
+/*****************************************************************************/
+template<typename T, typename Layout>
+bool
+SharedMap::sync(Graph<T, Layout>& graph) noexcept
+{
+    if (_writer || nullptr == _header)
+        return false;
+
+    if (_synced && &graph == _graph && graph.getWidth() == _width &&
+        graph.getHeight() == _height &&
+        _header->sequence.load(std::memory_order_acquire) == _version &&
+        _header->generation.load(std::memory_order_acquire) == _generation)
+        return false;
+
+    // Copy the walls until no publication happened meanwhile, mapping the
+    // segment again when it was resized
+    std::vector<uint64_t> snapshot;
+    uint64_t              seq;
+    const auto            deadline{ std::chrono::steady_clock::now() + SYNC_TIMEOUT };
+    while (true) {
+        seq = _header->sequence.load(std::memory_order_acquire);
+        if (seq & 1) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                _what = "Shared memory '" + _name + "' is still being published";
+                return false;
+            }
+            std::this_thread::yield();
+            continue;
+        }
+
+        const auto generation{ _header->generation.load(std::memory_order_acquire) };
+        if (REMOVED == generation) {
+            _what = "Shared memory '" + _name + "' was removed by its writer";
+            return false;
+        }
+        if (generation != _generation) {
+            if (const auto name{ _name }; !open(name))
+                return false;
+            continue;
+        }
+
+        snapshot.resize(_wordsCount());
+        auto words{ _words() };
+        for (size_t w{ 0 }; w < std::size(snapshot); ++w)
+            snapshot[w] = words[w].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (_header->sequence.load(std::memory_order_relaxed) == seq)
+            break;
+    }
+
+    const bool full{ !_synced || &graph != _graph || graph.getWidth() != _width ||
+                     graph.getHeight() != _height };
+    if (graph.getWidth() != _width || graph.getHeight() != _height)
+        graph.resize(_width, _height);
+
+    // Published as a single change of the graph
+    const auto changed{ graph.edit([&](auto&& setWall) {
+        for (size_t w{ 0 }; w < std::size(snapshot); ++w) {
+            // Only the bits that changed since the previous sync, unless starting over
+            auto diff{ full ? ~0ULL : snapshot[w] ^ _snapshot[w] };
+            for (; 0 != diff; diff &= diff - 1) {
+                const size_t idx{ w * 64 + __builtin_ctzll(diff) };
+                if (idx >= _width * _height)
+                    break;
+                setWall(graph.cell(idx % _width, idx / _width), snapshot[w] & (1ULL << (idx % 64)));
+            }
+        }
+    }) };
+
+    _snapshot = std::move(snapshot);
+    _graph = &graph;
+    _version = seq;
+    _synced = true;
+    return 0 != changed;
+}
+
+/*****************************************************************************/
+uint64_t
+SharedMap::sequence(void) const noexcept
+{
+    return nullptr == _header ? 0 : _header->sequence.load(std::memory_order_acquire) / 2;
+}
+
+/*****************************************************************************/
+/*!
+ * \brief Give the segment of the writer a new size, its walls all cleared, and
+ * bump its generation for the readers to map it again. The segment only grows,
+ * so that the readers' mappings stay valid until then.
+ */
+bool
+SharedMap::_resize(size_t width, size_t height) noexcept
+{
+    if (width == _width && height == _height)
+        return true;
+
+    const auto seq{ _header->sequence.load(std::memory_order_relaxed) };
+    _header->sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    const auto size{ sizeof(Header) + (width * height + 63) / 64 * sizeof(uint64_t) };
+    if (size > _size) {
+        const auto header{ _header };
+        const auto previous{ _size };
+        const int  fd{ shm_open(_name.c_str(), O_RDWR, 0) };
+        if (fd < 0 || !_map(fd, size, true)) {
+            _what = "Cannot resize shared memory '" + _name + "' : " + std::strerror(errno);
+            if (fd >= 0)
+                close(fd);
+            _header->sequence.store(seq + 2, std::memory_order_release);
+            return false;
+        }
+        close(fd);
+        munmap(header, previous);
+    }
+
+    _width = width;
+    _height = height;
+    for (size_t w{ 0 }; w < _wordsCount(); ++w)
+        new (&_words()[w]) std::atomic<uint64_t>(0);
+    _header->width.store(width, std::memory_order_relaxed);
+    _header->height.store(height, std::memory_order_relaxed);
+    _header->generation.fetch_add(1, std::memory_order_release);
+    _header->sequence.store(seq + 2, std::memory_order_release);
+
+    // Written again entirely by the next publication
+    _graph = nullptr;
+    return true;
+}
+
+/*****************************************************************************/
+bool
+SharedMap::_map(int fd, size_t size, bool writable) noexcept
+{
+    if (writable && ftruncate(fd, size) < 0)
+        return false;
+
+    const int prot{ writable ? PROT_READ | PROT_WRITE : PROT_READ };
+    auto      addr{ mmap(nullptr, size, prot, MAP_SHARED, fd, 0) };
+    if (MAP_FAILED == addr)
+        return false;
+
+    _header = static_cast<Header*>(addr);
+    _size = size;
+    return true;
+}
+
+/*****************************************************************************/
+void
+SharedMap::_unmap(void) noexcept
+{
+    // Readers still mapping the segment learn it is given up
+    if (nullptr != _header && _writer)
+        _header->generation.store(REMOVED, std::memory_order_release);
+    if (nullptr != _header)
+        munmap(_header, _size);
+    if (_writer && !std::empty(_name))
+        shm_unlink(_name.c_str());
+
+    _header = nullptr;
+    _size = 0;
+    _writer = false;
+    _synced = false;
+    _graph = nullptr;
+    _name.clear();
+    _snapshot.clear();
+}
+
+/*****************************************************************************/
+std::atomic<uint64_t>*
+SharedMap::_words(void) const noexcept
+{
+    return reinterpret_cast<std::atomic<uint64_t>*>(reinterpret_cast<char*>(_header) +
+                                                    sizeof(Header));
+}
+
+template void SharedMap::publish<AStarCell, layout::RowMajor>(
+  const Graph<AStarCell, layout::RowMajor>&) noexcept;
+template bool SharedMap::sync<AStarCell, layout::RowMajor>(
+  Graph<AStarCell, layout::RowMajor>&) noexcept;
+}
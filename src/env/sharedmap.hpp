@@ -0,0 +1,113 @@
+/**
+ * @file sharedmap.hpp
+ * @brief Publication of the walls of a graph in POSIX shared memory
+ * @author lhm
+ */
+
+#ifndef SRC_ENV_SHAREDMAP_HPP
+#define SRC_ENV_SHAREDMAP_HPP
+
+// Standard headers
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Project's headers
+#include <env/graph.hpp>
+
+namespace env {
+
+/*****************************************************************************/
+/*!
+ * \brief The SharedMap class shares the walls of a graph between processes :
+ * one writer \a create s a segment and \a publish es its graph in it, readers
+ * \a open it read-only and \a sync their own graph from it.
+ *
+ * Walls are stored as a bitset, row-major. The segment holds a sequence
+ * counter (seqlock) : odd while the writer edits the walls, bumped again once
+ * done. Readers never block the writer, they copy the walls and start again if
+ * the counter moved meanwhile. An unchanged counter means nothing to do, which
+ * only costs an atomic load.
+ *
+ * The header also holds the size of the map and a generation, bumped when the
+ * writer resizes the segment in place : readers then map it again. A segment
+ * given up by its writer is marked as such before being unlinked.
+ */
+class SharedMap
+{
+public:
+    SharedMap() noexcept = default;
+    virtual ~SharedMap() noexcept;
+
+    SharedMap(const SharedMap&) = delete;
+    SharedMap& operator=(const SharedMap&) = delete;
+
+    /*!
+     * \brief Create (or replace) the segment \a name ("/something") for a
+     * \a width x \a height graph, and become its writer. Called again with the
+     * same name, resize the segment, readers following.
+     */
+    [[maybe_unused]] bool create(const std::string& name, size_t width, size_t height) noexcept;
+
+    /*!
+     * \brief Map the segment \a name read-only.
+     */
+    [[maybe_unused]] bool open(const std::string& name) noexcept;
+
+    /*!
+     * \brief Write the walls of \a graph, only the ones edited since the
+     * previous call when its journal allows. Writer only.
+     */
+    template<typename T, typename Layout>
+    void publish(const Graph<T, Layout>& graph) noexcept;
+
+    /*!
+     * \brief Apply the walls of the segment to \a graph (resized if needed)
+     * through \a Graph::setWall, so that derived data sees them as edits.
+     * \a graph is left as is if the segment was removed, or stays odd (its
+     * writer died while publishing) for too long.
+     * \return true if \a graph changed
+     */
+    template<typename T, typename Layout>
+    [[maybe_unused]] bool sync(Graph<T, Layout>& graph) noexcept;
+
+    /*!
+     * \brief Number of publications so far
+     */
+    uint64_t sequence(void) const noexcept;
+
+    std::string name(void) const noexcept { return _name; }
+    size_t      getWidth(void) const noexcept { return _width; }
+    size_t      getHeight(void) const noexcept { return _height; }
+    std::string what(void) const noexcept { return _what; }
+
+protected:
+    struct Header;
+
+    bool _resize(size_t width, size_t height) noexcept;
+    bool _map(int fd, size_t size, bool writable) noexcept;
+    void _unmap(void) noexcept;
+
+    std::atomic<uint64_t>* _words(void) const noexcept;
+    size_t                 _wordsCount(void) const noexcept { return (_width * _height + 63) / 64; }
+
+protected:
+    std::string _name;
+    std::string _what;
+    Header*     _header{ nullptr };
+    size_t      _size{ 0 };
+    size_t      _width{ 0 }, _height{ 0 };
+    bool        _writer{ false };
+
+    // Writer : graph version published. Reader : sequence and generation synced.
+    const void* _graph{ nullptr };
+    uint64_t    _version{ 0 };
+    uint64_t    _generation{ 0 };
+    bool        _synced{ false };
+
+    std::vector<uint64_t> _snapshot;
+};
+}
+
+#endif // SRC_ENV_SHAREDMAP_HPP
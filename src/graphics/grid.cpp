@@ -5,9 +5,15 @@
  */
 
 // Standard headers
+#include <algorithm>
+#include <cmath>
 
 // Project headers
 #include "grid.hpp"
+#include "palette.hpp"
+#include <algo/distance.hpp>
+#include <utils/Memory.hpp>
+#include <utils/Trace.hpp>
 
 // External libs
 #include <SFML/Graphics.hpp>
@@ -39,11 +45,46 @@ Grid<T>::setCursor(T* cursor) noexcept
     _cursor = cursor;
 }
 
+/*****************************************************************************/
+template<typename T>
+void
+Grid<T>::setFlowField(const astar::FlowField<T>* flow) noexcept
+{
+    _flow = flow;
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+Grid<T>::setComponents(const Components<T>* components) noexcept
+{
+    _components = components;
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+Grid<T>::setPath(const astar::PathBuffer* path) noexcept
+{
+    _path = path;
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+Grid<T>::setAgents(const std::vector<T*>& agents) noexcept
+{
+    _agents.assign(std::begin(agents), std::end(agents));
+}
+
 /*****************************************************************************/
 template<typename T>
 void
 Grid<T>::draw(sf::RenderTarget& target, sf::RenderStates states) const
 {
+    TRACE_SCOPE("Grid::draw");
+    MEMORY_SCOPE(memory::RENDER);
+
     static Dims  graphSize{ 0, 0 };
     static float cell_width{ 0 };
     static float cell_height{ 0 };
@@ -86,6 +127,19 @@ Grid<T>::draw(sf::RenderTarget& target, sf::RenderStates states) const
             updateCellStyle(i, j);
         }
 
+    // The path goes over the cells it is made of, the ends excepted
+    const auto width{ _graph->getWidth() };
+    if (nullptr != _path && _path->contiguous()) {
+        const Color color(PATH_COLOR.r, PATH_COLOR.g, PATH_COLOR.b);
+        _path->forEach([&](uint32_t idx) {
+            const auto cell{ _graph->cell(idx % width, idx / width) };
+            if (nullptr == cell || cell->hasState(ICell::START_CELL | ICell::END_CELL))
+                return;
+            for (uint k{ 0 }; k < 4; ++k)
+                _vertexes[idx * 4 + k].color = color;
+        });
+    }
+
     target.draw(_vertexes.data(), std::size(_vertexes), sf::Quads, states);
 
     // Update and draw the grid
@@ -103,14 +157,75 @@ Grid<T>::draw(sf::RenderTarget& target, sf::RenderStates states) const
 
     target.draw(_grid.data(), std::size(_grid), sf::Lines, states);
 
-    // Update and draw the cursor
+    // Draw the other paths as polylines, one quad per segment
+    if (nullptr != _path && !_path->contiguous() && _path->size() > 1) {
+        const auto thickness{ std::min(cell_width, cell_height) / 4.f };
+        const auto color{ Color(PATH_COLOR.r, PATH_COLOR.g, PATH_COLOR.b) };
+        const auto center = [&](uint32_t idx) {
+            return Vector2f(cell_width * (idx % width + .5f), cell_height * (idx / width + .5f));
+        };
+
+        _segments.clear();
+        const auto& indices{ _path->indices() };
+        for (size_t k{ 1 }; k < std::size(indices); ++k) {
+            const auto from{ center(indices[k - 1]) };
+            const auto to{ center(indices[k]) };
+
+            auto length{ std::hypot(to.x - from.x, to.y - from.y) };
+            if (0 == length)
+                continue;
+
+            Vector2f normal{ (from.y - to.y) / length * thickness / 2.f,
+                             (to.x - from.x) / length * thickness / 2.f };
+            _segments.emplace_back(Vector2f(from.x + normal.x, from.y + normal.y), color);
+            _segments.emplace_back(Vector2f(to.x + normal.x, to.y + normal.y), color);
+            _segments.emplace_back(Vector2f(to.x - normal.x, to.y - normal.y), color);
+            _segments.emplace_back(Vector2f(from.x - normal.x, from.y - normal.y), color);
+        }
+        target.draw(_segments.data(), std::size(_segments), sf::Quads, states);
+    }
+
+    // Draw the agents, one inset quad each
+    if (!std::empty(_agents)) {
+        const auto inset{ std::min(cell_width, cell_height) / 5.f };
+
+        _agentQuads.clear();
+        for (size_t k{ 0 }; k < std::size(_agents); ++k) {
+            const auto color{ Color(static_cast<Uint8>(40 + (k * 97) % 200),
+                                    static_cast<Uint8>(40 + (k * 57) % 200),
+                                    static_cast<Uint8>(40 + (k * 31) % 200)) };
+            const auto left{ cell_width * _agents[k]->x() + inset };
+            const auto top{ cell_height * _agents[k]->y() + inset };
+            const auto right{ cell_width * (_agents[k]->x() + 1) - inset };
+            const auto bottom{ cell_height * (_agents[k]->y() + 1) - inset };
+
+            _agentQuads.emplace_back(Vector2f(left, top), color);
+            _agentQuads.emplace_back(Vector2f(left, bottom), color);
+            _agentQuads.emplace_back(Vector2f(right, bottom), color);
+            _agentQuads.emplace_back(Vector2f(right, top), color);
+        }
+        target.draw(_agentQuads.data(), std::size(_agentQuads), sf::Quads, states);
+    }
+
+    // Draw the cursor, a white cell with a green outline inside it
     if (nullptr != _cursor) {
-        sf::RectangleShape cursor(Vector2f(cell_width, cell_height));
-        cursor.setOutlineColor(Color::Green);
-        cursor.setOutlineThickness(-3.f);
-        cursor.setPosition(Vector2f(cell_width * _cursor->x(), cell_height * _cursor->y()));
+        const auto thickness{ 3.f };
+        const auto left{ cell_width * _cursor->x() }, top{ cell_height * _cursor->y() };
+        const auto right{ left + cell_width }, bottom{ top + cell_height };
+        const auto quad = [this](size_t k, float x0, float y0, float x1, float y1, Color c) {
+            _cursorQuads[k * 4] = sf::Vertex(Vector2f(x0, y0), c);
+            _cursorQuads[k * 4 + 1] = sf::Vertex(Vector2f(x0, y1), c);
+            _cursorQuads[k * 4 + 2] = sf::Vertex(Vector2f(x1, y1), c);
+            _cursorQuads[k * 4 + 3] = sf::Vertex(Vector2f(x1, y0), c);
+        };
 
-        target.draw(cursor, states);
+        _cursorQuads.resize(5 * 4);
+        quad(0, left, top, right, bottom, Color::White);
+        quad(1, left, top, right, top + thickness, Color::Green);
+        quad(2, left, bottom - thickness, right, bottom, Color::Green);
+        quad(3, left, top + thickness, left + thickness, bottom - thickness, Color::Green);
+        quad(4, right - thickness, top + thickness, right, bottom - thickness, Color::Green);
+        target.draw(_cursorQuads.data(), std::size(_cursorQuads), sf::Quads, states);
     }
 }
 
@@ -119,18 +234,20 @@ template<typename T>
 void
 Grid<T>::updateCellStyle(uint i, uint j) const noexcept
 {
-    auto      st{ _graph->cell(i, j)->getState() };
-    auto      idx{ (i + j * _graph->getWidth()) * 4 };
-    sf::Color color{ 200, 200, 200, 250 };
-
-    if (st & (ICell::START_CELL | ICell::END_CELL)) {
-        color = Color(220, 20, 20, 250);
-    } else if (st & ICell::PATH) {
-        color = Color(32, 32, 228);
-    } else if (st & ICell::WALL) {
-        color = Color::Black;
+    const auto cell{ _graph->cell(i, j) };
+    const auto idx{ (i + j * _graph->getWidth()) * 4 };
+    auto       area{ NO_AREA };
+    auto       distance{ -1.f };
+
+    if (nullptr != _components) {
+        area = _components->id(cell);
+    } else if (nullptr != _flow && _flow->valid() && 0 != _flow->maxDistance()) {
+        if (auto d{ _flow->distance(cell) }; astar::UNREACHABLE != d)
+            distance = static_cast<float>(d) / _flow->maxDistance();
     }
 
+    const auto rgba{ cellColor(cell->getState(), area, distance) };
+    const auto color{ Color(rgba.r, rgba.g, rgba.b, rgba.a) };
     for (auto it{ 0 }; it < 4; ++it)
         _vertexes[idx + it].color = color;
 }
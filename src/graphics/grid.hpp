@@ -10,8 +10,12 @@
 // Standard headers
 #include <memory>
 #include <type_traits>
+#include <vector>
 
 // Project's headers
+#include <algo/flowfield.hpp>
+#include <algo/pathbuffer.hpp>
+#include <env/components.hpp>
 #include <env/graph.hpp>
 
 // External headers
@@ -29,6 +33,23 @@ public:
 
     void setGraph(env::Graph<T>*) noexcept;
     void setCursor(T*) noexcept;
+    void setFlowField(const astar::FlowField<T>*) noexcept;
+    void setComponents(const env::Components<T>*) noexcept;
+
+    /*!
+     * \brief Draw the path held by \a path, read in place on every frame :
+     * over the cells when it is made of single moves, as segments joining the
+     * centers of its cells otherwise (any-angle or smoothed paths). nullptr or
+     * an empty buffer draws none.
+     */
+    void setPath(const astar::PathBuffer*) noexcept;
+
+    /*!
+     * \brief Draw moving agents, one color each, over their current cells.
+     * Agents keep their color as long as their rank does not change. An empty
+     * list removes them.
+     */
+    void setAgents(const std::vector<T*>&) noexcept;
 
 protected:
     virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
@@ -39,8 +60,15 @@ protected:
 protected:
     mutable std::vector<sf::Vertex> _vertexes;
     mutable std::vector<sf::Vertex> _grid;
+    mutable std::vector<sf::Vertex> _segments;
+    mutable std::vector<sf::Vertex> _agentQuads;
+    mutable std::vector<sf::Vertex> _cursorQuads;
+    std::vector<const T*>           _agents;
     env::Graph<T>*                  _graph{ nullptr };
     T*                              _cursor{ nullptr };
+    const astar::FlowField<T>*      _flow{ nullptr };
+    const env::Components<T>*       _components{ nullptr };
+    const astar::PathBuffer*        _path{ nullptr };
 };
 
 }
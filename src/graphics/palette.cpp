@@ -0,0 +1,46 @@
+/**
+ * @file palette.cpp
+ * @brief Implementation of \a palette.hpp
+ * @author lhm
+ */
+
+// Standard headers
+#include <algorithm>
+
+// Project headers
+#include "palette.hpp"
+#include <env/graph.hpp>
+
+using namespace env;
+
+namespace graphics {
+
+/*****************************************************************************/
+Rgba
+cellColor(int state, uint area, float distance) noexcept
+{
+    if (state & (ICell::START_CELL | ICell::END_CELL))
+        return { 220, 20, 20, 250 };
+    if (state & ICell::PATH)
+        return PATH_COLOR;
+    if (state & ICell::WALL)
+        return { 0, 0, 0, 255 };
+
+    // One arbitrary (but stable) color per connected area
+    if (NO_AREA != area)
+        return { static_cast<uint8_t>(110 + (area * 97) % 140),
+                 static_cast<uint8_t>(110 + (area * 57) % 140),
+                 static_cast<uint8_t>(110 + (area * 31) % 140),
+                 255 };
+
+    // Shade the cells from the goal (light) to the farthest ones (dark)
+    if (distance >= 0.f) {
+        const auto ratio{ std::min(1.f, distance) };
+        return { static_cast<uint8_t>(250 - 210 * ratio),
+                 static_cast<uint8_t>(230 - 140 * ratio),
+                 static_cast<uint8_t>(120 + 20 * ratio),
+                 255 };
+    }
+    return { 200, 200, 200, 250 };
+}
+}
@@ -0,0 +1,33 @@
+/**
+ * @file palette.hpp
+ * @brief Colors of the cells, shared by the window and the headless renderer
+ * @author lhm
+ */
+
+#ifndef SRC_GRAPHICS_PALETTE_HPP
+#define SRC_GRAPHICS_PALETTE_HPP
+
+// Standard headers
+#include <cstdint>
+#include <limits>
+
+namespace graphics {
+
+struct Rgba
+{
+    uint8_t r{ 0 }, g{ 0 }, b{ 0 }, a{ 255 };
+};
+
+constexpr uint NO_AREA{ std::numeric_limits<uint>::max() }; // As env::Components::NONE
+constexpr Rgba PATH_COLOR{ 32, 32, 228, 255 };
+
+/*****************************************************************************/
+/*!
+ * \brief Color of a cell in \a state : start and end cells, path and walls
+ * first, then its connected \a area, or its \a distance to the goal of a flow
+ * field as a fraction of the farthest one (negative when unknown).
+ */
+Rgba cellColor(int state, uint area = NO_AREA, float distance = -1.f) noexcept;
+}
+
+#endif // SRC_GRAPHICS_PALETTE_HPP
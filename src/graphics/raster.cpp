@@ -0,0 +1,489 @@
+/**
+ * @file raster.cpp
+ * @brief Implementation of \a raster.hpp
+ * @author lhm
+ */
+
+// Standard headers
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+
+// Project headers
+#include "raster.hpp"
+#include <algo/distance.hpp>
+#include <utils/Memory.hpp>
+#include <utils/Trace.hpp>
+
+using namespace env;
+
+namespace graphics {
+
+constexpr Rgba EXPLORED_COLOR{ 150, 200, 160, 255 };
+
+// Deflate lengths and distances : base value and extra bits of each code
+constexpr uint16_t LENGTH_BASE[]{ 3,  4,  5,  6,  7,  8,  9,   10,  11,  13,  15,  17,  19,  23, 27,
+                                  31, 35, 43, 51, 59, 67, 83, 99,  115, 131, 163, 195, 227, 258 };
+constexpr uint8_t  LENGTH_EXTRA[]{ 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                   2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+constexpr uint16_t DISTANCE_BASE[]{ 1,    2,    3,    4,    5,     7,     9,     13,
+                                    17,   25,   33,   49,   65,    97,    129,   193,
+                                    257,  385,  513,  769,  1025,  1537,  2049,  3073,
+                                    4097, 6145, 8193, 12289, 16385, 24577 };
+constexpr uint8_t  DISTANCE_EXTRA[]{ 0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+                                     6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+constexpr size_t   MAX_MATCH{ 258 };
+constexpr size_t   MAX_DISTANCE{ 32768 };
+
+/*****************************************************************************/
+/*!
+ * \brief Bits of a deflate stream, least significant first.
+ */
+class Bits
+{
+public:
+    Bits(std::vector<uint8_t>& out) noexcept
+      : _out{ out }
+    {}
+
+    void put(uint32_t value, uint count) noexcept
+    {
+        _acc |= uint64_t(value) << _count;
+        for (_count += count; _count >= 8; _count -= 8, _acc >>= 8)
+            _out.push_back(static_cast<uint8_t>(_acc));
+    }
+
+    // Huffman codes go most significant bit first
+    void code(uint32_t value, uint count) noexcept
+    {
+        uint32_t reversed{ 0 };
+        for (uint i{ 0 }; i < count; ++i)
+            reversed = (reversed << 1) | ((value >> i) & 1);
+        put(reversed, count);
+    }
+
+    void symbol(uint sym) noexcept
+    {
+        if (sym < 144)
+            code(0x30 + sym, 8);
+        else if (sym < 256)
+            code(0x190 + sym - 144, 9);
+        else if (sym < 280)
+            code(sym - 256, 7);
+        else
+            code(0xC0 + sym - 280, 8);
+    }
+
+    void flush(void) noexcept
+    {
+        if (0 != _count)
+            _out.push_back(static_cast<uint8_t>(_acc));
+        _acc = 0;
+        _count = 0;
+    }
+
+private:
+    std::vector<uint8_t>& _out;
+    uint64_t              _acc{ 0 };
+    uint                  _count{ 0 };
+};
+
+/*****************************************************************************/
+/*!
+ * \brief zlib stream of \a data, a single block with the fixed codes. The
+ * only matches looked for repeat the previous pixel or the row above, which
+ * is where grids repeat themselves.
+ */
+static std::vector<uint8_t>
+_deflate(const std::vector<uint8_t>& data, size_t stride) noexcept
+{
+    std::vector<uint8_t> out{ 0x78, 0x01 };
+    Bits                 bits(out);
+    const auto           size{ std::size(data) };
+
+    bits.put(1, 1); // Last block
+    bits.put(1, 2); // Fixed codes
+    for (size_t i{ 0 }; i < size;) {
+        size_t length{ 0 }, distance{ 0 };
+        for (auto d : { size_t(3), stride }) {
+            if (d > i || d > MAX_DISTANCE)
+                continue;
+
+            size_t len{ 0 };
+            while (len < MAX_MATCH && i + len < size && data[i + len] == data[i + len - d])
+                ++len;
+            if (len > length) {
+                length = len;
+                distance = d;
+            }
+        }
+
+        if (length < 3) {
+            bits.symbol(data[i++]);
+            continue;
+        }
+
+        auto l{ std::size(LENGTH_BASE) - 1 };
+        while (LENGTH_BASE[l] > length)
+            --l;
+        bits.symbol(257 + l);
+        bits.put(length - LENGTH_BASE[l], LENGTH_EXTRA[l]);
+
+        auto d{ std::size(DISTANCE_BASE) - 1 };
+        while (DISTANCE_BASE[d] > distance)
+            --d;
+        bits.code(d, 5);
+        bits.put(distance - DISTANCE_BASE[d], DISTANCE_EXTRA[d]);
+        i += length;
+    }
+    bits.symbol(256);
+    bits.flush();
+
+    uint32_t a{ 1 }, b{ 0 };
+    for (auto byte : data) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    for (auto shift : { 24, 16, 8, 0 })
+        out.push_back(static_cast<uint8_t>(((b << 16) | a) >> shift));
+    return out;
+}
+
+/*****************************************************************************/
+static uint32_t
+_crc32(const uint8_t* data, size_t size, uint32_t crc = 0) noexcept
+{
+    static const auto table{ [] {
+        std::array<uint32_t, 256> ret;
+        for (uint32_t n{ 0 }; n < 256; ++n) {
+            auto c{ n };
+            for (uint k{ 0 }; k < 8; ++k)
+                c = (c & 1) ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+            ret[n] = c;
+        }
+        return ret;
+    }() };
+
+    crc = ~crc;
+    for (size_t i{ 0 }; i < size; ++i)
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+/*****************************************************************************/
+static void
+_chunk(std::ofstream& ofs, const char* type, const std::vector<uint8_t>& data) noexcept
+{
+    auto u32 = [&ofs](uint32_t v) {
+        const char bytes[]{ char(v >> 24), char(v >> 16), char(v >> 8), char(v) };
+        ofs.write(bytes, 4);
+    };
+
+    u32(static_cast<uint32_t>(std::size(data)));
+    ofs.write(type, 4);
+    ofs.write(reinterpret_cast<const char*>(data.data()), std::size(data));
+    u32(_crc32(data.data(), std::size(data), _crc32(reinterpret_cast<const uint8_t*>(type), 4)));
+}
+
+/*****************************************************************************/
+bool
+Image::write(const std::string& file) const noexcept
+{
+    std::ofstream ofs(file, std::ios::binary | std::ios::trunc);
+    if (!ofs)
+        return false;
+
+    const auto png{ file.size() >= 4 && 0 == file.compare(file.size() - 4, 4, ".png") };
+    if (!png) {
+        char header[64];
+        const auto length{ snprintf(header, sizeof(header), "P6\n%zu %zu\n255\n", width, height) };
+        ofs.write(header, length);
+        ofs.write(reinterpret_cast<const char*>(pixels.data()), std::size(pixels));
+        return static_cast<bool>(ofs);
+    }
+
+    // Rows without filter, each one after a 0 byte
+    const auto           stride{ 1 + 3 * width };
+    std::vector<uint8_t> rows(stride * height, 0);
+    for (size_t j{ 0 }; j < height; ++j)
+        std::copy_n(pixels.data() + 3 * width * j, 3 * width, rows.data() + stride * j + 1);
+
+    std::vector<uint8_t> header(13, 0);
+    for (uint k{ 0 }; k < 4; ++k) {
+        header[k] = static_cast<uint8_t>(width >> (24 - 8 * k));
+        header[4 + k] = static_cast<uint8_t>(height >> (24 - 8 * k));
+    }
+    header[8] = 8; // Bits per channel
+    header[9] = 2; // RGB
+
+    ofs.write("\x89PNG\r\n\x1a\n", 8);
+    _chunk(ofs, "IHDR", header);
+    _chunk(ofs, "IDAT", _deflate(rows, stride));
+    _chunk(ofs, "IEND", {});
+    return static_cast<bool>(ofs);
+}
+
+/*****************************************************************************/
+/*!
+ * \brief Call \a fn with the index of every cell of the segment joining the
+ * cells \a from and \a to (Bresenham).
+ */
+template<typename Fn>
+static void
+_segment(size_t from, size_t to, size_t width, Fn&& fn) noexcept
+{
+    int64_t       x(from % width), y(from / width);
+    const int64_t x1(to % width), y1(to / width);
+    const int64_t dx{ std::abs(x1 - x) }, dy{ -std::abs(y1 - y) };
+    const int64_t sx{ x < x1 ? 1 : -1 }, sy{ y < y1 ? 1 : -1 };
+
+    for (auto err{ dx + dy };;) {
+        fn(y * width + x);
+        if (x == x1 && y == y1)
+            break;
+        const auto e2{ 2 * err };
+        if (e2 >= dy) {
+            err += dy;
+            x += sx;
+        }
+        if (e2 <= dx) {
+            err += dx;
+            y += sy;
+        }
+    }
+}
+
+/*****************************************************************************/
+template<typename T>
+Raster<T>::Raster(uint cellsPerPixel, uint pixelsPerCell, uint threads) noexcept
+  : _cellsPerPixel{ std::max(cellsPerPixel, 1u) }
+  , _pixelsPerCell{ cellsPerPixel > 1 ? 1u : std::max(pixelsPerCell, 1u) }
+  , _threads{ 0 != threads ? threads : std::max(std::thread::hardware_concurrency(), 1u) }
+{}
+
+/*****************************************************************************/
+template<typename T>
+void
+Raster<T>::setComponents(const Components<T>* components) noexcept
+{
+    _components = components;
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+Raster<T>::setFlowField(const astar::FlowField<T>* flow) noexcept
+{
+    _flow = flow;
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+Raster<T>::setPath(const astar::PathBuffer* path) noexcept
+{
+    _path = path;
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+Raster<T>::setExplored(const std::vector<T*>& cells) noexcept
+{
+    _exploredCells.assign(std::begin(cells), std::end(cells));
+}
+
+/*****************************************************************************/
+template<typename T>
+const Image&
+Raster<T>::render(const Graph<T>& graph) noexcept
+{
+    TRACE_SCOPE("Raster::render");
+    MEMORY_SCOPE(memory::RENDER);
+
+    const auto width{ graph.getWidth() }, height{ graph.getHeight() };
+    const auto n{ _cellsPerPixel }, p{ _pixelsPerCell };
+    _image.width = (width + n - 1) / n * p;
+    _image.height = (height + n - 1) / n * p;
+    _image.pixels.resize(_image.width * _image.height * 3);
+
+    _areas.clear();
+    if (nullptr != _components)
+        for (size_t j{ 0 }; j < height; ++j)
+            for (size_t i{ 0 }; i < width; ++i)
+                _areas.push_back(_components->id(graph.cell(i, j)));
+
+    _explored.clear();
+    if (!std::empty(_exploredCells)) {
+        _explored.resize(width * height, false);
+        for (auto c : _exploredCells)
+            if (c->x() < width && c->y() < height)
+                _explored[graph.index(c)] = true;
+    }
+
+    _onPath.clear();
+    if (nullptr != _path && _showPath && !_path->empty()) {
+        _onPath.resize(width * height, false);
+        const auto mark = [this](size_t idx) {
+            if (idx < std::size(_onPath))
+                _onPath[idx] = true;
+        };
+
+        if (_path->contiguous()) {
+            _path->forEach(mark);
+        } else {
+            const auto& indices{ _path->indices() };
+            for (size_t k{ 1 }; k < std::size(indices); ++k)
+                _segment(indices[k - 1], indices[k], width, mark);
+        }
+    }
+
+    const auto threads{ std::clamp<size_t>(_threads, 1, std::max<size_t>(_image.height, 1)) };
+    const auto band{ (_image.height + threads - 1) / threads };
+
+    std::vector<std::thread> workers;
+    for (size_t t{ 1 }; t < threads; ++t)
+        workers.emplace_back(
+          [&, t] { _band(graph, t * band, std::min(_image.height, (t + 1) * band)); });
+    _band(graph, 0, std::min(_image.height, band));
+
+    for (auto& w : workers)
+        w.join();
+    return _image;
+}
+
+/*****************************************************************************/
+template<typename T>
+size_t
+Raster<T>::progress(const Graph<T>&        graph,
+                    const std::vector<T*>& reached,
+                    uint                   frames,
+                    const std::string&     file) noexcept
+{
+    const auto dot{ file.rfind('.') };
+    const auto slash{ file.rfind('/') };
+    const auto split{ (std::string::npos == dot || (std::string::npos != slash && dot < slash))
+                        ? std::size(file)
+                        : dot };
+
+    const auto explored{ _exploredCells };
+    size_t     written{ 0 };
+    frames = std::max(frames, 1u);
+    for (uint k{ 1 }; k <= frames; ++k) {
+        const auto count{ std::size(reached) * k / frames };
+        _exploredCells.assign(std::begin(reached), std::begin(reached) + count);
+        _showPath = k == frames;
+        render(graph);
+
+        char suffix[16];
+        snprintf(suffix, sizeof(suffix), "-%04u", k);
+        if (!_image.write(file.substr(0, split) + suffix + file.substr(split)))
+            break;
+        ++written;
+    }
+
+    _exploredCells = explored;
+    _showPath = true;
+    return written;
+}
+
+/*****************************************************************************/
+template<typename T>
+void
+Raster<T>::_band(const Graph<T>& graph, size_t first, size_t last) noexcept
+{
+    for (size_t y{ first }; y < last; ++y)
+        for (size_t x{ 0 }; x < _image.width; ++x)
+            _pixel(graph, x, y, _image.pixels.data() + 3 * (y * _image.width + x));
+}
+
+/*****************************************************************************/
+/*!
+ * \brief Color of the pixel \a x, \a y : of its cell, or of the square of
+ * cells it stands for, start and end cells first, then the path, the average
+ * color otherwise.
+ */
+template<typename T>
+void
+Raster<T>::_pixel(const Graph<T>& graph, size_t x, size_t y, uint8_t* out) const noexcept
+{
+    auto put = [out](Rgba c) {
+        out[0] = c.r;
+        out[1] = c.g;
+        out[2] = c.b;
+    };
+
+    const auto n{ _cellsPerPixel };
+    if (1 == n) {
+        put(_color(graph, x / _pixelsPerCell, y / _pixelsPerCell));
+        return;
+    }
+
+    const auto x1{ std::min(graph.getWidth(), (x + 1) * n) };
+    const auto y1{ std::min(graph.getHeight(), (y + 1) * n) };
+    uint       sum[3]{ 0, 0, 0 }, count{ 0 };
+    bool       path{ false };
+
+    for (auto j{ y * n }; j < y1; ++j)
+        for (auto i{ x * n }; i < x1; ++i) {
+            const auto state{ _state(graph.cell(i, j), j * graph.getWidth() + i) };
+            if (state & (ICell::START_CELL | ICell::END_CELL)) {
+                put(cellColor(state));
+                return;
+            }
+            path |= 0 != (state & ICell::PATH);
+
+            const auto c{ _color(graph, i, j) };
+            sum[0] += c.r;
+            sum[1] += c.g;
+            sum[2] += c.b;
+            ++count;
+        }
+
+    if (path)
+        put(PATH_COLOR);
+    else
+        put({ static_cast<uint8_t>(sum[0] / count),
+              static_cast<uint8_t>(sum[1] / count),
+              static_cast<uint8_t>(sum[2] / count),
+              255 });
+}
+
+/*****************************************************************************/
+template<typename T>
+Rgba
+Raster<T>::_color(const Graph<T>& graph, size_t i, size_t j) const noexcept
+{
+    const auto cell{ graph.cell(i, j) };
+    const auto idx{ graph.index(cell) };
+    const auto state{ _state(cell, idx) };
+
+    auto distance{ -1.f };
+    if (std::empty(_areas) && nullptr != _flow && _flow->valid() && 0 != _flow->maxDistance()) {
+        if (auto d{ _flow->distance(cell) }; astar::UNREACHABLE != d)
+            distance = static_cast<float>(d) / _flow->maxDistance();
+    }
+
+    const auto drawn{ ICell::WALL | ICell::PATH | ICell::START_CELL | ICell::END_CELL };
+    if (!(state & drawn) && !std::empty(_explored) && _explored[idx])
+        return EXPLORED_COLOR;
+    return cellColor(state, std::empty(_areas) ? NO_AREA : _areas[idx], distance);
+}
+
+/*****************************************************************************/
+/*!
+ * \brief State of \a cell, on the path if it is drawn over it.
+ */
+template<typename T>
+int
+Raster<T>::_state(const T* cell, size_t idx) const noexcept
+{
+    const auto state{ cell->getState() };
+    return (!std::empty(_onPath) && _onPath[idx]) ? state | ICell::PATH : state;
+}
+
+template class Raster<AStarCell>;
+}
@@ -0,0 +1,114 @@
+/**
+ * @file raster.hpp
+ * @brief Rendering of the grid to image files, without any display
+ * @author lhm
+ */
+
+#ifndef SRC_GRAPHICS_RASTER_HPP
+#define SRC_GRAPHICS_RASTER_HPP
+
+// Standard headers
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Project's headers
+#include <algo/flowfield.hpp>
+#include <algo/pathbuffer.hpp>
+#include <env/components.hpp>
+#include <env/graph.hpp>
+#include <graphics/palette.hpp>
+
+namespace graphics {
+
+/*****************************************************************************/
+/*!
+ * \brief Pixels of an image, 3 bytes (red, green, blue) each, rows from top
+ * to bottom.
+ */
+struct Image
+{
+    size_t               width{ 0 };
+    size_t               height{ 0 };
+    std::vector<uint8_t> pixels;
+
+    /*!
+     * \brief Write the image as a PNG if \a file ends with ".png", as a binary
+     * PPM otherwise.
+     */
+    [[maybe_unused]] bool write(const std::string& file) const noexcept;
+};
+
+/*****************************************************************************/
+/*!
+ * \brief The Raster class draws a graph with the colors of the window (see
+ * \a cellColor) on the CPU only, for reports of batch runs on machines
+ * without a display.
+ *
+ * Large maps are drawn with one pixel per square of \a cellsPerPixel cells :
+ * start and end cells win, then the path, the other colors being averaged
+ * (walls darken the pixel). Small ones are enlarged to squares of \a
+ * pixelsPerCell pixels. The rows of the image are drawn by bands, one per
+ * thread.
+ */
+template<typename T>
+class Raster
+{
+public:
+    Raster(uint cellsPerPixel = 1, uint pixelsPerCell = 1, uint threads = 0) noexcept;
+    virtual ~Raster() noexcept = default;
+
+    void setComponents(const env::Components<T>*) noexcept;
+    void setFlowField(const astar::FlowField<T>*) noexcept;
+
+    /*!
+     * \brief Draw the path held by \a path : its cells when it is made of
+     * single moves, the cells under its segments otherwise.
+     */
+    void setPath(const astar::PathBuffer*) noexcept;
+
+    /*!
+     * \brief Draw \a cells as explored by a search, when free and not on the
+     * path. An empty list removes them.
+     */
+    void setExplored(const std::vector<T*>& cells) noexcept;
+
+    const Image& render(const env::Graph<T>&) noexcept;
+    const Image& image(void) const noexcept { return _image; }
+
+    /*!
+     * \brief Write \a frames images of a search reaching the cells of \a
+     * reached in this order (see \a astar::Impl::reached), the path showing on
+     * the last one only. Frame k is written to \a file with "-k" (4 digits)
+     * before its extension.
+     * \return the number of images written
+     */
+    size_t progress(const env::Graph<T>&,
+                    const std::vector<T*>& reached,
+                    uint                   frames,
+                    const std::string&     file) noexcept;
+
+protected:
+    void _band(const env::Graph<T>&, size_t first, size_t last) noexcept;
+    void _pixel(const env::Graph<T>&, size_t x, size_t y, uint8_t* out) const noexcept;
+    Rgba _color(const env::Graph<T>&, size_t i, size_t j) const noexcept;
+    int  _state(const T*, size_t idx) const noexcept;
+
+private:
+    uint _cellsPerPixel;
+    uint _pixelsPerCell;
+    uint _threads;
+    bool _showPath{ true };
+
+    const env::Components<T>*  _components{ nullptr };
+    const astar::FlowField<T>* _flow{ nullptr };
+    const astar::PathBuffer*   _path{ nullptr };
+    std::vector<const T*>      _exploredCells;
+    std::vector<bool>          _explored; // By index in the graph
+    std::vector<bool>          _onPath;   // By index in the graph
+    std::vector<uint>          _areas;    // Resolved before the bands, finds are not thread-safe
+    Image                      _image;
+};
+}
+
+#endif // SRC_GRAPHICS_RASTER_HPP
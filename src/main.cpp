@@ -19,7 +19,11 @@ help(void)
     std::cout << PROG_NAME << " : Path finder toy (SFML discover)\n\n"
               << "Usage: " << PROG_NAME << " [-opt val]\n"
               << "Options: \n\t" << CMDLINE_HELP << " : Display the help\n"
-              << "\n\t" << CMDLINE_CONF << " filename : Set configuration file\n\n";
+              << "\n\t" << CMDLINE_CONF << " filename : Set configuration file\n"
+              << "\n\t" << CMDLINE_RECORD << " filename : Record the inputs of the session\n"
+              << "\n\t" << CMDLINE_REPLAY << " filename : Replay a recorded session as fast as"
+              << " possible, then print the frame times\n"
+              << "\n\t" << CMDLINE_REALTIME << " : Replay with the recorded timing\n\n";
 }
 
 /*****************************************************************************/
@@ -40,6 +44,15 @@ main(int argc, char* argv[])
         return EXIT_FAILURE;
     }
 
+    if ((parser->cmdOptionExists(CMDLINE_RECORD) &&
+         !app.record(std::string(parser->getCmdOption(CMDLINE_RECORD)))) ||
+        (parser->cmdOptionExists(CMDLINE_REPLAY) &&
+         !app.replay(std::string(parser->getCmdOption(CMDLINE_REPLAY)),
+                     parser->cmdOptionExists(CMDLINE_REALTIME)))) {
+        std::cerr << app.what() << '\n';
+        return EXIT_FAILURE;
+    }
+
     while (app) {
         app.update();
         app.render();
@@ -0,0 +1,115 @@
+/**
+ * @file protocol.hpp
+ * @brief Binary protocol of the query server
+ * @author lhm
+ */
+
+#ifndef SRC_SERVER_PROTOCOL_HPP
+#define SRC_SERVER_PROTOCOL_HPP
+
+// Standard headers
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*!
+ * Every integer is a little-endian uint32.
+ *
+ * - On connection, the server sends a hello : MAGIC, width, height.
+ * - A request is : id, start x, start y, end x, end y. Clients may send many
+ *   requests without waiting for the answers (pipelining).
+ * - A response is : id, status, cost, number of moves, then the moves packed
+ *   two per byte (low nibble first), a move being an index in \a MOVES (see
+ *   moves.hpp). Responses may come in any order, \a id tells which request
+ *   they answer.
+ */
+namespace server {
+
+constexpr uint32_t MAGIC{ 0x31534650 }; // "PFS1"
+
+constexpr size_t HELLO_SIZE{ 12 };
+constexpr size_t REQUEST_SIZE{ 20 };
+constexpr size_t RESPONSE_SIZE{ 16 }; // Without the moves
+
+enum Status : uint32_t
+{
+    FOUND = 0,
+    NO_PATH = 1,
+    INVALID = 2 // Endpoints out of the map
+};
+
+struct Request
+{
+    uint32_t id, sx, sy, ex, ey;
+};
+
+struct Response
+{
+    uint32_t             id, status, cost;
+    std::vector<uint8_t> moves;
+};
+
+/*****************************************************************************/
+inline void
+put32(std::vector<uint8_t>& out, uint32_t v) noexcept
+{
+    for (int i{ 0 }; i < 4; ++i)
+        out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+}
+
+inline uint32_t
+get32(const uint8_t* in) noexcept
+{
+    return in[0] | (in[1] << 8) | (in[2] << 16) | (static_cast<uint32_t>(in[3]) << 24);
+}
+
+/*****************************************************************************/
+inline void
+encode(std::vector<uint8_t>& out, const Request& req) noexcept
+{
+    for (auto v : { req.id, req.sx, req.sy, req.ex, req.ey })
+        put32(out, v);
+}
+
+inline Request
+decodeRequest(const uint8_t* in) noexcept
+{
+    return { get32(in), get32(in + 4), get32(in + 8), get32(in + 12), get32(in + 16) };
+}
+
+/*****************************************************************************/
+inline void
+encode(std::vector<uint8_t>& out, const Response& res) noexcept
+{
+    for (auto v : { res.id, res.status, res.cost, static_cast<uint32_t>(std::size(res.moves)) })
+        put32(out, v);
+    for (size_t i{ 0 }; i < std::size(res.moves); i += 2)
+        out.push_back(res.moves[i] | (i + 1 < std::size(res.moves) ? res.moves[i + 1] << 4 : 0));
+}
+
+/*!
+ * \brief Decode the response at the beginning of \a in.
+ * \return The size of the response, 0 if \a size bytes do not hold all of it
+ */
+inline size_t
+decodeResponse(const uint8_t* in, size_t size, Response& res) noexcept
+{
+    if (size < RESPONSE_SIZE)
+        return 0;
+
+    const auto count{ get32(in + 12) };
+    const auto total{ RESPONSE_SIZE + (count + 1) / 2 };
+    if (size < total)
+        return 0;
+
+    res.id = get32(in);
+    res.status = get32(in + 4);
+    res.cost = get32(in + 8);
+    res.moves.resize(count);
+    for (uint32_t i{ 0 }; i < count; ++i)
+        res.moves[i] = (in[RESPONSE_SIZE + i / 2] >> (4 * (i % 2))) & 0xF;
+    return total;
+}
+}
+
+#endif // SRC_SERVER_PROTOCOL_HPP
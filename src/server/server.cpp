@@ -0,0 +1,385 @@
+/**
+ * @file server.cpp
+ * @brief Implementation of \a server.hpp
+ * @author lhm
+ */
+
+// Standard headers
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Project's headers
+#include "server.hpp"
+#include <algo/engines.hpp>
+#include <utils/Memory.hpp>
+#include <utils/Trace.hpp>
+
+// External headers
+#include <JSON.hpp>
+
+using namespace env;
+
+namespace server {
+
+constexpr size_t BATCH_SIZE{ 64 };    // Requests taken at once by a worker
+constexpr size_t READ_SIZE{ 1 << 16 }; // Bytes read at once from a connection
+
+/*****************************************************************************/
+Server::~Server() noexcept
+{
+    stop();
+    _close();
+}
+
+/*****************************************************************************/
+bool
+Server::configure(const Graph<AStarCell>& graph, const JSON::Object& conf, uint threads) noexcept
+{
+    std::string engine{ "astar" };
+    if (conf["engine"] && conf["engine"].isString())
+        engine = conf["engine"].asString();
+
+    _width = static_cast<uint32_t>(graph.getWidth());
+    _height = static_cast<uint32_t>(graph.getHeight());
+    _workers.clear();
+    for (uint i{ 0 }; i < std::max(threads, 1u); ++i) {
+        auto worker{ std::make_unique<Worker>() };
+        worker->graph = graph;
+        worker->graph.clean();
+        worker->engine = astar::create<AStarCell>(engine);
+
+        if (nullptr == worker->engine) {
+            _what = "Unknown engine '" + engine + "'";
+            return false;
+        }
+        if (!worker->engine->configure(conf)) {
+            _what = "Cannot configure the engine : wrong format";
+            return false;
+        }
+        if (worker->engine->anyAngle()) {
+            _what = "Any-angle engines are not supported : responses are made of moves";
+            return false;
+        }
+
+        // Build the data derived from the map (areas, landmarks, CPD...) now
+        // rather than on the first requests
+        for (size_t idx{ 0 }; idx < graph.getWidth() * graph.getHeight(); ++idx) {
+            auto c{ worker->graph.cell(idx % graph.getWidth(), idx / graph.getWidth()) };
+            if (!c->hasState(ICell::WALL)) {
+                worker->engine->run(&worker->graph, c, c);
+                break;
+            }
+        }
+        _workers.push_back(std::move(worker));
+    }
+
+    return true;
+}
+
+/*****************************************************************************/
+bool
+Server::follow(const std::string& name) noexcept
+{
+    for (auto& worker : _workers) {
+        worker->shared = std::make_unique<SharedMap>();
+        if (!worker->shared->open(name)) {
+            _what = worker->shared->what();
+            return false;
+        }
+        if (worker->shared->getWidth() != _width || worker->shared->getHeight() != _height) {
+            _what = "The shared map '" + name + "' does not have the size of the served map";
+            return false;
+        }
+        worker->shared->sync(worker->graph);
+    }
+
+    return true;
+}
+
+/*****************************************************************************/
+bool
+Server::listen(const std::string& path) noexcept
+{
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (std::size(path) >= sizeof(addr.sun_path)) {
+        _what = "Socket path too long";
+        return false;
+    }
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+    _close();
+    unlink(path.c_str());
+    _listener = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (_listener < 0 || bind(_listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        ::listen(_listener, SOMAXCONN) < 0 || pipe2(_wake, O_NONBLOCK | O_CLOEXEC) < 0) {
+        _what = std::string("Cannot listen on '") + path + "' : " + std::strerror(errno);
+        _close();
+        return false;
+    }
+    _path = path;
+
+    return true;
+}
+
+/*****************************************************************************/
+void
+Server::serve(void) noexcept
+{
+    if (_listener < 0)
+        return;
+
+    MEMORY_SCOPE(memory::SERVER);
+    _stop = false;
+    for (auto& worker : _workers)
+        worker->thread = std::thread(&Server::_work, this, std::ref(*worker));
+
+    std::vector<pollfd>   fds;
+    std::vector<uint64_t> ids;
+    std::vector<Job>      jobs;
+    while (!_stop) {
+        // Hand the answers of the workers to their connections
+        {
+            std::scoped_lock lock(_outMutex);
+            for (auto& [id, answers] : _outbox) {
+                if (auto it{ _connections.find(id) }; std::end(_connections) != it) {
+                    auto& out{ it->second.out };
+                    out.insert(std::end(out), std::begin(answers.bytes), std::end(answers.bytes));
+                    it->second.pending -= answers.count;
+                }
+            }
+            _outbox.clear();
+        }
+
+        fds.assign({ { _wake[0], POLLIN, 0 }, { _listener, POLLIN, 0 } });
+        ids.clear();
+        for (auto& [id, conn] : _connections) {
+            // A half-closed connection keeps signalling POLLIN at end of file
+            const short events =
+              (conn.closing ? 0 : POLLIN) | (std::empty(conn.out) ? 0 : POLLOUT);
+            fds.push_back({ conn.fd, events, 0 });
+            ids.push_back(id);
+        }
+
+        if (poll(fds.data(), std::size(fds), -1) < 0) {
+            if (EINTR == errno)
+                continue;
+            break;
+        }
+
+        if (fds[0].revents & POLLIN) {
+            char buf[64];
+            while (read(_wake[0], buf, sizeof(buf)) > 0) {}
+        }
+        if (fds[1].revents & POLLIN)
+            _accept();
+
+        jobs.clear();
+        for (size_t i{ 2 }; i < std::size(fds); ++i) {
+            auto& conn{ _connections.at(ids[i - 2]) };
+            // Once half-closed, a hang up means the answers cannot be delivered
+            bool alive{ !(fds[i].revents & (POLLERR | POLLNVAL)) &&
+                        !(conn.closing && (fds[i].revents & POLLHUP)) };
+            if (alive && (fds[i].revents & (POLLIN | POLLHUP)))
+                alive = _read(ids[i - 2], conn, jobs);
+            if (alive && (fds[i].revents & POLLOUT))
+                alive = _write(conn);
+            if (!alive || (conn.closing && 0 == conn.pending && std::empty(conn.out))) {
+                close(conn.fd);
+                _connections.erase(ids[i - 2]);
+            }
+        }
+
+        if (!std::empty(jobs)) {
+            {
+                std::scoped_lock lock(_jobsMutex);
+                _jobs.insert(std::end(_jobs), std::begin(jobs), std::end(jobs));
+            }
+            if (std::size(jobs) > BATCH_SIZE)
+                _jobsCond.notify_all();
+            else
+                _jobsCond.notify_one();
+        }
+    }
+
+    // Taking the lock makes sure no worker is between its check of _stop and
+    // its wait
+    {
+        std::scoped_lock lock(_jobsMutex);
+    }
+    _jobsCond.notify_all();
+    for (auto& worker : _workers)
+        if (worker->thread.joinable())
+            worker->thread.join();
+}
+
+/*****************************************************************************/
+void
+Server::stop(void) noexcept
+{
+    _stop = true;
+    _wakeUp();
+}
+
+/*****************************************************************************/
+void
+Server::_wakeUp(void) noexcept
+{
+    // A full pipe is fine : the connections thread is already woken up
+    if (_wake[1] >= 0)
+        while (write(_wake[1], "", 1) < 0 && EINTR == errno) {}
+}
+
+/*****************************************************************************/
+void
+Server::_work(Worker& worker) noexcept
+{
+    MEMORY_SCOPE(memory::SERVER);
+
+    std::vector<Job>      batch;
+    std::vector<uint8_t>  encoded;
+    Response              res;
+    std::vector<uint64_t> conns;
+
+    while (true) {
+        batch.clear();
+        {
+            std::unique_lock lock(_jobsMutex);
+            _jobsCond.wait(lock, [this] { return _stop || !std::empty(_jobs); });
+            if (_stop)
+                return;
+
+            const auto count{ std::min(std::size(_jobs), BATCH_SIZE) };
+            batch.assign(std::begin(_jobs), std::begin(_jobs) + count);
+            _jobs.erase(std::begin(_jobs), std::begin(_jobs) + count);
+        }
+
+        if (nullptr != worker.shared)
+            worker.shared->sync(worker.graph);
+
+        // Answer the whole batch before taking the output lock
+        std::vector<std::pair<uint64_t, Answers>> answers;
+        for (const auto& job : batch) {
+            _answer(worker, job.req, res);
+            if (std::empty(answers) || answers.back().first != job.conn)
+                answers.emplace_back(job.conn, Answers());
+            encode(answers.back().second.bytes, res);
+            ++answers.back().second.count;
+        }
+
+        {
+            std::scoped_lock lock(_outMutex);
+            for (auto& [conn, batchAnswers] : answers) {
+                auto& out{ _outbox[conn] };
+                out.bytes.insert(std::end(out.bytes),
+                                 std::begin(batchAnswers.bytes),
+                                 std::end(batchAnswers.bytes));
+                out.count += batchAnswers.count;
+            }
+        }
+        _wakeUp();
+    }
+}
+
+/*****************************************************************************/
+void
+Server::_answer(Worker& worker, const Request& req, Response& res) noexcept
+{
+    TRACE_SCOPE("Server::answer");
+
+    res.id = req.id;
+    res.cost = 0;
+    res.moves.clear();
+
+    auto start{ worker.graph.cell(req.sx, req.sy) };
+    auto end{ worker.graph.cell(req.ex, req.ey) };
+    if (nullptr == start || nullptr == end) {
+        res.status = INVALID;
+        return;
+    }
+    if (start->hasState(ICell::WALL) || end->hasState(ICell::WALL) ||
+        !worker.engine->run(&worker.graph, start, end)) {
+        res.status = NO_PATH;
+        return;
+    }
+
+    // Moves read straight from the runs of the engine's path
+    worker.engine->emit(worker.path);
+    worker.path.forEachMove([&res](uint move) { res.moves.push_back(static_cast<uint8_t>(move)); });
+    res.status = FOUND;
+    res.cost = end->_G;
+}
+
+/*****************************************************************************/
+void
+Server::_accept(void) noexcept
+{
+    int fd;
+    while ((fd = accept4(_listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+        auto& conn{ _connections[_nextConnection++] };
+        conn.fd = fd;
+        for (auto v : { MAGIC, _width, _height })
+            put32(conn.out, v);
+    }
+}
+
+/*****************************************************************************/
+bool
+Server::_read(uint64_t id, Connection& conn, std::vector<Job>& jobs) noexcept
+{
+    uint8_t buf[READ_SIZE];
+    ssize_t count;
+    while ((count = read(conn.fd, buf, sizeof(buf))) > 0)
+        conn.in.insert(std::end(conn.in), buf, buf + count);
+    if (count < 0 && EAGAIN != errno && EWOULDBLOCK != errno)
+        return false;
+
+    // Every complete request becomes a job, the remainder waits for more bytes.
+    // The requests pipelined before a half-close are still answered : the
+    // connection is closed once their responses are sent
+    size_t pos{ 0 };
+    for (; pos + REQUEST_SIZE <= std::size(conn.in); pos += REQUEST_SIZE)
+        jobs.push_back({ id, decodeRequest(conn.in.data() + pos) });
+    conn.in.erase(std::begin(conn.in), std::begin(conn.in) + pos);
+    conn.pending += pos / REQUEST_SIZE;
+    conn.closing = 0 == count;
+
+    return true;
+}
+
+/*****************************************************************************/
+bool
+Server::_write(Connection& conn) noexcept
+{
+    const auto count{ send(conn.fd, conn.out.data(), std::size(conn.out), MSG_NOSIGNAL) };
+    if (count < 0)
+        return EAGAIN == errno || EWOULDBLOCK == errno;
+
+    conn.out.erase(std::begin(conn.out), std::begin(conn.out) + count);
+    return true;
+}
+
+/*****************************************************************************/
+void
+Server::_close(void) noexcept
+{
+    for (auto& [id, conn] : _connections)
+        close(conn.fd);
+    _connections.clear();
+
+    for (auto fd : { _listener, _wake[0], _wake[1] })
+        if (fd >= 0)
+            close(fd);
+    _listener = _wake[0] = _wake[1] = -1;
+
+    if (!std::empty(_path))
+        unlink(_path.c_str());
+    _path.clear();
+}
+}
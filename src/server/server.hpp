@@ -0,0 +1,140 @@
+/**
+ * @file server.hpp
+ * @brief Path queries server over a Unix domain socket
+ * @author lhm
+ */
+
+#ifndef SRC_SERVER_SERVER_HPP
+#define SRC_SERVER_SERVER_HPP
+
+// Standard headers
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Project's headers
+#include <algo/astar.hpp>
+#include <env/graph.hpp>
+#include <env/sharedmap.hpp>
+#include <server/protocol.hpp>
+
+namespace JSON {
+class Object;
+}
+
+namespace server {
+
+/*****************************************************************************/
+/*!
+ * \brief The Server class answers the path requests of local clients (see
+ * protocol.hpp) on one map.
+ *
+ * One thread handles the connections, and gives the requests it reads to a
+ * pool of workers that take them by batches. Engines keep their search data in
+ * the cells, so every worker searches its own copy of the map.
+ */
+class Server
+{
+public:
+    Server() noexcept = default;
+    virtual ~Server() noexcept;
+
+    /*!
+     * \brief Create \a threads workers searching \a graph with the engine
+     * described by \a conf (same keys as the "analyzer" configuration).
+     */
+    [[maybe_unused]] bool configure(const env::Graph<env::AStarCell>& graph,
+                                    const JSON::Object&               conf,
+                                    uint                              threads) noexcept;
+
+    /*!
+     * \brief Keep the map of the workers in sync with the shared memory map
+     * \a name (see sharedmap.hpp) : edits published there are picked up before
+     * every batch of requests. Call after \a configure.
+     */
+    [[maybe_unused]] bool follow(const std::string& name) noexcept;
+
+    [[maybe_unused]] bool listen(const std::string& path) noexcept;
+
+    /*!
+     * \brief Answer the requests until \a stop is called.
+     */
+    void serve(void) noexcept;
+
+    /*!
+     * \brief Make \a serve return. Async-signal-safe : it only sets a flag
+     * and writes to a pipe.
+     */
+    void stop(void) noexcept;
+
+    std::string what(void) const noexcept { return _what; }
+
+protected:
+    struct Job
+    {
+        uint64_t conn;
+        Request  req;
+    };
+
+    struct Connection
+    {
+        int                  fd;
+        std::vector<uint8_t> in, out;
+        // Requests handed to the workers and not answered yet
+        size_t pending{ 0 };
+        // The peer shut its side down : close once everything is answered
+        bool closing{ false };
+    };
+
+    struct Answers
+    {
+        size_t               count{ 0 };
+        std::vector<uint8_t> bytes;
+    };
+
+    struct Worker
+    {
+        env::Graph<env::AStarCell>                   graph;
+        std::unique_ptr<astar::Impl<env::AStarCell>> engine;
+        astar::PathBuffer                            path{ astar::PathBuffer::RUNS };
+        std::unique_ptr<env::SharedMap>              shared;
+        std::thread                                  thread;
+    };
+
+    void _work(Worker&) noexcept;
+    void _answer(Worker&, const Request&, Response&) noexcept;
+    void _accept(void) noexcept;
+    bool _read(uint64_t id, Connection&, std::vector<Job>&) noexcept;
+    bool _write(Connection&) noexcept;
+    void _close(void) noexcept;
+    void _wakeUp(void) noexcept;
+
+protected:
+    std::string                              _what;
+    std::string                              _path;
+    int                                      _listener{ -1 };
+    int                                      _wake[2]{ -1, -1 };
+    std::atomic<bool>                        _stop{ false };
+    uint32_t                                 _width{ 0 }, _height{ 0 };
+    std::vector<std::unique_ptr<Worker>>     _workers;
+    std::unordered_map<uint64_t, Connection> _connections;
+    uint64_t                                 _nextConnection{ 0 };
+
+    // Requests waiting for a worker
+    std::mutex              _jobsMutex;
+    std::condition_variable _jobsCond;
+    std::deque<Job>         _jobs;
+
+    // Encoded responses waiting to be sent, by connection
+    std::mutex                            _outMutex;
+    std::unordered_map<uint64_t, Answers> _outbox;
+};
+}
+
+#endif // SRC_SERVER_SERVER_HPP
@@ -0,0 +1,279 @@
+/**
+ * @file Memory.cpp
+ * @brief Implementation of \a Memory.hpp, and of the global operator new
+ * counting the allocations
+ * @author lhm
+ */
+
+// Standard headers
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+// Project headers
+#include "Memory.hpp"
+
+namespace {
+
+struct Atomics
+{
+    std::atomic<uint64_t> count{ 0 };
+    std::atomic<uint64_t> bytes{ 0 };
+    std::atomic<uint64_t> live{ 0 };
+    std::atomic<uint64_t> peak{ 0 };
+};
+
+// Constant-initialized : counts the allocations of the static constructors too
+Atomics                        totals[memory::SUBSYSTEMS];
+thread_local memory::Subsystem current{ memory::OTHER };
+
+#ifndef PATH_FINDER_NO_ALLOCS
+/*!
+ * Blocks start with their size and subsystem, so that frees are charged to
+ * the subsystem which allocated them. The header keeps the alignment of
+ * operator new.
+ */
+struct alignas(std::max_align_t) Header
+{
+    uint64_t          size;
+    memory::Subsystem subsystem;
+};
+
+void*
+allocate(size_t size) noexcept
+{
+    auto header{ static_cast<Header*>(std::malloc(sizeof(Header) + size)) };
+    if (nullptr == header)
+        return nullptr;
+
+    header->size = size;
+    header->subsystem = current;
+
+    auto&      counters{ totals[current] };
+    const auto live{ counters.live.fetch_add(size, std::memory_order_relaxed) + size };
+    counters.count.fetch_add(1, std::memory_order_relaxed);
+    counters.bytes.fetch_add(size, std::memory_order_relaxed);
+    for (auto peak{ counters.peak.load(std::memory_order_relaxed) }; live > peak;)
+        if (counters.peak.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+            break;
+
+    return header + 1;
+}
+
+void
+release(void* ptr) noexcept
+{
+    if (nullptr == ptr)
+        return;
+
+    auto header{ static_cast<Header*>(ptr) - 1 };
+    totals[header->subsystem].live.fetch_sub(header->size, std::memory_order_relaxed);
+    std::free(header);
+}
+
+void*
+allocateOrThrow(size_t size)
+{
+    for (;;) {
+        if (auto ptr{ allocate(size) })
+            return ptr;
+        if (auto handler{ std::get_new_handler() })
+            handler();
+        else
+            throw std::bad_alloc();
+    }
+}
+#endif
+}
+
+#ifndef PATH_FINDER_NO_ALLOCS
+/*****************************************************************************/
+// Every form of the global operator new and delete not taking an alignment,
+// the others keep their default implementation
+void*
+operator new(size_t size)
+{
+    return allocateOrThrow(size);
+}
+
+void*
+operator new[](size_t size)
+{
+    return allocateOrThrow(size);
+}
+
+void*
+operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void*
+operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void
+operator delete(void* ptr) noexcept
+{
+    release(ptr);
+}
+
+void
+operator delete[](void* ptr) noexcept
+{
+    release(ptr);
+}
+
+void
+operator delete(void* ptr, size_t) noexcept
+{
+    release(ptr);
+}
+
+void
+operator delete[](void* ptr, size_t) noexcept
+{
+    release(ptr);
+}
+
+void
+operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    release(ptr);
+}
+
+void
+operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    release(ptr);
+}
+#endif
+
+namespace memory {
+
+/*****************************************************************************/
+const char*
+name(Subsystem subsystem) noexcept
+{
+    static const char* names[SUBSYSTEMS]{ "other", "search", "render", "server" };
+    return subsystem < SUBSYSTEMS ? names[subsystem] : "";
+}
+
+/*****************************************************************************/
+Counters
+counters(Subsystem subsystem) noexcept
+{
+    Counters ret;
+    if (subsystem >= SUBSYSTEMS)
+        return ret;
+
+    const auto& counters{ totals[subsystem] };
+    ret.count = counters.count.load(std::memory_order_relaxed);
+    ret.bytes = counters.bytes.load(std::memory_order_relaxed);
+    ret.live = counters.live.load(std::memory_order_relaxed);
+    ret.peak = counters.peak.load(std::memory_order_relaxed);
+    return ret;
+}
+
+/*****************************************************************************/
+void
+resetPeaks(void) noexcept
+{
+    for (auto& counters : totals)
+        counters.peak.store(counters.live.load(std::memory_order_relaxed),
+                            std::memory_order_relaxed);
+}
+
+/*****************************************************************************/
+Scope::Scope(Subsystem subsystem) noexcept
+  : _previous{ current }
+{
+    current = subsystem;
+}
+
+/*****************************************************************************/
+Scope::~Scope() noexcept
+{
+    current = _previous;
+}
+
+/*****************************************************************************/
+void*
+Arena::allocate(size_t bytes, size_t alignment) noexcept
+{
+    // Offset of the first address aligned from \a offset in \a block
+    const auto align = [alignment](const Block& block, size_t offset) {
+        const auto base{ reinterpret_cast<uintptr_t>(block.data.get()) };
+        return ((base + offset + alignment - 1) & ~(alignment - 1)) - base;
+    };
+
+    for (; _block < std::size(_blocks); ++_block, _offset = 0) {
+        const auto& block{ _blocks[_block] };
+        const auto  start{ align(block, _offset) };
+        if (start + bytes <= block.size) {
+            _offset = start + bytes;
+            _used += bytes;
+            return block.data.get() + start;
+        }
+    }
+
+    // The blocks of the previous rounds are all too small
+    const auto size{ std::max(_blockSize, bytes + alignment) };
+    _blocks.push_back({ std::make_unique<std::byte[]>(size), size });
+    _capacity += size;
+    _block = std::size(_blocks) - 1;
+
+    const auto start{ align(_blocks.back(), 0) };
+    _offset = start + bytes;
+    _used += bytes;
+    return _blocks.back().data.get() + start;
+}
+
+/*****************************************************************************/
+void
+Arena::reset(void) noexcept
+{
+    _block = 0;
+    _offset = 0;
+    _used = 0;
+}
+
+/*****************************************************************************/
+size_t
+Pool::_class(size_t bytes) noexcept
+{
+    size_t ret{ MIN_SHIFT };
+    while ((size_t{ 1 } << ret) < bytes)
+        ++ret;
+    return ret;
+}
+
+/*****************************************************************************/
+void*
+Pool::allocate(size_t bytes) noexcept
+{
+    const auto k{ _class(bytes) };
+    if (nullptr == _free[k])
+        return _arena.allocate(size_t{ 1 } << k);
+
+    auto ret{ _free[k] };
+    _free[k] = *static_cast<void**>(ret);
+    return ret;
+}
+
+/*****************************************************************************/
+void
+Pool::deallocate(void* ptr, size_t bytes) noexcept
+{
+    if (nullptr == ptr)
+        return;
+
+    const auto k{ _class(bytes) };
+    *static_cast<void**>(ptr) = _free[k];
+    _free[k] = ptr;
+}
+}
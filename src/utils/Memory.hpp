@@ -0,0 +1,234 @@
+/**
+ * @file Memory.hpp
+ * @brief Heap allocations counted by subsystem, arena and pool allocators
+ * @author lhm
+ */
+
+#ifndef SRC_UTILS_MEMORY_HPP
+#define SRC_UTILS_MEMORY_HPP
+
+// Standard headers
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+/*!
+ * MEMORY_SCOPE(subsystem) charges the heap allocations of the enclosing scope,
+ * on the calling thread, to \a subsystem. Scopes nest, the innermost one
+ * wins. Defining PATH_FINDER_NO_ALLOCS compiles the scopes out and leaves the
+ * global operator new alone : the counters then stay zero.
+ */
+#ifndef PATH_FINDER_NO_ALLOCS
+#define MEMORY_CAT_(a, b) a##b
+#define MEMORY_CAT(a, b) MEMORY_CAT_(a, b)
+#define MEMORY_SCOPE(subsystem) memory::Scope MEMORY_CAT(_memory_, __LINE__)(subsystem)
+#else
+#define MEMORY_SCOPE(subsystem)
+#endif
+
+namespace memory {
+
+enum Subsystem : uint8_t
+{
+    OTHER,
+    SEARCH, //!< Engines, flow fields, agents
+    RENDER, //!< Window and image rendering
+    SERVER, //!< Connections of the path server
+    SUBSYSTEMS
+};
+
+const char* name(Subsystem) noexcept;
+
+/*****************************************************************************/
+/*!
+ * \brief Heap allocations charged to a subsystem since the start of the
+ * program. \a live and \a peak count the bytes not freed yet, now and at
+ * worst.
+ */
+struct Counters
+{
+    uint64_t count{ 0 };
+    uint64_t bytes{ 0 };
+    uint64_t live{ 0 };
+    uint64_t peak{ 0 };
+};
+
+Counters counters(Subsystem) noexcept;
+
+/*!
+ * \brief Restart the peaks of every subsystem from their live bytes, to
+ * measure the peak of a phase of the program.
+ */
+void resetPeaks(void) noexcept;
+
+/*****************************************************************************/
+class Scope
+{
+public:
+    explicit Scope(Subsystem) noexcept;
+    ~Scope() noexcept;
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    Subsystem _previous;
+};
+
+/*****************************************************************************/
+/*!
+ * \brief The Arena class hands out memory by bumping an offset in blocks it
+ * keeps, for scratch data whose lifetime ends all at once (a search, a
+ * frame). Nothing is freed one by one : \a reset rewinds to the first block
+ * in O(1), the blocks being reused by the next round. Once the blocks cover
+ * the largest round, rounds do not allocate any more.
+ *
+ * Every container using the arena must be gone before \a reset.
+ */
+class Arena
+{
+public:
+    explicit Arena(size_t blockSize = 64 * 1024) noexcept
+      : _blockSize{ blockSize }
+    {}
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) noexcept;
+    void  reset(void) noexcept;
+
+    size_t used(void) const noexcept { return _used; }
+    size_t capacity(void) const noexcept { return _capacity; }
+
+private:
+    struct Block
+    {
+        std::unique_ptr<std::byte[]> data;
+        size_t                       size;
+    };
+
+    size_t             _blockSize;
+    std::vector<Block> _blocks;
+    size_t             _block{ 0 };  // Block allocated from
+    size_t             _offset{ 0 }; // In this block
+    size_t             _used{ 0 };
+    size_t             _capacity{ 0 };
+};
+
+/*****************************************************************************/
+/*!
+ * \brief The Pool class recycles the memory freed by node-based containers
+ * (lists, hash maps) : blocks are rounded to a power of two and kept on a free
+ * list of their size instead of going back to the heap. The memory comes from
+ * an arena which is never reset, so a container cleared and filled again the
+ * same way does not allocate.
+ */
+class Pool
+{
+public:
+    Pool() noexcept = default;
+
+    Pool(const Pool&) = delete;
+    Pool& operator=(const Pool&) = delete;
+
+    void* allocate(size_t bytes) noexcept;
+    void  deallocate(void*, size_t bytes) noexcept;
+
+    size_t capacity(void) const noexcept { return _arena.capacity(); }
+
+private:
+    static constexpr size_t MIN_SHIFT{ 4 }; // Room for the link of the free list
+
+    static size_t _class(size_t bytes) noexcept;
+
+    Arena                 _arena;
+    std::array<void*, 64> _free{}; // By power of two
+};
+
+/*****************************************************************************/
+/*!
+ * \brief Allocators of the standard containers drawing from an \a Arena (no
+ * deallocation) or from a \a Pool.
+ */
+template<typename T>
+struct ArenaAllocator
+{
+    using value_type = T;
+
+    ArenaAllocator(Arena& arena) noexcept
+      : arena{ &arena }
+    {}
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+      : arena{ other.arena }
+    {}
+
+    T* allocate(size_t n) noexcept
+    {
+        return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T*, size_t) noexcept {}
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept
+    {
+        return arena == other.arena;
+    }
+    template<typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const noexcept
+    {
+        return arena != other.arena;
+    }
+
+    Arena* arena;
+};
+
+template<typename T>
+struct PoolAllocator
+{
+    using value_type = T;
+
+    static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned types are not pooled");
+
+    PoolAllocator(Pool& pool) noexcept
+      : pool{ &pool }
+    {}
+    template<typename U>
+    PoolAllocator(const PoolAllocator<U>& other) noexcept
+      : pool{ other.pool }
+    {}
+
+    T*   allocate(size_t n) noexcept { return static_cast<T*>(pool->allocate(n * sizeof(T))); }
+    void deallocate(T* p, size_t n) noexcept { pool->deallocate(p, n * sizeof(T)); }
+
+    template<typename U>
+    bool operator==(const PoolAllocator<U>& other) const noexcept
+    {
+        return pool == other.pool;
+    }
+    template<typename U>
+    bool operator!=(const PoolAllocator<U>& other) const noexcept
+    {
+        return pool != other.pool;
+    }
+
+    Pool* pool;
+};
+
+template<typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+template<typename T>
+using PoolList = std::list<T, PoolAllocator<T>>;
+
+template<typename K, typename V>
+using PoolMap =
+  std::unordered_map<K, V, std::hash<K>, std::equal_to<K>, PoolAllocator<std::pair<const K, V>>>;
+}
+
+#endif // SRC_UTILS_MEMORY_HPP
@@ -0,0 +1,171 @@
+/**
+ * @file Session.cpp
+ * @brief Implementation of \a Session.hpp
+ * @author lhm
+ */
+
+// Standard headers
+#include <cstring>
+#include <iterator>
+
+// Project headers
+#include "Session.hpp"
+
+namespace session {
+
+constexpr char MAGIC[]{ "PFSESSION1" };
+
+/*****************************************************************************/
+static void
+_varint(std::vector<uint8_t>& out, uint64_t v) noexcept
+{
+    for (; v >= 0x80; v >>= 7)
+        out.push_back(static_cast<uint8_t>(v | 0x80));
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+/*****************************************************************************/
+static void
+_u16(std::vector<uint8_t>& out, uint16_t v) noexcept
+{
+    out.push_back(static_cast<uint8_t>(v));
+    out.push_back(static_cast<uint8_t>(v >> 8));
+}
+
+/*****************************************************************************/
+Recorder::~Recorder() noexcept
+{
+    _ofs.flush();
+}
+
+/*****************************************************************************/
+bool
+Recorder::open(const std::string& file) noexcept
+{
+    _ofs.open(file, std::ios::binary | std::ios::trunc);
+    if (!_ofs)
+        return false;
+
+    _ofs.write(MAGIC, sizeof(MAGIC) - 1);
+    _started = false;
+    return static_cast<bool>(_ofs);
+}
+
+/*****************************************************************************/
+void
+Recorder::frame(uint64_t ns, const std::vector<Input>& inputs) noexcept
+{
+    if (!_ofs.is_open())
+        return;
+
+    uint64_t us{ 0 };
+    if (_started)
+        us = (ns - _last) / 1000;
+    else
+        _last = ns;
+    _last += us * 1000; // Rounding errors do not add up
+    _started = true;
+
+    std::vector<uint8_t> out;
+    _varint(out, us);
+
+    for (const auto& input : inputs) {
+        out.push_back(input.type);
+        switch (input.type) {
+            case Input::MOUSE_ENTERED:
+            case Input::MOUSE_MOVED:
+                _u16(out, input.x);
+                _u16(out, input.y);
+                break;
+            case Input::BUTTON_PRESSED:
+            case Input::BUTTON_RELEASED:
+                out.push_back(static_cast<uint8_t>(input.code));
+                out.push_back(input.modifiers);
+                break;
+            case Input::KEY_RELEASED:
+                _u16(out, static_cast<uint16_t>(input.code));
+                break;
+            default:
+                break;
+        }
+    }
+    out.push_back(0);
+    _ofs.write(reinterpret_cast<const char*>(out.data()), std::size(out));
+}
+
+/*****************************************************************************/
+bool
+Player::open(const std::string& file) noexcept
+{
+    std::ifstream ifs(file, std::ios::binary);
+    _data.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    _pos = sizeof(MAGIC) - 1;
+    _ns = 0;
+    _frames = 0;
+
+    return std::size(_data) >= _pos && 0 == std::memcmp(_data.data(), MAGIC, _pos);
+}
+
+/*****************************************************************************/
+bool
+Player::next(uint64_t& ns, std::vector<Input>& inputs) noexcept
+{
+    const auto size{ std::size(_data) };
+    auto       u16 = [this]() {
+        const uint16_t v(_data[_pos] | _data[_pos + 1] << 8);
+        _pos += 2;
+        return v;
+    };
+
+    uint64_t us{ 0 };
+    for (uint shift{ 0 };; shift += 7) {
+        if (_pos >= size || shift > 63)
+            return false;
+        us |= uint64_t(_data[_pos] & 0x7F) << shift;
+        if (!(_data[_pos++] & 0x80))
+            break;
+    }
+
+    inputs.clear();
+    while (true) {
+        if (_pos >= size)
+            return false;
+
+        Input input{ static_cast<Input::Type>(_data[_pos++]) };
+        if (0 == input.type)
+            break;
+
+        switch (input.type) {
+            case Input::MOUSE_ENTERED:
+            case Input::MOUSE_MOVED:
+                if (_pos + 4 > size)
+                    return false;
+                input.x = u16();
+                input.y = u16();
+                break;
+            case Input::BUTTON_PRESSED:
+            case Input::BUTTON_RELEASED:
+                if (_pos + 2 > size)
+                    return false;
+                input.code = _data[_pos++];
+                input.modifiers = _data[_pos++];
+                break;
+            case Input::KEY_RELEASED:
+                if (_pos + 2 > size)
+                    return false;
+                input.code = static_cast<int16_t>(u16());
+                break;
+            case Input::MOUSE_LEFT:
+                break;
+            default:
+                return false;
+        }
+        inputs.push_back(input);
+    }
+
+    _ns += us * 1000;
+    ns = _ns;
+    ++_frames;
+    return true;
+}
+}
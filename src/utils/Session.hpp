@@ -0,0 +1,106 @@
+/**
+ * @file Session.hpp
+ * @brief Recording and replay of the inputs of an interactive session
+ * @author lhm
+ */
+
+#ifndef SRC_UTILS_SESSION_HPP
+#define SRC_UTILS_SESSION_HPP
+
+// Standard headers
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace session {
+
+/*****************************************************************************/
+/*!
+ * \brief An input of the application, independent of the window : mouse
+ * positions are fractions of the window size, in 1/65536.
+ */
+struct Input
+{
+    enum Type : uint8_t
+    {
+        MOUSE_ENTERED = 1,
+        MOUSE_MOVED,
+        MOUSE_LEFT,
+        BUTTON_PRESSED,
+        BUTTON_RELEASED,
+        KEY_RELEASED
+    };
+
+    enum Modifier : uint8_t
+    {
+        SHIFT = 1 << 0,
+        CONTROL = 1 << 1
+    };
+
+    Type     type;
+    uint16_t x{ 0 }, y{ 0 };  // Mouse events
+    int16_t  code{ 0 };       // Button or key
+    uint8_t  modifiers{ 0 };  // Button events
+};
+
+/*****************************************************************************/
+/*!
+ * \brief The Recorder class writes the inputs of each frame, and when the
+ * frame began, to a binary log.
+ *
+ * The log starts with a magic string, then holds for every frame its start
+ * (microseconds since the previous frame, LEB128) and its inputs (type and
+ * fields, little-endian), ended by a 0 byte : about 3 bytes per frame
+ * without inputs.
+ */
+class Recorder
+{
+public:
+    Recorder() noexcept = default;
+    ~Recorder() noexcept;
+
+    [[maybe_unused]] bool open(const std::string& file) noexcept;
+    bool                  isOpen(void) const noexcept { return _ofs.is_open(); }
+
+    /*!
+     * \brief Record the inputs of a frame which began at \a ns (nanoseconds).
+     */
+    void frame(uint64_t ns, const std::vector<Input>& inputs) noexcept;
+
+private:
+    std::ofstream _ofs;
+    uint64_t      _last{ 0 };
+    bool          _started{ false };
+};
+
+/*****************************************************************************/
+/*!
+ * \brief The Player class reads back the frames of a log written by a \a
+ * Recorder.
+ */
+class Player
+{
+public:
+    Player() noexcept = default;
+
+    [[maybe_unused]] bool open(const std::string& file) noexcept;
+
+    /*!
+     * \brief Read the next frame : when it began (nanoseconds since the first
+     * frame) and its inputs.
+     * \return false at the end of the log, or if it is truncated
+     */
+    bool next(uint64_t& ns, std::vector<Input>& inputs) noexcept;
+
+    size_t frames(void) const noexcept { return _frames; }
+
+private:
+    std::vector<uint8_t> _data;
+    size_t               _pos{ 0 };
+    uint64_t             _ns{ 0 };
+    size_t               _frames{ 0 };
+};
+}
+
+#endif // SRC_UTILS_SESSION_HPP
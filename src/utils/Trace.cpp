@@ -0,0 +1,201 @@
+/**
+ * @file Trace.cpp
+ * @brief Implementation of \a Trace.hpp
+ * @author lhm
+ */
+
+// Standard headers
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Project headers
+#include "Trace.hpp"
+
+namespace {
+
+constexpr size_t RING_SIZE{ 16384 };
+
+struct Event
+{
+    const char* name;
+    uint64_t    start, end;
+};
+
+/*!
+ * Events of a thread. Only its thread writes it, the lock is there for the
+ * dumps and is never contended otherwise.
+ */
+struct Ring
+{
+    uint32_t                     id;
+    std::atomic_flag             lock = ATOMIC_FLAG_INIT;
+    std::array<Event, RING_SIZE> events;
+    uint64_t                     count{ 0 };
+
+    void acquire(void) noexcept
+    {
+        while (lock.test_and_set(std::memory_order_acquire)) {}
+    }
+    void release(void) noexcept { lock.clear(std::memory_order_release); }
+};
+
+/*!
+ * Rings outlive their threads : the ring of a finished thread keeps its events
+ * and is handed over to the next new thread, so that short-lived workers do not
+ * make the rings pile up.
+ */
+struct Registry
+{
+    std::mutex                         mutex;
+    std::vector<std::unique_ptr<Ring>> rings;
+    std::vector<Ring*>                 free;
+};
+
+Registry&
+registry(void) noexcept
+{
+    static Registry instance;
+    return instance;
+}
+
+struct Holder
+{
+    Ring* ring{ nullptr };
+
+    ~Holder() noexcept
+    {
+        if (nullptr != ring) {
+            auto&            reg{ registry() };
+            std::scoped_lock lock(reg.mutex);
+            reg.free.push_back(ring);
+        }
+    }
+};
+
+Ring*
+localRing(void) noexcept
+{
+    thread_local Holder holder;
+    if (nullptr == holder.ring) {
+        auto&            reg{ registry() };
+        std::scoped_lock lock(reg.mutex);
+        if (!std::empty(reg.free)) {
+            holder.ring = reg.free.back();
+            reg.free.pop_back();
+        } else {
+            reg.rings.push_back(std::make_unique<Ring>());
+            holder.ring = reg.rings.back().get();
+            holder.ring->id = static_cast<uint32_t>(std::size(reg.rings));
+        }
+    }
+    return holder.ring;
+}
+
+std::atomic<bool> _enabled{ true };
+const auto        _epoch{ std::chrono::steady_clock::now() };
+
+/*!
+ * Copy the events of every ring, oldest first in each ring, and give them to
+ * \a out(ring id, event).
+ */
+template<typename Out>
+void
+collect(Out&& out) noexcept
+{
+    auto&            reg{ registry() };
+    std::scoped_lock lock(reg.mutex);
+    for (auto& ring : reg.rings) {
+        std::vector<Event> events;
+        ring->acquire();
+        const auto count{ std::min<uint64_t>(ring->count, RING_SIZE) };
+        for (uint64_t i{ ring->count - count }; i < ring->count; ++i)
+            events.push_back(ring->events[i % RING_SIZE]);
+        ring->release();
+
+        for (const auto& ev : events)
+            out(ring->id, ev);
+    }
+}
+}
+
+namespace trace {
+
+/*****************************************************************************/
+uint64_t
+now(void) noexcept
+{
+    // Never 0, which stands for "not recording" in Scope
+    return 1 + std::chrono::duration_cast<std::chrono::nanoseconds>(
+                 std::chrono::steady_clock::now() - _epoch)
+                 .count();
+}
+
+/*****************************************************************************/
+void
+enable(bool on) noexcept
+{
+    _enabled.store(on, std::memory_order_relaxed);
+}
+
+/*****************************************************************************/
+bool
+enabled(void) noexcept
+{
+    return _enabled.load(std::memory_order_relaxed);
+}
+
+/*****************************************************************************/
+void
+record(const char* name, uint64_t start, uint64_t end) noexcept
+{
+    auto ring{ localRing() };
+    ring->acquire();
+    ring->events[ring->count++ % RING_SIZE] = { name, start, end };
+    ring->release();
+}
+
+/*****************************************************************************/
+bool
+dumpChrome(const std::string& file) noexcept
+{
+    std::ofstream ofs(file, std::ios::trunc);
+    if (!ofs)
+        return false;
+
+    // Complete events ("X"), timestamps in microseconds
+    bool first{ true };
+    ofs << std::fixed << std::setprecision(3) << "{\"traceEvents\":[\n";
+    collect([&ofs, &first](uint32_t id, const Event& ev) {
+        ofs << (first ? "" : ",\n") << "{\"name\":\"" << ev.name
+            << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << id << ",\"ts\":" << ev.start / 1000.
+            << ",\"dur\":" << (ev.end - ev.start) / 1000. << '}';
+        first = false;
+    });
+    ofs << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    return static_cast<bool>(ofs);
+}
+
+/*****************************************************************************/
+bool
+dumpCsv(const std::string& file) noexcept
+{
+    std::ofstream ofs(file, std::ios::trunc);
+    if (!ofs)
+        return false;
+
+    ofs << std::fixed << std::setprecision(3) << "thread,name,start_us,duration_us\n";
+    collect([&ofs](uint32_t id, const Event& ev) {
+        ofs << id << ',' << ev.name << ',' << ev.start / 1000. << ',' << (ev.end - ev.start) / 1000.
+            << '\n';
+    });
+
+    return static_cast<bool>(ofs);
+}
+}
@@ -0,0 +1,79 @@
+/**
+ * @file Trace.hpp
+ * @brief Scoped timers recorded in per-thread rings, dumped as Chrome trace
+ * @author lhm
+ */
+
+#ifndef SRC_UTILS_TRACE_HPP
+#define SRC_UTILS_TRACE_HPP
+
+// Standard headers
+#include <cstdint>
+#include <string>
+
+/*!
+ * TRACE_SCOPE(name) times the enclosing scope. \a name must be a string
+ * literal (only its address is stored). Defining PATH_FINDER_NO_TRACE compiles
+ * the timers out.
+ */
+#ifndef PATH_FINDER_NO_TRACE
+#define TRACE_CAT_(a, b) a##b
+#define TRACE_CAT(a, b) TRACE_CAT_(a, b)
+#define TRACE_SCOPE(name) trace::Scope TRACE_CAT(_trace_, __LINE__)(name)
+#else
+#define TRACE_SCOPE(name)
+#endif
+
+namespace trace {
+
+/*****************************************************************************/
+/*!
+ * \brief Nanoseconds elapsed since the start of the program.
+ */
+uint64_t now(void) noexcept;
+
+/*!
+ * \brief Turn the recording on or off at runtime (on by default). Disabled
+ * timers only cost a relaxed atomic load.
+ */
+void enable(bool) noexcept;
+bool enabled(void) noexcept;
+
+/*!
+ * \brief Append a timed event to the ring of the calling thread, overwriting
+ * the oldest one when full.
+ */
+void record(const char* name, uint64_t start, uint64_t end) noexcept;
+
+/*!
+ * \brief Write the events of every thread, either in the Chrome trace format
+ * (chrome://tracing, Perfetto) or as CSV (thread, name, start, duration in us).
+ */
+[[maybe_unused]] bool dumpChrome(const std::string& file) noexcept;
+[[maybe_unused]] bool dumpCsv(const std::string& file) noexcept;
+
+/*****************************************************************************/
+class Scope
+{
+public:
+    explicit Scope(const char* name) noexcept
+      : _name{ name }
+      , _start{ enabled() ? now() : 0 }
+    {}
+
+    ~Scope() noexcept
+    {
+        if (0 != _start)
+            record(_name, _start, now());
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    const char* _name;
+    uint64_t    _start;
+};
+}
+
+#endif // SRC_UTILS_TRACE_HPP
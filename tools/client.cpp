@@ -0,0 +1,175 @@
+/**
+ * @file client.cpp
+ * @brief Load test client of the path queries server
+ * @author lhm
+ */
+
+// Standard headers
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdlib.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// Project headers
+#include <server/protocol.hpp>
+#include <utils/CmdLineParser.hpp>
+
+using Clock = std::chrono::steady_clock;
+
+/*!
+ * What a connection measured.
+ */
+struct Result
+{
+    std::vector<double> latencies; // Microseconds
+    uint64_t            found{ 0 };
+    bool                ok{ false };
+};
+
+/*****************************************************************************/
+static void
+help(void)
+{
+    std::cout << PROG_NAME << " : Load test of the path queries server\n\n"
+              << "Usage: " << PROG_NAME << " [-opt val]\n"
+              << "Options: \n\t-h : Display the help\n"
+              << "\n\t-s path : Socket path (default : /tmp/path_finder_server.sock)"
+              << "\n\t-n count : Requests per connection (default : 10000)"
+              << "\n\t-c count : Concurrent connections (default : 4)"
+              << "\n\t-p count : Requests in flight per connection (default : 32)\n\n";
+}
+
+/*****************************************************************************/
+static bool
+readAll(int fd, uint8_t* buf, size_t size) noexcept
+{
+    while (size > 0) {
+        const auto count{ read(fd, buf, size) };
+        if (count <= 0)
+            return false;
+        buf += count;
+        size -= count;
+    }
+    return true;
+}
+
+/*****************************************************************************/
+static void
+run(const std::string& path, uint requests, uint depth, uint seed, Result& result) noexcept
+{
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+    const int fd{ socket(AF_UNIX, SOCK_STREAM, 0) };
+    uint8_t   hello[server::HELLO_SIZE];
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        !readAll(fd, hello, sizeof(hello)) || server::MAGIC != server::get32(hello)) {
+        if (fd >= 0)
+            close(fd);
+        return;
+    }
+
+    std::mt19937                            rng(seed);
+    std::uniform_int_distribution<uint32_t> x(0, server::get32(hello + 4) - 1);
+    std::uniform_int_distribution<uint32_t> y(0, server::get32(hello + 8) - 1);
+    std::vector<Clock::time_point>          sent(requests);
+    std::vector<uint8_t>                    out, in;
+    uint8_t                                 buf[1 << 16];
+    uint32_t                                next{ 0 }, done{ 0 };
+    server::Response                        res;
+
+    result.latencies.reserve(requests);
+    while (done < requests) {
+        // Keep the pipeline full
+        out.clear();
+        for (; next < requests && next - done < depth; ++next) {
+            server::encode(out, server::Request{ next, x(rng), y(rng), x(rng), y(rng) });
+            sent[next] = Clock::now();
+        }
+        if (!std::empty(out) && send(fd, out.data(), std::size(out), MSG_NOSIGNAL) < 0)
+            break;
+
+        const auto count{ read(fd, buf, sizeof(buf)) };
+        if (count <= 0)
+            break;
+        in.insert(std::end(in), buf, buf + count);
+
+        size_t pos{ 0 }, size;
+        while (0 != (size = server::decodeResponse(in.data() + pos, std::size(in) - pos, res))) {
+            pos += size;
+            ++done;
+            result.found += (server::FOUND == res.status);
+            result.latencies.push_back(
+              std::chrono::duration<double, std::micro>(Clock::now() - sent[res.id]).count());
+        }
+        in.erase(std::begin(in), std::begin(in) + pos);
+    }
+
+    result.ok = (done == requests);
+    close(fd);
+}
+
+/*****************************************************************************/
+int
+main(int argc, char* argv[])
+{
+    CmdLineParser parser(argc, argv);
+    if (parser.cmdOptionExists("-h")) {
+        help();
+        return EXIT_SUCCESS;
+    }
+
+    auto option = [&parser](const std::string& opt, uint value) -> uint {
+        return parser.cmdOptionExists(opt) ? std::stoul(std::string(parser.getCmdOption(opt)))
+                                           : value;
+    };
+    const std::string path{ parser.cmdOptionExists("-s") ? parser.getCmdOption("-s")
+                                                         : "/tmp/path_finder_server.sock" };
+    const uint requests{ std::max(option("-n", 10000), 1u) };
+    const uint connections{ std::max(option("-c", 4), 1u) };
+    const uint depth{ std::max(option("-p", 32), 1u) };
+
+    std::vector<Result>      results(connections);
+    std::vector<std::thread> threads;
+    const auto               start{ Clock::now() };
+    for (uint i{ 0 }; i < connections; ++i)
+        threads.emplace_back(run, path, requests, depth, i + 1, std::ref(results[i]));
+    for (auto& thread : threads)
+        thread.join();
+    const auto elapsed{ std::chrono::duration<double>(Clock::now() - start).count() };
+
+    std::vector<double> latencies;
+    uint64_t            found{ 0 };
+    for (const auto& res : results) {
+        if (!res.ok) {
+            std::cerr << "A connection failed (is the server running on " << path << " ?)\n";
+            return EXIT_FAILURE;
+        }
+        latencies.insert(std::end(latencies), std::begin(res.latencies), std::end(res.latencies));
+        found += res.found;
+    }
+    std::sort(std::begin(latencies), std::end(latencies));
+
+    auto percentile = [&latencies](double p) {
+        return latencies[std::min(std::size(latencies) - 1,
+                                  static_cast<size_t>(p * std::size(latencies)))];
+    };
+    std::cout << std::fixed << std::setprecision(1) << std::size(latencies) << " requests ("
+              << found << " paths found) in " << elapsed << " s : "
+              << std::size(latencies) / elapsed << " requests/s\n"
+              << "latency (us) : p50 " << percentile(0.5) << ", p99 " << percentile(0.99)
+              << ", max " << latencies.back() << '\n';
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file render.cpp
+ * @brief Rendering of maps and searches to image files, without any display
+ * @author lhm
+ */
+
+// Standard headers
+#include <cstdio>
+#include <iostream>
+#include <stdlib.h>
+#include <string>
+
+// Project headers
+#include <algo/engines.hpp>
+#include <env/mapfile.hpp>
+#include <graphics/raster.hpp>
+#include <utils/CmdLineParser.hpp>
+#include <utils/Json.hpp>
+
+// External headers
+#include <JSON.hpp>
+
+using namespace env;
+
+/*****************************************************************************/
+static void
+help(void)
+{
+    std::cout << PROG_NAME << " : Render a map, and a search on it, to a PNG or PPM image\n\n"
+              << "Usage: " << PROG_NAME << " -m map [-opt val]\n"
+              << "Options: \n\t-h : Display the help\n"
+              << "\n\t-m file : Map to load (Moving AI format)"
+              << "\n\t-o file : Image to write, PNG if it ends with .png, PPM otherwise"
+              << " (default : " << PROG_NAME << ".png)"
+              << "\n\t-q x0,y0,x1,y1 : Search to run and draw"
+              << "\n\t-i file : Configuration file, whose 'analyzer' object sets the engine"
+              << " (default : " << DEFAULT_CONF << ")"
+              << "\n\t-f count : Also write count frames of the search progress (astar engine)"
+              << "\n\t-c count : Cells per pixel, for large maps (default : 1)"
+              << "\n\t-z count : Pixels per cell, for small maps (default : 1)"
+              << "\n\t-t count : Threads (default : number of cores)"
+              << "\n\t-C : Color the connected areas\n\n";
+}
+
+/*****************************************************************************/
+static uint
+_option(const CmdLineParser& parser, const std::string& opt, uint def) noexcept
+{
+    return parser.cmdOptionExists(opt) ? std::stoul(std::string(parser.getCmdOption(opt))) : def;
+}
+
+/*****************************************************************************/
+int
+main(int argc, char* argv[])
+{
+    CmdLineParser parser(argc, argv);
+    if (parser.cmdOptionExists("-h") || !parser.cmdOptionExists("-m")) {
+        help();
+        return parser.cmdOptionExists("-h") ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    const std::string output{ parser.cmdOptionExists("-o") ? std::string(parser.getCmdOption("-o"))
+                                                           : PROG_NAME ".png" };
+
+    Graph<AStarCell> graph;
+    if (!loadMap(std::string(parser.getCmdOption("-m")), graph)) {
+        std::cerr << "Cannot load map '" << parser.getCmdOption("-m") << "'\n";
+        return EXIT_FAILURE;
+    }
+
+    graphics::Raster<AStarCell> raster(
+      _option(parser, "-c", 1), _option(parser, "-z", 1), _option(parser, "-t", 0));
+    Components<AStarCell> components;
+    astar::PathBuffer     path{ astar::PathBuffer::RUNS };
+    raster.setPath(&path);
+    if (parser.cmdOptionExists("-C")) {
+        components.update(&graph);
+        raster.setComponents(&components);
+    }
+
+    if (parser.cmdOptionExists("-q")) {
+        const std::string conf{ parser.cmdOptionExists("-i") ? parser.getCmdOption("-i")
+                                                             : DEFAULT_CONF };
+        JSON::Object      obj{ JSON::Object::fromFile(conf) };
+        if (!json_test_struct(obj, { { "analyzer", 'o' } })) {
+            std::cerr << "Wrong format for configuration file '" << conf << "'\n";
+            return EXIT_FAILURE;
+        }
+
+        std::string engineName{ "astar" };
+        if (obj["analyzer"]["engine"] && obj["analyzer"]["engine"].isString())
+            engineName = obj["analyzer"]["engine"].asString();
+        auto engine{ astar::create<AStarCell>(engineName) };
+        if (nullptr == engine || !engine->configure(obj["analyzer"])) {
+            std::cerr << "Cannot create the engine '" << engineName << "'\n";
+            return EXIT_FAILURE;
+        }
+
+        uint x0, y0, x1, y1;
+        const std::string query{ parser.getCmdOption("-q") };
+        if (4 != sscanf(query.c_str(), "%u,%u,%u,%u", &x0, &y0, &x1, &y1) ||
+            nullptr == graph.cell(x0, y0) || nullptr == graph.cell(x1, y1)) {
+            std::cerr << "Wrong search '" << query << "' : x0,y0,x1,y1 inside the map expected\n";
+            return EXIT_FAILURE;
+        }
+
+        auto start{ graph.cell(x0, y0) }, end{ graph.cell(x1, y1) };
+        start->addState(ICell::START_CELL);
+        end->addState(ICell::END_CELL);
+        if (engine->run(&graph, start, end)) {
+            engine->emit(path);
+            std::cout << "Path of " << path.size() << " cells, cost " << end->_G << '\n';
+        } else {
+            std::cout << "No path\n";
+        }
+
+        if (parser.cmdOptionExists("-f")) {
+            const auto reached{ engine->reached() };
+            if (std::empty(reached))
+                std::cerr << "The engine '" << engineName << "' does not report its progress\n";
+            else
+                std::cout << raster.progress(graph, reached, _option(parser, "-f", 1), output)
+                          << " frames written\n";
+        }
+    }
+
+    raster.render(graph);
+    if (!raster.image().write(output)) {
+        std::cerr << "Cannot write '" << output << "'\n";
+        return EXIT_FAILURE;
+    }
+    std::cout << raster.image().width << 'x' << raster.image().height << " image written to "
+              << output << '\n';
+
+    return EXIT_SUCCESS;
+}
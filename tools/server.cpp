@@ -0,0 +1,104 @@
+/**
+ * @file server.cpp
+ * @brief Path queries server entry point
+ * @author lhm
+ */
+
+// Standard headers
+#include <csignal>
+#include <iostream>
+#include <stdlib.h>
+#include <string>
+#include <thread>
+
+// Project headers
+#include <env/mapfile.hpp>
+#include <env/sharedmap.hpp>
+#include <server/server.hpp>
+#include <utils/CmdLineParser.hpp>
+#include <utils/Json.hpp>
+
+// External headers
+#include <JSON.hpp>
+
+static server::Server* _server{ nullptr };
+
+/*****************************************************************************/
+static void
+help(void)
+{
+    std::cout << PROG_NAME << " : Answer path requests on a Unix domain socket\n\n"
+              << "Usage: " << PROG_NAME << " -m map | -S name [-opt val]\n"
+              << "Options: \n\t-h : Display the help\n"
+              << "\n\t-m file : Map to load (Moving AI format)"
+              << "\n\t-S name : Shared memory map to follow (see the grid 'shared-memory' key)"
+              << "\n\t-i file : Configuration file, whose 'analyzer' object sets the engine"
+              << " (default : " << DEFAULT_CONF << ")"
+              << "\n\t-s path : Socket path (default : /tmp/" << PROG_NAME << ".sock)"
+              << "\n\t-t count : Worker threads (default : number of cores)\n\n";
+}
+
+/*****************************************************************************/
+static void
+onSignal(int)
+{
+    if (nullptr != _server)
+        _server->stop();
+}
+
+/*****************************************************************************/
+int
+main(int argc, char* argv[])
+{
+    CmdLineParser parser(argc, argv);
+    if (parser.cmdOptionExists("-h") ||
+        !(parser.cmdOptionExists("-m") || parser.cmdOptionExists("-S"))) {
+        help();
+        return parser.cmdOptionExists("-h") ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    const std::string conf{ parser.cmdOptionExists("-i") ? parser.getCmdOption("-i")
+                                                         : DEFAULT_CONF };
+    const std::string socket{ parser.cmdOptionExists("-s") ? std::string(parser.getCmdOption("-s"))
+                                                           : "/tmp/" PROG_NAME ".sock" };
+    uint threads{ std::max(std::thread::hardware_concurrency(), 1u) };
+    if (parser.cmdOptionExists("-t"))
+        threads = std::stoul(std::string(parser.getCmdOption("-t")));
+
+    JSON::Object obj{ JSON::Object::fromFile(conf) };
+    if (!json_test_struct(obj, { { "analyzer", 'o' } })) {
+        std::cerr << "Wrong format for configuration file '" << conf << "'\n";
+        return EXIT_FAILURE;
+    }
+
+    env::Graph<env::AStarCell> graph;
+    env::SharedMap             shared;
+    const std::string          name{ parser.getCmdOption("-S") };
+    if (parser.cmdOptionExists("-S")) {
+        if (!shared.open(name)) {
+            std::cerr << shared.what() << '\n';
+            return EXIT_FAILURE;
+        }
+        shared.sync(graph);
+    } else if (!env::loadMap(std::string(parser.getCmdOption("-m")), graph)) {
+        std::cerr << "Cannot load map '" << parser.getCmdOption("-m") << "'\n";
+        return EXIT_FAILURE;
+    }
+
+    server::Server server;
+    if (!server.configure(graph, obj["analyzer"], threads) ||
+        (parser.cmdOptionExists("-S") && !server.follow(name)) || !server.listen(socket)) {
+        std::cerr << server.what() << '\n';
+        return EXIT_FAILURE;
+    }
+
+    _server = &server;
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    std::cout << "Serving " << graph.getWidth() << 'x' << graph.getHeight() << " map on " << socket
+              << " with " << threads << " workers\n";
+    server.serve();
+
+    return EXIT_SUCCESS;
+}